@@ -0,0 +1,90 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include "batch_kinematics.h"
+
+// Throughput of forward kinematics over many configurations: one call per
+// configuration vs. the SIMD batch path on 1 thread vs. all cores.
+
+namespace {
+
+template <typename Scalar>
+struct Workload {
+    std::vector<std::vector<Scalar>> joints;
+    std::vector<Scalar> x, y, z;
+    typename Kinematics<6, Scalar>::ConfigurationBlock configurations;
+    typename Kinematics<6, Scalar>::PositionBlock positions;
+    
+    explicit Workload(size_t count) : joints(6, std::vector<Scalar>(count)), x(count), y(count), z(count) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<Scalar> angle(-M_PI, M_PI);
+        for(auto& joint : joints) {
+            for(auto& value : joint) value = angle(rng);
+        }
+        for(int j = 0; j < 6; ++j) configurations.joints[j] = joints[j].data();
+        configurations.count = count;
+        positions = {x.data(), y.data(), z.data()};
+    }
+};
+
+template <typename Function>
+double configurationsPerSecond(size_t count, int repetitions, Function&& function) {
+    auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < repetitions; ++r) function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(count) * repetitions / elapsed.count();
+}
+
+template <typename Scalar>
+void runBenchmark(const char* label, const DHTable<6, Scalar>& dh, size_t count, int repetitions) {
+    Kinematics<6, Scalar> kinematics(dh);
+    Workload<Scalar> workload(count);
+    
+    double per_call = configurationsPerSecond(count, repetitions, [&]() {
+        typename Kinematics<6, Scalar>::JointVector joint_angles;
+        typename Kinematics<6, Scalar>::Vector3 position = Kinematics<6, Scalar>::Vector3::Zero();
+        for(size_t k = 0; k < count; ++k) {
+            for(int j = 0; j < 6; ++j) joint_angles[j] = workload.joints[j][k];
+            kinematics.forwardKinematics(joint_angles, position);
+            workload.x[k] = position[0];
+        }
+    });
+    double batch_single = configurationsPerSecond(count, repetitions, [&]() {
+        parallelForwardKinematics(kinematics, workload.configurations, workload.positions, 1);
+    });
+    double batch_all = configurationsPerSecond(count, repetitions, [&]() {
+        parallelForwardKinematics(kinematics, workload.configurations, workload.positions);
+    });
+    
+    std::cout << std::setw(8) << label
+              << std::setw(16) << per_call / 1e6
+              << std::setw(16) << batch_single / 1e6
+              << std::setw(16) << batch_all / 1e6 << std::endl;
+}
+
+} // namespace
+
+int main() {
+    const size_t count = 1 << 20;
+    const int repetitions = 5;
+    
+    DHTable<6, float> dh_float;
+    for(int j = 0; j < 6; ++j) {
+        dh_float[j] = {static_cast<float>(ETHICON_ARM_DH_PARAMETERS[j].theta_offset),
+                       static_cast<float>(ETHICON_ARM_DH_PARAMETERS[j].alpha),
+                       static_cast<float>(ETHICON_ARM_DH_PARAMETERS[j].a),
+                       static_cast<float>(ETHICON_ARM_DH_PARAMETERS[j].d)};
+    }
+    
+    std::cout << "Batch forward kinematics, " << count << " configurations x " << repetitions
+              << " repetitions, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    std::cout << std::setw(8) << "scalar" << std::setw(16) << "per-call M/s"
+              << std::setw(16) << "batch 1T M/s" << std::setw(16) << "batch all M/s" << std::endl;
+    runBenchmark<double>("double", ETHICON_ARM_DH_PARAMETERS, count, repetitions);
+    runBenchmark<float>("float", dh_float, count, repetitions);
+    
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "async_logger.h"
+#include "command_subscriber.h"
+
+// Command-to-action latency of the CommandSubscriber lanes. Emergency stops
+// are submitted at a fixed interval while the normal lane is kept busy with
+// status checks whose handler takes a configurable time, so any queueing
+// of the e-stop behind them would show in its latency.
+//
+//   bench_command_latency [emergency_stops] [interval_us] [status_work_us] [fifo_priority]
+
+namespace {
+
+void busyWait(std::chrono::microseconds duration) {
+    auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+void report(const char* lane, const LatencySnapshot& latency) {
+    std::cout << "  " << std::left << std::setw(16) << lane << std::right << std::fixed << std::setprecision(1)
+              << " count " << std::setw(7) << latency.count
+              << "  p50 " << std::setw(9) << latency.percentile(0.5) / 1000.0 << " us"
+              << "  p99 " << std::setw(9) << latency.percentile(0.99) / 1000.0 << " us"
+              << "  p99.9 " << std::setw(9) << latency.percentile(0.999) / 1000.0 << " us"
+              << "  max " << std::setw(9) << latency.max_ns / 1000.0 << " us"
+              << "  over 1 ms " << latency.overruns << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int stops = argc > 1 ? std::atoi(argv[1]) : 2000;
+    int interval_us = argc > 2 ? std::atoi(argv[2]) : 1000;
+    int status_work_us = argc > 3 ? std::atoi(argv[3]) : 500;
+    
+    AsyncLoggerOptions log_options;
+    log_options.min_level = LogLevel::Error;
+    AsyncLogger::instance().configure(log_options);
+    
+    CommandSubscriberOptions options;
+    options.emergency_fifo_priority = argc > 4 ? std::atoi(argv[4]) : 0;
+    CommandSubscriber subscriber(options);
+    subscriber.setCommandHandler(CommandType::EmergencyStop, [](const ControlCommand&) {});
+    subscriber.setCommandHandler(CommandType::StatusCheck, [status_work_us](const ControlCommand&) {
+        busyWait(std::chrono::microseconds(status_work_us));
+    });
+    
+    ControlCommand status;
+    status.timestamp = 0;
+    status.command_type = "STATUS_CHECK";
+    status.value = 0.0;
+    ControlCommand stop = status;
+    stop.command_type = "EMERGENCY_STOP";
+    
+    std::cout << stops << " emergency stops every " << interval_us << " us, normal lane busy with "
+              << status_work_us << " us status checks" << std::endl;
+    auto release = std::chrono::steady_clock::now();
+    for (int i = 0; i < stops; ++i) {
+        release += std::chrono::microseconds(interval_us);
+        std::this_thread::sleep_until(release);
+        // Two status checks per stop keep the normal queue from draining
+        subscriber.submitCommand(status);
+        subscriber.submitCommand(status);
+        subscriber.submitCommand(stop);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    
+    report("emergency_stop", subscriber.getEmergencyStopLatency());
+    report("command", subscriber.getCommandLatency());
+    subscriber.shutdown();
+    return 0;
+}
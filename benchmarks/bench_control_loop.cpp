@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "async_logger.h"
+#include "real_time_controller.h"
+
+// Runs the control loop at a fixed rate in the legacy sleep_for mode and in
+// the real-time mode, and reports the measured wakeup jitter and overruns.
+//
+//   bench_control_loop [seconds] [frequency_hz] [--fifo PRIORITY] [--cpu N] [--mlock]
+//                      [--metrics FILE]
+//
+// SCHED_FIFO and mlockall need CAP_SYS_NICE / CAP_IPC_LOCK (or root); the
+// real-time mode still uses absolute deadlines without them.
+
+namespace {
+
+void report(const char* mode, const RealTimeController& controller, double seconds, int frequency) {
+    ControlTimingStats stats = controller.getTimingStats();
+    double expected = seconds * frequency;
+    std::cout << std::left << std::setw(10) << mode << std::right
+              << " cycles " << std::setw(7) << stats.cycles
+              << " (" << std::fixed << std::setprecision(1) << 100.0 * stats.cycles / expected << "% of nominal)"
+              << "  jitter mean " << std::setw(8) << stats.mean_jitter_ns / 1000.0 << " us"
+              << "  max " << std::setw(8) << stats.max_jitter_ns / 1000.0 << " us"
+              << "  overruns " << stats.overruns << "  missed " << stats.missed_periods
+              << "  max cycle " << stats.max_cycle_ns / 1000.0 << " us" << std::endl;
+    
+    for(int phase = 0; phase < static_cast<int>(ControlPhase::Count); ++phase) {
+        LatencySnapshot latency = controller.getPhaseLatency(static_cast<ControlPhase>(phase));
+        std::cout << "    " << std::left << std::setw(14) << controlPhaseName(static_cast<ControlPhase>(phase))
+                  << std::right << std::setprecision(3)
+                  << " p50 " << std::setw(9) << latency.percentile(0.5) / 1000.0 << " us"
+                  << "  p99 " << std::setw(9) << latency.percentile(0.99) / 1000.0 << " us"
+                  << "  p99.9 " << std::setw(9) << latency.percentile(0.999) / 1000.0 << " us"
+                  << "  max " << std::setw(9) << latency.max_ns / 1000.0 << " us" << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double seconds = 5.0;
+    int frequency = 1000;
+    RealTimeOptions options;
+    options.enabled = true;
+    
+    std::string metrics_path;
+    int positional = 0;
+    for(int i = 1; i < argc; ++i) {
+        if(std::strcmp(argv[i], "--fifo") == 0 && i + 1 < argc) {
+            options.fifo_priority = std::atoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "--cpu") == 0 && i + 1 < argc) {
+            options.cpu = std::atoi(argv[++i]);
+        } else if(std::strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            metrics_path = argv[++i];
+        } else if(std::strcmp(argv[i], "--mlock") == 0) {
+            options.lock_memory = true;
+        } else if(positional++ == 0) {
+            seconds = std::atof(argv[i]);
+        } else {
+            frequency = std::atoi(argv[i]);
+        }
+    }
+    
+    // Keep per-cycle log output out of the measurement
+    AsyncLoggerOptions log_options;
+    log_options.min_level = LogLevel::Error;
+    AsyncLogger::instance().configure(log_options);
+    
+    std::cout << "Control loop at " << frequency << " Hz for " << seconds << " s per mode\n";
+    for(bool realtime : {false, true}) {
+        RealTimeController controller;
+        controller.setControlFrequency(frequency);
+        RealTimeOptions mode_options = options;
+        mode_options.enabled = realtime;
+        controller.setRealTimeOptions(mode_options);
+        
+        controller.startControlLoop();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        controller.stopControlLoop();
+        
+        report(realtime ? "realtime" : "legacy", controller, seconds, frequency);
+        if(realtime) {
+            RealTimeStatus status = controller.getRealTimeStatus();
+            std::cout << "           SCHED_FIFO " << (status.fifo_scheduling ? "yes" : "no")
+                      << ", pinned " << (status.cpu_pinned ? "yes" : "no")
+                      << ", mlockall " << (status.memory_locked ? "yes" : "no")
+                      << ", stack prefaulted " << (status.stack_prefaulted ? "yes" : "no") << std::endl;
+            if(!metrics_path.empty() && !controller.exportMetrics(metrics_path)) {
+                std::cerr << "Cannot write metrics to " << metrics_path << std::endl;
+            }
+        }
+    }
+    return 0;
+}
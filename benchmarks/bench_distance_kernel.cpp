@@ -0,0 +1,79 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "collision_detector.h"
+#include "obstacle_cloud.h"
+
+// Brute-force nearest-obstacle distance: the original double AoS loop
+// (norm per obstacle) against the float SoA cloud with each kernel.
+// Reports nanoseconds per query and obstacles scanned per nanosecond.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double nanosecondsSince(Clock::time_point start, int operations) {
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count() / operations;
+}
+
+double aosNormScan(const Eigen::Vector3d& point, const std::vector<Eigen::Vector3d>& obstacles) {
+    double min_distance = std::numeric_limits<double>::max();
+    for (const auto& obstacle : obstacles) min_distance = std::min(min_distance, (point - obstacle).norm());
+    return min_distance;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> coordinate(-150.0, 150.0);
+    
+    std::vector<Eigen::Vector3d> queries(256);
+    for(auto& query : queries) query = Eigen::Vector3d(coordinate(rng), coordinate(rng), coordinate(rng));
+    
+    std::cout << "Active kernel: " << distanceKernelName(ObstacleCloudSoA::activeKernel()) << "\n\n";
+    std::cout << std::setw(8) << "points" << std::setw(14) << "AoS norm ns" << std::setw(14) << "AoS sq ns"
+              << std::setw(12) << "scalar ns" << std::setw(12) << "SSE ns" << std::setw(12) << "AVX2 ns"
+              << std::setw(12) << "pts/ns" << std::endl;
+    
+    CollisionDetector detector;
+    for(size_t count : {64u, 256u, 1024u, 4096u, 16384u}) {
+        std::vector<Eigen::Vector3d> cloud(count);
+        for(auto& point : cloud) point = Eigen::Vector3d(coordinate(rng), coordinate(rng), coordinate(rng));
+        ObstacleCloudSoA soa(cloud);
+        
+        const int repeats = static_cast<int>(std::max<size_t>(1, 1000000 / count));
+        const int operations = repeats * static_cast<int>(queries.size());
+        double sink = 0.0;
+        
+        auto start = Clock::now();
+        for(int r = 0; r < repeats; ++r)
+            for(const auto& query : queries) sink += aosNormScan(query, cloud);
+        double norm_ns = nanosecondsSince(start, operations);
+        
+        start = Clock::now();
+        for(int r = 0; r < repeats; ++r)
+            for(const auto& query : queries) sink += detector.calculateMinimumDistance(query, cloud);
+        double squared_ns = nanosecondsSince(start, operations);
+        
+        double kernel_ns[3];
+        const DistanceKernel kernels[3] = {DistanceKernel::Scalar, DistanceKernel::SSE, DistanceKernel::AVX2};
+        for(int k = 0; k < 3; ++k) {
+            start = Clock::now();
+            for(int r = 0; r < repeats; ++r)
+                for(const auto& query : queries) sink += soa.minSquaredDistance(query, kernels[k]);
+            kernel_ns[k] = nanosecondsSince(start, operations);
+        }
+        double best_ns = std::min(kernel_ns[0], std::min(kernel_ns[1], kernel_ns[2]));
+        
+        std::cout << std::setw(8) << count << std::fixed << std::setprecision(1)
+                  << std::setw(14) << norm_ns << std::setw(14) << squared_ns
+                  << std::setw(12) << kernel_ns[0] << std::setw(12) << kernel_ns[1] << std::setw(12) << kernel_ns[2]
+                  << std::setw(12) << std::setprecision(2) << count / best_ns
+                  << (sink == -1.0 ? "*" : "") << std::endl;
+    }
+    return 0;
+}
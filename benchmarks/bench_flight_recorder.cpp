@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "async_logger.h"
+#include "flight_recorder.h"
+#include "latency_histogram.h"
+
+// Cost of FlightRecorder::append() as seen by the control thread, and the
+// size of the sealed chunks, for a synthetic full-rate stream paced at
+// `rate_hz` (10x the control rate by default, to finish quickly).
+//
+//   bench_flight_recorder [records] [rate_hz] [directory]
+
+namespace {
+
+int64_t nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void fillRecord(RobotStateSnapshot& record, uint64_t cycle) {
+    record.cycle = cycle;
+    record.timestamp_ns = static_cast<uint64_t>(nowNanoseconds());
+    record.joint_count = 6;
+    record.force_count = 3;
+    record.procedure_phase = ProcedurePhase::Dissection;
+    const double t = 0.001 * static_cast<double>(cycle);
+    for (int joint = 0; joint < 6; ++joint) {
+        record.joint_positions[joint] = 0.5 * std::sin(0.2 * t + joint);
+        record.joint_velocities[joint] = 0.1 * std::cos(0.2 * t + joint);
+    }
+    for (int channel = 0; channel < 3; ++channel) record.force_readings[channel] = 3.0 + std::sin(t + channel);
+    record.collision_risk = 0.05;
+    record.procedure_duration = t;
+    record.safety_score = 98.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t records = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 200000;
+    double rate_hz = argc > 2 ? std::atof(argv[2]) : 10000.0;
+    std::string directory = argc > 3 ? argv[3] : "bench_flight_recording";
+    AsyncLoggerOptions log_options;
+    log_options.min_level = LogLevel::Error;
+    AsyncLogger::instance().configure(log_options);
+    
+    std::filesystem::remove_all(directory);
+    FlightRecorderOptions options;
+    options.directory = directory;
+    FlightRecorder recorder(options);
+    if (!recorder.open()) return 1;
+    
+    LatencyHistogram append_latency;
+    RobotStateSnapshot record{};
+    const int64_t period_ns = static_cast<int64_t>(1e9 / rate_hz);
+    int64_t release = nowNanoseconds();
+    for (size_t i = 0; i < records; ++i) {
+        release += period_ns;
+        while (nowNanoseconds() < release) {
+        }
+        fillRecord(record, i + 1);
+        int64_t start = nowNanoseconds();
+        recorder.append(record);
+        append_latency.record(static_cast<uint64_t>(nowNanoseconds() - start));
+    }
+    recorder.close();
+    
+    LatencySnapshot latency = append_latency.snapshot();
+    FlightRecorderStats stats = recorder.getStats();
+    std::cout << records << " records at " << rate_hz << " Hz, " << sizeof(RobotStateSnapshot) << " bytes each" << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "  append   mean " << latency.meanNanoseconds() << " ns, p50 " << latency.percentile(0.5)
+              << " ns, p99 " << latency.percentile(0.99) << " ns, p99.99 " << latency.percentile(0.9999)
+              << " ns, max " << latency.max_ns << " ns" << std::endl;
+    std::cout << "  recorded " << stats.recorded << ", dropped " << stats.dropped
+              << ", chunks sealed " << stats.chunks_sealed << std::endl;
+    if (stats.sealed_bytes) {
+        std::cout << "  sealed   " << stats.raw_bytes_sealed / 1e6 << " MB -> " << stats.sealed_bytes / 1e6 << " MB ("
+                  << static_cast<double>(stats.raw_bytes_sealed) / stats.sealed_bytes << "x)" << std::endl;
+    }
+    std::filesystem::remove_all(directory);
+    return 0;
+}
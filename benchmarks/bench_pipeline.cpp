@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "async_logger.h"
+#include "real_time_controller.h"
+
+// Serial vs. pipelined control cycle with synthetic stage work: each of
+// read, check and command busy-waits for the given time. Reports commands
+// issued per second (throughput), overruns, dropped frames and the
+// sensor-to-command latency.
+//
+//   bench_pipeline [stage_us] [frequency_hz] [seconds]
+//
+// The pipelined mode needs at least three free cores to pay off; on fewer
+// the stage threads time-share and the serial mode wins.
+
+namespace {
+
+void busyWait(std::chrono::microseconds duration) {
+    auto end = std::chrono::steady_clock::now() + duration;
+    while(std::chrono::steady_clock::now() < end) {}
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int stage_us = argc > 1 ? std::atoi(argv[1]) : 60;
+    int frequency = argc > 2 ? std::atoi(argv[2]) : 10000;
+    double seconds = argc > 3 ? std::atof(argv[3]) : 2.0;
+    
+    AsyncLoggerOptions log_options;
+    log_options.min_level = LogLevel::Error;
+    AsyncLogger::instance().configure(log_options);
+    
+    std::cout << "Stage work " << stage_us << " us x 3 at " << frequency << " Hz, "
+              << std::thread::hardware_concurrency() << " cores\n";
+    for(PipelineMode mode : {PipelineMode::Serial, PipelineMode::Pipelined}) {
+        RealTimeController controller;
+        controller.setControlFrequency(frequency);
+        auto work = [stage_us]() { busyWait(std::chrono::microseconds(stage_us)); };
+        controller.setPhaseHandler(ControlPhase::ReadSensors, work);
+        controller.setPhaseHandler(ControlPhase::SafetyChecks, work);
+        controller.setPhaseHandler(ControlPhase::SendCommands, work);
+        
+        PipelineOptions pipeline;
+        pipeline.mode = mode;
+        if(mode == PipelineMode::Pipelined && std::thread::hardware_concurrency() >= 3) {
+            pipeline.safety_check_cpu = 1;
+            pipeline.command_cpu = 2;
+        }
+        controller.setPipelineOptions(pipeline);
+        RealTimeOptions options;
+        options.enabled = true;
+        options.cpu = 0;
+        controller.setRealTimeOptions(options);
+        
+        controller.startControlLoop();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        controller.stopControlLoop();
+        
+        ControlTimingStats stats = controller.getTimingStats();
+        LatencySnapshot latency = controller.getPhaseLatency(ControlPhase::SensorToCommand);
+        std::cout << std::left << std::setw(10) << (mode == PipelineMode::Serial ? "serial" : "pipelined")
+                  << std::right << std::fixed << std::setprecision(0)
+                  << " commands/s " << std::setw(7) << latency.count / seconds
+                  << "  overruns " << std::setw(6) << stats.overruns
+                  << "  missed " << std::setw(6) << stats.missed_periods
+                  << "  drops " << std::setw(6) << stats.pipeline_drops
+                  << std::setprecision(1)
+                  << "  sensor->command p50 " << std::setw(7) << latency.percentile(0.5) / 1000.0 << " us"
+                  << "  p99 " << std::setw(7) << latency.percentile(0.99) / 1000.0 << " us" << std::endl;
+    }
+    return 0;
+}
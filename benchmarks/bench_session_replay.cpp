@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "async_logger.h"
+#include "flight_recorder.h"
+#include "session_replay.h"
+
+// Replay throughput of recorded sessions through the safety stack, on one
+// thread and fanned out over all hardware threads.
+//
+//   bench_session_replay [sessions] [samples_per_session] [directory]
+
+namespace {
+
+void recordSession(const std::string& directory, uint64_t samples, uint64_t seed) {
+    FlightRecorderOptions options;
+    options.directory = directory;
+    options.records_per_chunk = 16384;
+    options.flush_interval = std::chrono::milliseconds(1);
+    FlightRecorder recorder(options);
+    if (!recorder.open()) return;
+    
+    RobotStateSnapshot record{};
+    record.joint_count = 6;
+    record.force_count = 3;
+    record.procedure_phase = ProcedurePhase::Dissection;
+    for (uint64_t i = 0; i < samples; ++i) {
+        const double t = 0.001 * static_cast<double>(i) + static_cast<double>(seed);
+        record.cycle = i + 1;
+        record.timestamp_ns = (i + 1) * 1000000ull;
+        for (int joint = 0; joint < 6; ++joint) {
+            record.joint_positions[joint] = 0.8 * std::sin(0.3 * t + joint);
+            record.joint_velocities[joint] = 0.24 * std::cos(0.3 * t + joint);
+        }
+        for (int channel = 0; channel < 3; ++channel) record.force_readings[channel] = 8.0 + 8.0 * std::sin(t + channel);
+        // The recorder drops rather than waits; give it time to map the next chunk
+        while (!recorder.append(record)) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    recorder.close();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t session_count = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 8;
+    uint64_t samples = argc > 2 ? static_cast<uint64_t>(std::atoll(argv[2])) : 100000;
+    std::string directory = argc > 3 ? argv[3] : "bench_session_replay";
+    AsyncLoggerOptions log_options;
+    log_options.min_level = LogLevel::Error;
+    AsyncLogger::instance().configure(log_options);
+    
+    std::filesystem::remove_all(directory);
+    for (size_t s = 0; s < session_count; ++s) {
+        recordSession(directory, samples, s);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::vector<ReplaySession> sessions = findReplaySessions(directory);
+    std::cout << sessions.size() << " sessions x " << samples << " samples" << std::endl;
+    
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads : {1u, hardware}) {
+        for (bool self_collision : {false, true}) {
+            ReplayOptions options;
+            options.thread_count = threads;
+            options.check_self_collision = self_collision;
+            ReplayReport report = replaySessions(sessions, options);
+            std::cout << "  " << std::setw(2) << report.threads << " threads, self collision "
+                      << (self_collision ? "on " : "off") << std::fixed << std::setprecision(2)
+                      << std::setw(10) << report.samplesPerSecond() / 1e6 << " M samples/s  ("
+                      << report.wall_seconds << " s)" << std::endl;
+            if (threads == hardware && self_collision) std::cout << formatReplayReport(report);
+        }
+        if (hardware == 1) break;
+    }
+    std::filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "async_logger.h"
+#include "data_publisher.h"
+#include "latency_histogram.h"
+
+// Cross-process latency of the shared-memory transport: the parent
+// publishes loaned RoboticsData samples at a fixed rate, each forked reader
+// process blocks in waitForSample() and records publish-to-take latency
+// from the samples' steady_clock stamps.
+//
+//   bench_shm_transport [frequency_hz] [seconds] [readers]
+
+namespace {
+
+constexpr int64_t END_OF_RUN = -1;
+
+int runReader(const std::string& topic, int index) {
+    // Forked child: no logger, plain stdio only
+    ShmReader<RoboticsDataSample> reader;
+    if (!reader.open(topic, 0)) return 2;
+    LatencyHistogram latency;
+    RoboticsDataSample sample;
+    
+    for (;;) {
+        while (!reader.take(sample)) {
+            if (!reader.waitForSample(std::chrono::seconds(5))) return 3;
+        }
+        if (sample.timestamp == END_OF_RUN) break;
+        latency.record(latencyTimestampNs() - sample.source_timestamp_ns);
+    }
+    
+    LatencySnapshot snapshot = latency.snapshot();
+    std::printf("reader %d: samples %llu  lost %llu  latency p50 %.1f us  p99 %.1f us  p99.9 %.1f us  max %.1f us\n",
+                index, static_cast<unsigned long long>(snapshot.count),
+                static_cast<unsigned long long>(reader.getLostCount()),
+                snapshot.percentile(0.5) / 1000.0, snapshot.percentile(0.99) / 1000.0,
+                snapshot.percentile(0.999) / 1000.0, snapshot.max_ns / 1000.0);
+    std::fflush(stdout);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int frequency = argc > 1 ? std::atoi(argv[1]) : 1000;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 2.0;
+    int readers = argc > 3 ? std::atoi(argv[3]) : 2;
+    std::string topic = "/srs_bench_" + std::to_string(getpid());
+    
+    AsyncLoggerOptions log_options;
+    log_options.min_level = LogLevel::Error;
+    AsyncLogger::instance().configure(log_options);
+    
+    RoboticsDataPublisher publisher;
+    if (!publisher.enableSharedMemoryTransport({topic, 1000})) return 1;
+    std::printf("Publishing %d Hz for %.1f s to %d reader processes\n", frequency, seconds, readers);
+    
+    std::vector<pid_t> children;
+    for (int i = 0; i < readers; ++i) {
+        std::fflush(stdout);
+        pid_t child = fork();
+        if (child == 0) _exit(runReader(topic, i));
+        children.push_back(child);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));    // let readers block
+    
+    const int64_t period_ns = 1000000000LL / frequency;
+    const int64_t samples = static_cast<int64_t>(seconds * frequency);
+    timespec release;
+    clock_gettime(CLOCK_MONOTONIC, &release);
+    for (int64_t i = 0; i < samples; ++i) {
+        release.tv_nsec += period_ns;
+        while (release.tv_nsec >= 1000000000L) {
+            release.tv_nsec -= 1000000000L;
+            ++release.tv_sec;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &release, nullptr);
+        
+        RoboticsDataSample& sample = publisher.loanSample();
+        sample.timestamp = i;
+        sample.joint_count = 6;
+        for (int joint = 0; joint < 6; ++joint) sample.joint_positions[joint] = 0.001 * static_cast<double>(i + joint);
+        publisher.publishLoanedSample();
+    }
+    publisher.loanSample().timestamp = END_OF_RUN;
+    publisher.publishLoanedSample();
+    
+    int failures = 0;
+    for (pid_t child : children) {
+        int status = 0;
+        waitpid(child, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "async_logger.h"
+#include "wire_format.h"
+
+// Encode/decode throughput of the fixed-size wire format, next to the
+// conversion between RoboticsData (vectors and strings) and its
+// fixed-layout sample that the wire format replaces on the hot path.
+//
+//   bench_wire_format [messages]
+
+namespace {
+
+template<typename Body>
+void report(const char* name, size_t messages, size_t bytes_per_message, Body body) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t checksum = body();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  " << std::left << std::setw(30) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << messages / seconds / 1e6 << " M msg/s"
+              << std::setw(9) << seconds * 1e9 / messages << " ns/msg";
+    if (bytes_per_message) std::cout << std::setw(9) << messages * bytes_per_message / seconds / 1e9 << " GB/s";
+    std::cout << "   (checksum " << (checksum & 0xffff) << ")" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t messages = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 2000000;
+    AsyncLoggerOptions log_options;
+    log_options.min_level = LogLevel::Error;
+    AsyncLogger::instance().configure(log_options);
+    
+    // A burst of distinct samples, as a recorder would see them
+    constexpr size_t BURST = 1024;
+    std::vector<RoboticsDataSample> samples(BURST);
+    for (size_t i = 0; i < BURST; ++i) {
+        RoboticsDataSample& sample = samples[i];
+        sample = RoboticsDataSample{};
+        sample.timestamp = static_cast<int64_t>(i);
+        sample.joint_count = 6;
+        sample.force_count = 6;
+        sample.procedure_phase = ProcedurePhase::Dissection;
+        for (int joint = 0; joint < 6; ++joint) {
+            sample.joint_positions[joint] = 0.001 * static_cast<double>(i + joint);
+            sample.joint_velocities[joint] = 0.01 * joint;
+            sample.force_readings[joint] = 1.0 + joint;
+        }
+    }
+    
+    const size_t frame_size = encodedSize(WireMessageType::RoboticsData);
+    std::vector<uint8_t> encoded(BURST * frame_size);
+    std::cout << "RoboticsData frame " << frame_size << " bytes, " << messages << " messages" << std::endl;
+    
+    report("encode", messages, frame_size, [&]() {
+        uint64_t total = 0;
+        for (size_t i = 0; i < messages; ++i) {
+            size_t written = 0;
+            encodeRoboticsData(samples[i % BURST], &encoded[(i % BURST) * frame_size], frame_size, written);
+            total += written;
+        }
+        return total;
+    });
+    report("decode", messages, frame_size, [&]() {
+        uint64_t total = 0;
+        RoboticsDataSample sample;
+        for (size_t i = 0; i < messages; ++i) {
+            if (decodeRoboticsData(&encoded[(i % BURST) * frame_size], frame_size, sample) == WireStatus::Ok) {
+                total += static_cast<uint64_t>(sample.timestamp);
+            }
+        }
+        return total;
+    });
+    report("round trip", messages, frame_size, [&]() {
+        uint64_t total = 0;
+        uint8_t buffer[512];
+        RoboticsDataSample sample;
+        for (size_t i = 0; i < messages; ++i) {
+            size_t written = 0;
+            encodeRoboticsData(samples[i % BURST], buffer, sizeof(buffer), written);
+            decodeRoboticsData(buffer, written, sample);
+            total += static_cast<uint64_t>(sample.timestamp);
+        }
+        return total;
+    });
+    report("RoboticsData <-> sample", messages, 0, [&]() {
+        uint64_t total = 0;
+        RoboticsDataSample sample;
+        for (size_t i = 0; i < messages; ++i) {
+            RoboticsData data = fromSample(samples[i % BURST]);
+            toSample(data, sample);
+            total += static_cast<uint64_t>(sample.timestamp) + data.safety_status.size();
+        }
+        return total;
+    });
+    return 0;
+}
@@ -0,0 +1,252 @@
+#include "async_logger.h"
+#include <algorithm>
+#include <ctime>
+#include <utility>
+
+namespace {
+
+std::atomic<uint64_t> next_logger_id{1};
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+} // namespace
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warning: return "WARNING";
+        case LogLevel::Error: return "ERROR";
+        default: return "CRITICAL";
+    }
+}
+
+AsyncLogger::AsyncLogger(const AsyncLoggerOptions& logger_options)
+    : logger_id(next_logger_id.fetch_add(1)),
+      min_level(static_cast<uint8_t>(logger_options.min_level)),
+      dropped(0),
+      written(0),
+      options(logger_options),
+      sink(nullptr),
+      sink_bytes(0),
+      stopping(false) {
+    openSink();
+    worker = std::thread(&AsyncLogger::run, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+
+    std::lock_guard<std::mutex> lock(drain_mutex);
+    drain();
+    closeSink();
+}
+
+AsyncLogger& AsyncLogger::instance() {
+    static AsyncLogger logger;
+    return logger;
+}
+
+uint64_t AsyncLogger::nowNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void AsyncLogger::encode(LogRecord& record, size_t index, const char* text, size_t length) {
+    length = std::min(length, LogRecord::TEXT_CAPACITY - record.text_used);
+    std::memcpy(record.text + record.text_used, text, length);
+    record.types[index] = LogRecord::ArgType::Text;
+    record.values[index].text = {record.text_used, static_cast<uint8_t>(length)};
+    record.text_used = static_cast<uint8_t>(record.text_used + length);
+}
+
+AsyncLogger::ThreadBuffer* AsyncLogger::threadBuffer() {
+    // Buffers outlive their thread until drained; the thread only flags
+    // them on exit and the consumer drops them once empty
+    struct Registrations {
+        std::vector<std::pair<uint64_t, std::shared_ptr<ThreadBuffer>>> entries;
+        ~Registrations() {
+            for (auto& entry : entries) entry.second->retired.store(true, std::memory_order_release);
+        }
+    };
+    thread_local Registrations registrations;
+
+    for (auto& entry : registrations.entries) {
+        if (entry.first == logger_id) return entry.second.get();
+    }
+
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    static std::atomic<uint32_t> next_thread_index{0};
+    size_t capacity = roundUpToPowerOfTwo(std::max<size_t>(options.buffer_records, 2));
+    auto buffer = std::make_shared<ThreadBuffer>(capacity, next_thread_index.fetch_add(1));
+    buffers.push_back(buffer);
+    registrations.entries.emplace_back(logger_id, buffer);
+    return buffer.get();
+}
+
+void AsyncLogger::configure(const AsyncLoggerOptions& new_options) {
+    std::lock_guard<std::mutex> lock(drain_mutex);
+    drain();
+    closeSink();
+    {
+        std::lock_guard<std::mutex> buffers_lock(buffers_mutex);
+        options = new_options;
+    }
+    min_level.store(static_cast<uint8_t>(new_options.min_level), std::memory_order_relaxed);
+    openSink();
+}
+
+void AsyncLogger::flush() {
+    std::lock_guard<std::mutex> lock(drain_mutex);
+    drain();
+}
+
+void AsyncLogger::run() {
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    while (!stopping) {
+        std::chrono::milliseconds interval;
+        {
+            std::lock_guard<std::mutex> drain_lock(drain_mutex);
+            interval = options.flush_interval;
+        }
+        if (wake.wait_for(lock, interval, [this]() { return stopping; })) break;
+        
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> drain_lock(drain_mutex);
+            drain();
+        }
+        lock.lock();
+    }
+}
+
+void AsyncLogger::drain() {
+    std::vector<std::shared_ptr<ThreadBuffer>> active;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        active = buffers;
+    }
+
+    for (const auto& buffer : active) {
+        uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        for (; tail < head; ++tail) pending.push_back(buffer->records[tail & buffer->mask]);
+        buffer->tail.store(tail, std::memory_order_release);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const std::shared_ptr<ThreadBuffer>& buffer) {
+            return buffer->retired.load(std::memory_order_acquire) &&
+                   buffer->head.load(std::memory_order_acquire) == buffer->tail.load(std::memory_order_relaxed);
+        }), buffers.end());
+    }
+
+    if (pending.empty()) return;
+
+    // Rings are drained one after another; restore a single timeline
+    std::stable_sort(pending.begin(), pending.end(), [](const LogRecord& a, const LogRecord& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+    for (const auto& record : pending) writeLine(formatRecord(record));
+    written.fetch_add(pending.size(), std::memory_order_relaxed);
+    pending.clear();
+    if (sink) std::fflush(sink);
+}
+
+std::string AsyncLogger::formatRecord(const LogRecord& record) {
+    std::time_t seconds = static_cast<std::time_t>(record.timestamp_ns / 1000000000ULL);
+    std::tm utc;
+    gmtime_r(&seconds, &utc);
+    char prefix[64];
+    size_t length = std::strftime(prefix, sizeof(prefix), "%Y-%m-%dT%H:%M:%S", &utc);
+    std::snprintf(prefix + length, sizeof(prefix) - length, ".%06uZ",
+                  static_cast<unsigned>(record.timestamp_ns / 1000 % 1000000));
+
+    std::string line = prefix;
+    line += ' ';
+    line += logLevelName(record.site->level);
+    line += ' ';
+    line += record.site->component;
+    line += ": ";
+
+    size_t next_arg = 0;
+    for (const char* cursor = record.site->format; *cursor; ++cursor) {
+        if (cursor[0] != '{' || cursor[1] != '}' || next_arg >= record.arg_count) {
+            line += *cursor;
+            continue;
+        }
+        ++cursor;
+
+        char number[32];
+        const LogRecord::ArgValue& value = record.values[next_arg];
+        switch (record.types[next_arg++]) {
+            case LogRecord::ArgType::Int:
+                std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(value.i));
+                line += number;
+                break;
+            case LogRecord::ArgType::Unsigned:
+                std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(value.u));
+                line += number;
+                break;
+            case LogRecord::ArgType::Double:
+                std::snprintf(number, sizeof(number), "%g", value.d);
+                line += number;
+                break;
+            case LogRecord::ArgType::Bool:
+                line += value.b ? "true" : "false";
+                break;
+            case LogRecord::ArgType::Text:
+                line.append(record.text + value.text.offset, value.text.length);
+                break;
+        }
+    }
+    return line;
+}
+
+void AsyncLogger::writeLine(const std::string& line) {
+    if (!sink) return;
+    std::fwrite(line.data(), 1, line.size(), sink);
+    std::fputc('\n', sink);
+    sink_bytes += line.size() + 1;
+    if (!options.path.empty() && sink_bytes >= options.max_file_bytes) rotate();
+}
+
+void AsyncLogger::openSink() {
+    sink_bytes = 0;
+    if (options.path.empty()) {
+        sink = stdout;
+        return;
+    }
+    sink = std::fopen(options.path.c_str(), "a");
+    if (sink && std::fseek(sink, 0, SEEK_END) == 0) {
+        long size = std::ftell(sink);
+        sink_bytes = size > 0 ? static_cast<size_t>(size) : 0;
+    }
+}
+
+void AsyncLogger::closeSink() {
+    if (sink && sink != stdout) std::fclose(sink);
+    if (sink == stdout) std::fflush(stdout);
+    sink = nullptr;
+}
+
+void AsyncLogger::rotate() {
+    closeSink();
+    // path.(n-2) -> path.(n-1), ..., path -> path.1; the oldest is overwritten
+    for (size_t i = options.max_files > 1 ? options.max_files - 1 : 0; i > 0; --i) {
+        std::string from = i == 1 ? options.path : options.path + "." + std::to_string(i - 1);
+        std::rename(from.c_str(), (options.path + "." + std::to_string(i)).c_str());
+    }
+    if (options.max_files <= 1) std::remove(options.path.c_str());
+    openSink();
+}
@@ -0,0 +1,213 @@
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum class LogLevel : uint8_t {
+    Debug = 0,
+    Info,
+    Warning,
+    Error,
+    Critical
+};
+
+const char* logLevelName(LogLevel level);
+
+// A log statement's static part. Call sites define one per message, at
+// namespace scope, and its address serves as the format id; "{}" in the
+// format is replaced by the next argument when the record is formatted.
+struct LogSite {
+    LogLevel level;
+    const char* component;
+    const char* format;
+};
+
+struct AsyncLoggerOptions {
+    std::string path;                       // empty: standard output, never rotated
+    size_t max_file_bytes = 16 * 1024 * 1024;
+    size_t max_files = 5;                   // path, path.1 ... path.(max_files - 1)
+    size_t buffer_records = 4096;           // per producer thread, rounded up to a power of two
+    LogLevel min_level = LogLevel::Info;
+    std::chrono::milliseconds flush_interval{5};
+};
+
+// Fixed-size binary log record: format id, timestamp and up to MAX_ARGS
+// arguments. String arguments are copied into the inline text area and
+// truncated to fit.
+struct LogRecord {
+    static constexpr size_t MAX_ARGS = 6;
+    static constexpr size_t TEXT_CAPACITY = 112;
+
+    enum class ArgType : uint8_t { Int, Unsigned, Double, Bool, Text };
+
+    struct TextSpan {
+        uint8_t offset;
+        uint8_t length;
+    };
+
+    union ArgValue {
+        int64_t i;
+        uint64_t u;
+        double d;
+        bool b;
+        TextSpan text;
+    };
+
+    uint64_t timestamp_ns;                  // system_clock
+    const LogSite* site;
+    uint32_t thread_index;
+    uint8_t arg_count;
+    uint8_t text_used;
+    ArgType types[MAX_ARGS];
+    ArgValue values[MAX_ARGS];
+    char text[TEXT_CAPACITY];
+};
+
+// Asynchronous logger for the real-time paths. A call site copies its
+// arguments into a binary record in the calling thread's own single-producer
+// ring: no lock, no allocation, no formatting and no I/O. A background
+// thread drains all rings, orders records by timestamp, formats and writes
+// them, and rotates the output file by size.
+//
+// When a thread's ring is full the record is dropped and counted instead of
+// blocking the producer (getDroppedCount()).
+class AsyncLogger {
+public:
+    explicit AsyncLogger(const AsyncLoggerOptions& options = AsyncLoggerOptions());
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    // Process-wide logger used by the core engine and DDS classes
+    static AsyncLogger& instance();
+
+    template<typename... Args>
+    void log(const LogSite& site, const Args&... args);
+
+    // Applies new sink/level settings; buffer_records only affects threads
+    // that log for the first time afterwards
+    void configure(const AsyncLoggerOptions& options);
+    // Writes out everything enqueued before the call
+    void flush();
+
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+    uint64_t getWrittenCount() const { return written.load(std::memory_order_relaxed); }
+
+    // Formats one record the way the background thread does (without the
+    // trailing newline). Exposed for tests and offline decoding.
+    static std::string formatRecord(const LogRecord& record);
+
+private:
+    struct ThreadBuffer;
+
+    ThreadBuffer* threadBuffer();
+    void run();
+    void drain();
+    void writeLine(const std::string& line);
+    void openSink();
+    void closeSink();
+    void rotate();
+
+    static uint64_t nowNanoseconds();
+    static void encode(LogRecord& record, size_t index, const char* text, size_t length);
+    template<typename T>
+    static void encode(LogRecord& record, size_t index, const T& value);
+
+    const uint64_t logger_id;
+    std::atomic<uint8_t> min_level;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> written;
+
+    std::mutex buffers_mutex;               // taken once per thread, on registration
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+    std::mutex drain_mutex;                 // single consumer: background thread or flush()
+    AsyncLoggerOptions options;
+    std::FILE* sink;
+    size_t sink_bytes;
+    std::vector<LogRecord> pending;
+
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    bool stopping;
+    std::thread worker;
+};
+
+struct AsyncLogger::ThreadBuffer {
+    explicit ThreadBuffer(size_t capacity, uint32_t index)
+        : records(capacity), mask(capacity - 1), thread_index(index) {}
+
+    std::vector<LogRecord> records;
+    const size_t mask;
+    const uint32_t thread_index;
+    std::atomic<bool> retired{false};       // owning thread has exited
+    alignas(64) std::atomic<uint64_t> head{0};  // written by the producer
+    alignas(64) std::atomic<uint64_t> tail{0};  // written by the consumer
+};
+
+template<typename T>
+void AsyncLogger::encode(LogRecord& record, size_t index, const T& value) {
+    if constexpr (std::is_same<T, bool>::value) {
+        record.types[index] = LogRecord::ArgType::Bool;
+        record.values[index].b = value;
+    } else if constexpr (std::is_floating_point<T>::value) {
+        record.types[index] = LogRecord::ArgType::Double;
+        record.values[index].d = static_cast<double>(value);
+    } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        record.types[index] = LogRecord::ArgType::Int;
+        record.values[index].i = static_cast<int64_t>(value);
+    } else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+        record.types[index] = LogRecord::ArgType::Unsigned;
+        record.values[index].u = static_cast<uint64_t>(value);
+    } else if constexpr (std::is_same<T, std::string>::value) {
+        encode(record, index, value.data(), value.size());
+    } else {
+        static_assert(std::is_convertible<T, const char*>::value, "Unsupported log argument type");
+        const char* text = value;
+        encode(record, index, text, text ? std::strlen(text) : 0);
+    }
+}
+
+template<typename... Args>
+void AsyncLogger::log(const LogSite& site, const Args&... args) {
+    static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "Too many log arguments");
+    if (static_cast<uint8_t>(site.level) < min_level.load(std::memory_order_relaxed)) return;
+
+    ThreadBuffer* buffer = threadBuffer();
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    if (head - buffer->tail.load(std::memory_order_acquire) > buffer->mask) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    LogRecord& record = buffer->records[head & buffer->mask];
+    record.timestamp_ns = nowNanoseconds();
+    record.site = &site;
+    record.thread_index = buffer->thread_index;
+    record.arg_count = static_cast<uint8_t>(sizeof...(Args));
+    record.text_used = 0;
+    size_t index = 0;
+    (void)index;
+    (encode(record, index++, args), ...);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+// Shorthand for the process-wide logger
+template<typename... Args>
+void logMessage(const LogSite& site, const Args&... args) {
+    AsyncLogger::instance().log(site, args...);
+}
+
+#endif // ASYNC_LOGGER_H
@@ -0,0 +1,53 @@
+#ifndef BATCH_KINEMATICS_H
+#define BATCH_KINEMATICS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "kinematics.h"
+
+// Splits a batch forward kinematics job across worker threads. Each worker
+// gets a contiguous, tile-aligned range so threads never share a cache line
+// of output. Small batches run on the calling thread.
+template <int DOF, typename Scalar>
+void parallelForwardKinematics(const Kinematics<DOF, Scalar>& kinematics,
+                               const typename Kinematics<DOF, Scalar>::ConfigurationBlock& configurations,
+                               const typename Kinematics<DOF, Scalar>::PositionBlock& positions,
+                               unsigned thread_count = 0) {
+    constexpr std::size_t MIN_CONFIGURATIONS_PER_THREAD = 4096;
+    constexpr std::size_t TILE = Kinematics<DOF, Scalar>::BATCH_TILE;
+
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::size_t useful_threads = std::max<std::size_t>(1, configurations.count / MIN_CONFIGURATIONS_PER_THREAD);
+    thread_count = static_cast<unsigned>(std::min<std::size_t>(thread_count, useful_threads));
+
+    if (thread_count == 1) {
+        kinematics.forwardKinematicsBatch(configurations, positions, 0, configurations.count);
+        return;
+    }
+
+    std::size_t tiles = (configurations.count + TILE - 1) / TILE;
+    std::size_t tiles_per_thread = (tiles + thread_count - 1) / thread_count;
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count - 1);
+    for (unsigned t = 1; t < thread_count; ++t) {
+        std::size_t begin = std::min(configurations.count, t * tiles_per_thread * TILE);
+        std::size_t end = std::min(configurations.count, (t + 1) * tiles_per_thread * TILE);
+        if (begin >= end) break;
+        workers.emplace_back([&kinematics, &configurations, &positions, begin, end]() {
+            kinematics.forwardKinematicsBatch(configurations, positions, begin, end);
+        });
+    }
+
+    kinematics.forwardKinematicsBatch(configurations, positions, 0,
+                                      std::min(configurations.count, tiles_per_thread * TILE));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+#endif // BATCH_KINEMATICS_H
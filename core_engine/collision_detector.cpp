@@ -1,12 +1,23 @@
 #include "collision_detector.h"
-#include <iostream>
+#include "async_logger.h"
 #include <cmath>
 #include <algorithm>
+#include <limits>
+
+namespace {
+
+const LogSite COLLISION_DETECTED{LogLevel::Critical, "CollisionDetector", "🚨 COLLISION DETECTED! Distance: {}mm"};
+const LogSite COLLISION_WARNING{LogLevel::Warning, "CollisionDetector", "⚠️  Collision warning! Distance: {}mm"};
+const LogSite SAFETY_MARGINS_UPDATED{LogLevel::Info, "CollisionDetector", "Safety margins updated - Min: {}mm, Warning: {}mm"};
+
+} // namespace
 
 CollisionDetector::CollisionDetector() {
     // Initialize with default safety margins
     min_safe_distance = 2.0;  // 2mm minimum safe distance
     warning_distance = 5.0;   // 5mm warning distance
+    link_radius = 1.0;        // link axes closer than 4mm count as self-collision
+    last_self_collision = {false, -1, -1, std::numeric_limits<double>::infinity()};
 }
 
 bool CollisionDetector::checkInstrumentCollision(const Eigen::Vector3d& instrument_tip,
@@ -15,51 +26,137 @@ bool CollisionDetector::checkInstrumentCollision(const Eigen::Vector3d& instrume
         double distance = (instrument_tip - obstacle).norm();
         
         if (distance < min_safe_distance) {
-            std::cout << "🚨 COLLISION DETECTED! Distance: " << distance << "mm" << std::endl;
+            logMessage(COLLISION_DETECTED, distance);
             return true;
         } else if (distance < warning_distance) {
-            std::cout << "⚠️  Collision warning! Distance: " << distance << "mm" << std::endl;
+            logMessage(COLLISION_WARNING, distance);
         }
     }
     return false;
 }
 
 bool CollisionDetector::checkSelfCollision(const std::vector<Eigen::Vector3d>& joint_positions) {
-    // Simplified self-collision detection between robot links
-    // In a real system, this would use detailed robot geometry
+    size_t link_count = joint_positions.size() < 2 ? 0 : joint_positions.size() - 1;
     
-    if (joint_positions.size() < 2) return false;
+    // Zero-length links come from the arm's geometry, not its pose, so the
+    // allowed pairs are only rebuilt when the set of them changes
+    bool layout_changed = link_count != link_collision_checker.size();
+    degenerate_links.resize(link_count);
+    for (size_t i = 0; i < link_count; ++i) {
+        uint8_t degenerate = (joint_positions[i + 1] - joint_positions[i]).squaredNorm() <=
+                             COINCIDENT_JOINT_MM * COINCIDENT_JOINT_MM;
+        layout_changed |= degenerate != degenerate_links[i];
+        degenerate_links[i] = degenerate;
+    }
     
-    for (size_t i = 0; i < joint_positions.size() - 1; ++i) {
-        for (size_t j = i + 2; j < joint_positions.size(); ++j) {
-            double distance = (joint_positions[i] - joint_positions[j]).norm();
-            
-            if (distance < min_safe_distance * 2) {  // Larger margin for self-collision
-                std::cout << "🤖 Self-collision risk between joints " << i << " and " << j 
-                          << ", distance: " << distance << "mm" << std::endl;
-                return true;
+    if (layout_changed) {
+        link_collision_checker.resize(link_count);
+        for (size_t a = 0; a < link_count; ++a) {
+            for (size_t b = a + 1; b < link_count; ++b) {
+                // Touching is allowed for a degenerate link and for links
+                // joined only through degenerate ones (or directly)
+                bool allowed = degenerate_links[a] || degenerate_links[b];
+                bool joined = true;
+                for (size_t between = a + 1; between < b; ++between) joined = joined && degenerate_links[between];
+                link_collision_checker.setCollisionAllowed(a, b, allowed || joined);
             }
         }
     }
-    return false;
+    
+    updateLinkCapsules(link_collision_checker, joint_positions, link_radius);
+    last_self_collision = link_collision_checker.check(min_safe_distance);
+    return last_self_collision.collision;
 }
 
 double CollisionDetector::calculateMinimumDistance(const Eigen::Vector3d& point,
-                                                  const std::vector<Eigen::Vector3d>& obstacles) {
+                                                  const std::vector<Eigen::Vector3d>& obstacles) const {
     if (obstacles.empty()) return std::numeric_limits<double>::max();
     
-    double min_distance = std::numeric_limits<double>::max();
+    double min_distance_sq = std::numeric_limits<double>::max();
     for (const auto& obstacle : obstacles) {
-        double distance = (point - obstacle).norm();
-        min_distance = std::min(min_distance, distance);
+        min_distance_sq = std::min(min_distance_sq, (point - obstacle).squaredNorm());
     }
     
-    return min_distance;
+    return std::sqrt(min_distance_sq);
+}
+
+double CollisionDetector::calculateMinimumDistance(const Eigen::Vector3d& point,
+                                                  const ObstacleCloudSoA& obstacles) const {
+    return obstacles.minDistance(point);
+}
+
+void CollisionDetector::setObstacles(const std::vector<Eigen::Vector3d>& obstacles) {
+    obstacle_index.build(obstacles);
+    if (obstacles.size() <= SOA_SCAN_MAX_OBSTACLES) {
+        obstacle_cloud.assign(obstacles);
+    } else {
+        obstacle_cloud.clear();
+    }
+}
+
+bool CollisionDetector::checkInstrumentCollision(const Eigen::Vector3d& instrument_tip) {
+    double distance = calculateMinimumDistance(instrument_tip);
+    
+    if (distance < min_safe_distance) {
+        logMessage(COLLISION_DETECTED, distance);
+        return true;
+    } else if (distance < warning_distance) {
+        logMessage(COLLISION_WARNING, distance);
+    }
+    return false;
+}
+
+double CollisionDetector::calculateMinimumDistance(const Eigen::Vector3d& point) {
+    if (!obstacle_cloud.empty()) return obstacle_cloud.minDistance(point);
+    return obstacle_index.nearestDistance(point);
+}
+
+size_t CollisionDetector::findObstaclesWithinWarningDistance(const Eigen::Vector3d& point,
+                                                             std::vector<size_t>& obstacle_ids) const {
+    return obstacle_index.radiusSearch(point, warning_distance, obstacle_ids);
+}
+
+size_t CollisionDetector::findObstaclesWithinSafeDistance(const Eigen::Vector3d& point,
+                                                          std::vector<size_t>& obstacle_ids) const {
+    return obstacle_index.radiusSearch(point, min_safe_distance, obstacle_ids);
+}
+
+bool CollisionDetector::violatesMinSafeDistance(const Eigen::Vector3d& point) const {
+    return obstacle_index.anyWithin(point, min_safe_distance);
+}
+
+void CollisionDetector::setStaticAnatomy(const std::vector<Eigen::Vector3d>& anatomy,
+                                         const DistanceFieldOptions& options) {
+    waitForStaticAnatomy();
+    auto field = std::make_shared<DistanceField>();
+    field->build(anatomy, options);
+    std::atomic_store(&anatomy_field, std::shared_ptr<const DistanceField>(std::move(field)));
+}
+
+void CollisionDetector::setStaticAnatomyAsync(std::vector<Eigen::Vector3d> anatomy,
+                                              const DistanceFieldOptions& options) {
+    // One build at a time; a newer phase waits for the previous build to land
+    waitForStaticAnatomy();
+    anatomy_field_build = std::async(std::launch::async, [this, anatomy = std::move(anatomy), options]() {
+        auto field = std::make_shared<DistanceField>();
+        field->build(anatomy, options);
+        std::atomic_store(&anatomy_field, std::shared_ptr<const DistanceField>(std::move(field)));
+    });
+}
+
+bool CollisionDetector::waitForStaticAnatomy() {
+    if (anatomy_field_build.valid()) anatomy_field_build.get();
+    return hasStaticAnatomy();
+}
+
+FieldDistance CollisionDetector::queryStaticAnatomy(const Eigen::Vector3d& point) const {
+    std::shared_ptr<const DistanceField> field = std::atomic_load(&anatomy_field);
+    if (!field) return {std::numeric_limits<double>::max(), Eigen::Vector3d::Zero(), false, true};
+    return field->query(point, min_safe_distance);
 }
 
 void CollisionDetector::setSafetyMargins(double min_safe, double warning) {
     min_safe_distance = min_safe;
     warning_distance = warning;
-    std::cout << "Safety margins updated - Min: " << min_safe_distance 
-              << "mm, Warning: " << warning_distance << "mm" << std::endl;
+    logMessage(SAFETY_MARGINS_UPDATED, min_safe_distance, warning_distance);
 }
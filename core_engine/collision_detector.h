@@ -2,33 +2,93 @@
 #define COLLISION_DETECTOR_H
 
 #include <eigen3/Eigen/Dense>
+#include <future>
+#include <memory>
 #include <vector>
+#include "distance_field.h"
+#include "obstacle_index.h"
+#include "obstacle_cloud.h"
+#include "distance_tracker.h"
+#include "self_collision.h"
 
 class CollisionDetector {
 private:
     double min_safe_distance;
     double warning_distance;
+    ObstacleIndex obstacle_index;
+    ObstacleCloudSoA obstacle_cloud;    // filled only for small sets, see SOA_SCAN_MAX_OBSTACLES
+    SelfCollisionChecker link_collision_checker;
+    std::vector<uint8_t> degenerate_links;  // zero-length links the allowed pairs were set up for
+    SelfCollisionResult last_self_collision;
+    double link_radius;
+    std::shared_ptr<const DistanceField> anatomy_field;    // swapped with std::atomic_load/store
+    std::future<void> anatomy_field_build;                 // declared last: joined before the rest is destroyed
     
 public:
+    // Up to this many stored obstacles a vectorised linear scan beats the
+    // k-d tree descent for nearest-distance queries
+    static constexpr size_t SOA_SCAN_MAX_OBSTACLES = 4096;
+    // Joint positions closer than this are one point
+    static constexpr double COINCIDENT_JOINT_MM = 1e-6;
+    
     CollisionDetector();
     
     // Check for collisions between instrument and obstacles
     bool checkInstrumentCollision(const Eigen::Vector3d& instrument_tip,
                                  const std::vector<Eigen::Vector3d>& obstacles);
     
-    // Check for self-collision between robot components
+    // Check for self-collision between robot components. Links between
+    // consecutive joint positions are modelled as capsules of link_radius;
+    // adjacent links are allowed to touch. A link whose end points coincide
+    // (a joint with a = d = 0) is left out, and the links on either side of
+    // it count as adjacent, so body indices stay link indices. Details of
+    // the closest pair are available from getLastSelfCollision().
     bool checkSelfCollision(const std::vector<Eigen::Vector3d>& joint_positions);
+    const SelfCollisionResult& getLastSelfCollision() const { return last_self_collision; }
     
-    // Calculate minimum distance to any obstacle
+    // Calculate minimum distance to any obstacle. Scans the set as given;
+    // callers that query the same obstacles repeatedly should store them
+    // with setObstacles() or pass a prebuilt ObstacleCloudSoA instead.
     double calculateMinimumDistance(const Eigen::Vector3d& point,
-                                   const std::vector<Eigen::Vector3d>& obstacles);
+                                   const std::vector<Eigen::Vector3d>& obstacles) const;
+    double calculateMinimumDistance(const Eigen::Vector3d& point, const ObstacleCloudSoA& obstacles) const;
+    
+    // Indexed obstacle set: build once per obstacle update, then query the
+    // stored cloud without passing it on every call
+    void setObstacles(const std::vector<Eigen::Vector3d>& obstacles);
+    bool checkInstrumentCollision(const Eigen::Vector3d& instrument_tip);
+    double calculateMinimumDistance(const Eigen::Vector3d& point);
+    size_t findObstaclesWithinWarningDistance(const Eigen::Vector3d& point, std::vector<size_t>& obstacle_ids) const;
+    size_t findObstaclesWithinSafeDistance(const Eigen::Vector3d& point, std::vector<size_t>& obstacle_ids) const;
+    bool violatesMinSafeDistance(const Eigen::Vector3d& point) const;
+    
+    // Per-instrument tracker over the indexed obstacles; reuses the last
+    // cycle's result while the tip provably stays beyond warning_distance.
+    // Trackers follow later setSafetyMargins() calls and must not outlive
+    // the detector.
+    DistanceTracker createDistanceTracker() const { return DistanceTracker(obstacle_index, &warning_distance); }
+    
+    // Static anatomy as a precomputed distance field. The synchronous form
+    // replaces the field before returning; the async form builds in the
+    // background and swaps the new field in when done, while queries keep
+    // using the previous one. Queries re-measure exactly within the field's
+    // error bound of min_safe_distance.
+    void setStaticAnatomy(const std::vector<Eigen::Vector3d>& anatomy,
+                          const DistanceFieldOptions& options = DistanceFieldOptions());
+    void setStaticAnatomyAsync(std::vector<Eigen::Vector3d> anatomy,
+                               const DistanceFieldOptions& options = DistanceFieldOptions());
+    bool waitForStaticAnatomy();
+    bool hasStaticAnatomy() const { return std::atomic_load(&anatomy_field) != nullptr; }
+    FieldDistance queryStaticAnatomy(const Eigen::Vector3d& point) const;
     
     // Configuration methods
     void setSafetyMargins(double min_safe, double warning);
+    void setLinkRadius(double radius) { link_radius = radius; }
     
     // Getters
     double getMinSafeDistance() const { return min_safe_distance; }
     double getWarningDistance() const { return warning_distance; }
+    const ObstacleIndex& getObstacleIndex() const { return obstacle_index; }
 };
 
 #endif // COLLISION_DETECTOR_H
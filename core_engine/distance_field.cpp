@@ -0,0 +1,141 @@
+#include "distance_field.h"
+#include "obstacle_cloud.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void DistanceField::build(const std::vector<Eigen::Vector3d>& obstacles, const DistanceFieldOptions& options) {
+    index.build(obstacles);
+    brick_table.clear();
+    samples.clear();
+    voxel_size = options.voxel_size;
+    inverse_voxel_size = 1.0 / voxel_size;
+    band = options.band;
+    if (obstacles.empty()) return;
+
+    Eigen::Vector3d lower = obstacles.front();
+    Eigen::Vector3d upper = obstacles.front();
+    for (const auto& obstacle : obstacles) {
+        lower = lower.cwiseMin(obstacle);
+        upper = upper.cwiseMax(obstacle);
+    }
+    origin = lower - Eigen::Vector3d::Constant(band);
+
+    const double brick_size = BRICK_CELLS * voxel_size;
+    for (int axis = 0; axis < 3; ++axis) {
+        brick_dims[axis] = std::max(1, static_cast<int>(std::ceil((upper[axis] - lower[axis] + 2.0 * band) / brick_size)));
+    }
+    brick_table.assign(static_cast<size_t>(brick_dims[0]) * brick_dims[1] * brick_dims[2], EMPTY_BRICK);
+
+    // A brick is needed when any obstacle lies within band of any point in
+    // it; those obstacles are also the only candidates for its samples, so
+    // the samples are measured by a vectorised scan over just that subset.
+    const double half_diagonal = 0.5 * brick_size * std::sqrt(3.0);
+    std::vector<size_t> candidate_ids;
+    std::vector<Eigen::Vector3d> candidates;
+    ObstacleCloudSoA candidate_cloud;
+    const float band_sq = static_cast<float>(band * band);
+    int32_t allocated = 0;
+    for (int bz = 0; bz < brick_dims[2]; ++bz) {
+        for (int by = 0; by < brick_dims[1]; ++by) {
+            for (int bx = 0; bx < brick_dims[0]; ++bx) {
+                Eigen::Vector3d brick_origin = origin + brick_size * Eigen::Vector3d(bx, by, bz);
+                Eigen::Vector3d center = brick_origin + Eigen::Vector3d::Constant(0.5 * brick_size);
+                if (index.radiusSearch(center, band + half_diagonal, candidate_ids) == 0) continue;
+
+                candidates.clear();
+                for (size_t id : candidate_ids) candidates.push_back(obstacles[id]);
+                candidate_cloud.assign(candidates);
+
+                brick_table[(static_cast<size_t>(bz) * brick_dims[1] + by) * brick_dims[0] + bx] = allocated++;
+                size_t offset = samples.size();
+                samples.resize(offset + SAMPLES_PER_BRICK);
+                for (int z = 0; z < BRICK_SAMPLES; ++z) {
+                    for (int y = 0; y < BRICK_SAMPLES; ++y) {
+                        for (int x = 0; x < BRICK_SAMPLES; ++x) {
+                            Eigen::Vector3d sample_point = brick_origin + voxel_size * Eigen::Vector3d(x, y, z);
+                            float distance_sq = std::min(candidate_cloud.minSquaredDistance(sample_point), band_sq);
+                            samples[offset + (z * BRICK_SAMPLES + y) * BRICK_SAMPLES + x] = std::sqrt(distance_sq);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+FieldDistance DistanceField::beyondBand() const {
+    return {band, Eigen::Vector3d::Zero(), false, true};
+}
+
+FieldDistance DistanceField::lookup(const Eigen::Vector3d& point) const {
+    if (brick_table.empty()) return {std::numeric_limits<double>::max(), Eigen::Vector3d::Zero(), false, true};
+
+    Eigen::Vector3d grid = (point - origin) * inverse_voxel_size;
+    int cell[3];
+    double fraction[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        double limit = static_cast<double>(brick_dims[axis]) * BRICK_CELLS;
+        // The grid spans the obstacle bounds plus band, so outside it is beyond the band
+        if (!(grid[axis] >= 0.0 && grid[axis] < limit)) return beyondBand();
+        cell[axis] = static_cast<int>(grid[axis]);
+        fraction[axis] = grid[axis] - cell[axis];
+    }
+
+    size_t brick = (static_cast<size_t>(cell[2] / BRICK_CELLS) * brick_dims[1] + cell[1] / BRICK_CELLS) *
+                   brick_dims[0] + cell[0] / BRICK_CELLS;
+    int32_t slot = brick_table[brick];
+    if (slot == EMPTY_BRICK) return beyondBand();
+
+    const float* base = samples.data() + static_cast<size_t>(slot) * SAMPLES_PER_BRICK +
+                        ((cell[2] % BRICK_CELLS) * BRICK_SAMPLES + cell[1] % BRICK_CELLS) * BRICK_SAMPLES +
+                        cell[0] % BRICK_CELLS;
+    const size_t dy = BRICK_SAMPLES;
+    const size_t dz = BRICK_SAMPLES * BRICK_SAMPLES;
+    double c000 = base[0],       c100 = base[1];
+    double c010 = base[dy],      c110 = base[dy + 1];
+    double c001 = base[dz],      c101 = base[dz + 1];
+    double c011 = base[dz + dy], c111 = base[dz + dy + 1];
+
+    const double fx = fraction[0], fy = fraction[1], fz = fraction[2];
+    double c00 = c000 + fx * (c100 - c000);
+    double c10 = c010 + fx * (c110 - c010);
+    double c01 = c001 + fx * (c101 - c001);
+    double c11 = c011 + fx * (c111 - c011);
+    double c0 = c00 + fy * (c10 - c00);
+    double c1 = c01 + fy * (c11 - c01);
+    double distance = c0 + fz * (c1 - c0);
+
+    // Analytic partial derivatives of the trilinear interpolant
+    Eigen::Vector3d gradient;
+    gradient[0] = (1.0 - fz) * ((1.0 - fy) * (c100 - c000) + fy * (c110 - c010)) +
+                  fz * ((1.0 - fy) * (c101 - c001) + fy * (c111 - c011));
+    gradient[1] = (1.0 - fz) * (c10 - c00) + fz * (c11 - c01);
+    gradient[2] = c1 - c0;
+    gradient *= inverse_voxel_size;
+
+    return {distance, gradient, false, distance >= band};
+}
+
+FieldDistance DistanceField::exactDistance(const Eigen::Vector3d& point) const {
+    ObstacleIndex::NearestObstacle nearest = index.nearest(point);
+    Eigen::Vector3d offset = point - nearest.position;
+    Eigen::Vector3d gradient = nearest.distance > 0.0 ? Eigen::Vector3d(offset / nearest.distance)
+                                                      : Eigen::Vector3d::Zero();
+    return {nearest.distance, gradient, true, false};
+}
+
+FieldDistance DistanceField::query(const Eigen::Vector3d& point, double exact_below) const {
+    FieldDistance result = lookup(point);
+    if (index.empty()) return result;
+    if (result.beyond_band) {
+        // Truncation only hides distances above band; re-measure if that is not enough
+        return band > exact_below ? result : exactDistance(point);
+    }
+    if (result.distance - errorBound() < exact_below) return exactDistance(point);
+    return result;
+}
+
+size_t DistanceField::getMemoryBytes() const {
+    return brick_table.size() * sizeof(int32_t) + samples.size() * sizeof(float);
+}
@@ -0,0 +1,72 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "obstacle_index.h"
+
+struct DistanceFieldOptions {
+    double voxel_size = 1.0;            // mm between samples
+    double band = 20.0;                 // mm; distances are stored up to this value
+};
+
+struct FieldDistance {
+    double distance;                    // band when beyond_band (a lower bound)
+    Eigen::Vector3d gradient;           // unit direction away from the nearest obstacle
+    bool exact;                         // measured against the points, not interpolated
+    bool beyond_band;
+};
+
+// Voxelised distance field over a static obstacle cloud, built once per
+// obstacle set or procedure phase. Samples live in 8x8x8-cell bricks that
+// are only allocated within `band` of an obstacle, so memory follows the
+// obstacle surface rather than the bounding volume. A lookup is one brick
+// table access plus a trilinear interpolation of the brick's corner
+// samples. Point clouds have no inside, so distances are unsigned.
+//
+// The field keeps its own k-d tree: query() re-measures exactly wherever
+// the interpolation error could hide a violation of exact_below.
+class DistanceField {
+public:
+    static constexpr int BRICK_CELLS = 8;
+    static constexpr int BRICK_SAMPLES = BRICK_CELLS + 1;  // corner samples are duplicated across bricks
+
+    DistanceField() = default;
+
+    void build(const std::vector<Eigen::Vector3d>& obstacles,
+               const DistanceFieldOptions& options = DistanceFieldOptions());
+
+    // O(1) interpolated distance and gradient
+    FieldDistance lookup(const Eigen::Vector3d& point) const;
+    // lookup(), but falls back to an exact nearest-obstacle query when the
+    // true distance may be below exact_below
+    FieldDistance query(const Eigen::Vector3d& point, double exact_below) const;
+
+    // Worst-case |interpolated - true| inside the band
+    double errorBound() const { return voxel_size * std::sqrt(3.0); }
+
+    bool empty() const { return brick_table.empty(); }
+    double getBand() const { return band; }
+    size_t getAllocatedBrickCount() const { return samples.size() / SAMPLES_PER_BRICK; }
+    size_t getMemoryBytes() const;
+
+private:
+    static constexpr int32_t EMPTY_BRICK = -1;
+    static constexpr size_t SAMPLES_PER_BRICK = BRICK_SAMPLES * BRICK_SAMPLES * BRICK_SAMPLES;
+
+    FieldDistance exactDistance(const Eigen::Vector3d& point) const;
+    FieldDistance beyondBand() const;
+
+    ObstacleIndex index;
+    Eigen::Vector3d origin = Eigen::Vector3d::Zero();
+    double voxel_size = 1.0;
+    double inverse_voxel_size = 1.0;
+    double band = 0.0;
+    int brick_dims[3] = {0, 0, 0};
+    std::vector<int32_t> brick_table;   // brick -> offset / SAMPLES_PER_BRICK, x-fastest
+    std::vector<float> samples;         // per brick, x-fastest
+};
+
+#endif // DISTANCE_FIELD_H
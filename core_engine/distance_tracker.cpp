@@ -0,0 +1,59 @@
+#include "distance_tracker.h"
+#include <limits>
+
+DistanceTracker::DistanceTracker(const ObstacleIndex& index, double warning_distance)
+    : index(index), fixed_warning_distance(warning_distance), shared_warning_distance(nullptr) {
+    reset();
+}
+
+DistanceTracker::DistanceTracker(const ObstacleIndex& index, const double* warning_distance)
+    : index(index), fixed_warning_distance(*warning_distance), shared_warning_distance(warning_distance) {
+    reset();
+}
+
+void DistanceTracker::reset() {
+    has_anchor = false;
+    index_generation = index.generation();
+    anchor = Eigen::Vector3d::Zero();
+    anchor_distance = std::numeric_limits<double>::max();
+    nearest_obstacle = ObstacleIndex::NO_OBSTACLE;
+    nearest_position = Eigen::Vector3d::Zero();
+}
+
+TrackedDistance DistanceTracker::update(const Eigen::Vector3d& tip) {
+    ++stats.updates;
+    
+    if(!has_anchor || index_generation != index.generation()) {
+        reset();
+        ++stats.full_queries;
+        return measure(tip, std::numeric_limits<double>::max());
+    }
+    
+    // Displacement is measured from the anchor, not the previous cycle, so
+    // the bound stays valid across any number of skipped cycles
+    double lower_bound = anchor_distance - (tip - anchor).norm();
+    if(lower_bound > getWarningDistance()) {
+        ++stats.skipped;
+        return {lower_bound, false, ObstacleIndex::NO_OBSTACLE};
+    }
+    
+    ++stats.local_queries;
+    if(nearest_obstacle == ObstacleIndex::NO_OBSTACLE) {
+        return measure(tip, std::numeric_limits<double>::max());
+    }
+    // The previous nearest obstacle bounds the new distance from above;
+    // widen by a hair so it is itself found by the strict comparison
+    double upper_bound = (tip - nearest_position).norm();
+    return measure(tip, upper_bound * (1.0 + 1e-12) + 1e-12);
+}
+
+TrackedDistance DistanceTracker::measure(const Eigen::Vector3d& tip, double search_radius) {
+    ObstacleIndex::NearestObstacle nearest = index.nearest(tip, search_radius);
+    
+    has_anchor = true;
+    anchor = tip;
+    anchor_distance = nearest.distance;
+    nearest_obstacle = nearest.index;
+    nearest_position = nearest.position;
+    return {nearest.distance, true, nearest.index};
+}
@@ -0,0 +1,64 @@
+#ifndef DISTANCE_TRACKER_H
+#define DISTANCE_TRACKER_H
+
+#include <cstdint>
+#include <eigen3/Eigen/Dense>
+#include "obstacle_index.h"
+
+struct DistanceTrackerStats {
+    uint64_t updates = 0;
+    uint64_t skipped = 0;           // answered from the bound, no index query
+    uint64_t local_queries = 0;     // bounded search around the last nearest obstacle
+    uint64_t full_queries = 0;      // first update or obstacle set changed
+};
+
+struct TrackedDistance {
+    double distance;                // exact distance, or a lower bound when !exact
+    bool exact;
+    size_t nearest_obstacle;        // valid when exact
+};
+
+// Stateful minimum-distance query for a point that moves a little between
+// control cycles. Distance to a point set is 1-Lipschitz, so after the tip
+// moves by s from where the distance d was last measured, the new distance
+// is at least d - s. While that bound stays above warning_distance the
+// tracker skips the query entirely; otherwise it re-queries with the
+// previous nearest obstacle as the search radius, which confines the
+// search to the tip's neighbourhood.
+class DistanceTracker {
+public:
+    DistanceTracker(const ObstacleIndex& index, double warning_distance);
+    // Reads *warning_distance on every update, so a margin changed by its
+    // owner applies at once; it must outlive the tracker, like the index
+    DistanceTracker(const ObstacleIndex& index, const double* warning_distance);
+
+    TrackedDistance update(const Eigen::Vector3d& tip);
+    void reset();
+
+    // Fixed from now on, no longer following a shared margin
+    void setWarningDistance(double distance) {
+        fixed_warning_distance = distance;
+        shared_warning_distance = nullptr;
+    }
+    double getWarningDistance() const {
+        return shared_warning_distance ? *shared_warning_distance : fixed_warning_distance;
+    }
+    const DistanceTrackerStats& getStats() const { return stats; }
+
+private:
+    TrackedDistance measure(const Eigen::Vector3d& tip, double search_radius);
+
+    const ObstacleIndex& index;
+    double fixed_warning_distance;
+    const double* shared_warning_distance;  // the owner's margin, nullptr when fixed
+    DistanceTrackerStats stats;
+
+    bool has_anchor;
+    uint64_t index_generation;
+    Eigen::Vector3d anchor;             // tip position at the last exact measurement
+    double anchor_distance;
+    size_t nearest_obstacle;
+    Eigen::Vector3d nearest_position;
+};
+
+#endif // DISTANCE_TRACKER_H
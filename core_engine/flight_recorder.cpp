@@ -0,0 +1,581 @@
+#include "flight_recorder.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const LogSite RECORDER_OPENED{LogLevel::Info, "FlightRecorder", "Recording to '{}' (session {}, {} records per chunk)"};
+const LogSite RECORDER_CLOSED{LogLevel::Info, "FlightRecorder", "Recording closed: {} records, {} dropped"};
+const LogSite DIRECTORY_FAILED{LogLevel::Error, "FlightRecorder", "Cannot create recording directory '{}': {}"};
+const LogSite CHUNK_CREATE_FAILED{LogLevel::Error, "FlightRecorder", "Cannot create chunk '{}': {}"};
+const LogSite CHUNK_SEAL_FAILED{LogLevel::Error, "FlightRecorder", "Cannot seal chunk '{}': {}, raw chunk kept"};
+const LogSite CHUNK_RECOVERED{LogLevel::Warning, "FlightRecorder", "Sealed chunk '{}' left by an earlier run ({} records)"};
+const LogSite CHUNKS_EXPIRED{LogLevel::Info, "FlightRecorder", "Deleted {} chunks past the retention period"};
+
+constexpr uint32_t RAW_MAGIC = 0x31435246;          // "FRC1"
+constexpr uint32_t SEALED_MAGIC = 0x315A5246;       // "FRZ1"
+constexpr uint16_t FORMAT_VERSION = 1;
+constexpr size_t RAW_HEADER_SIZE = 64;
+constexpr const char* RAW_EXTENSION = ".frec";
+constexpr const char* SEALED_EXTENSION = ".frz";
+
+// First bytes of a raw chunk; the records follow at RAW_HEADER_SIZE.
+// committed is the only field written after creation.
+struct RawChunkHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint64_t capacity;
+    uint64_t chunk_index;
+    uint64_t session_id;
+    int64_t created_unix_ns;
+    std::atomic<uint64_t> committed;
+};
+
+static_assert(sizeof(RawChunkHeader) <= RAW_HEADER_SIZE, "raw chunk header must fit its reserved space");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "committed count is shared through a file mapping");
+static_assert(RAW_HEADER_SIZE % alignof(RobotStateSnapshot) == 0, "records must stay aligned");
+
+// A sealed chunk is this header, one uint32 byte length per column, then
+// the column streams in column order
+struct SealedChunkHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t column_count;
+    uint32_t reserved;
+    uint64_t chunk_index;
+    uint64_t session_id;
+    int64_t created_unix_ns;
+    uint64_t record_count;
+};
+
+// One scalar field of RobotStateSnapshot
+struct Column {
+    size_t offset;
+    size_t size;
+    bool floating;
+};
+
+std::vector<Column> buildColumns() {
+    std::vector<Column> columns;
+    auto add = [&columns](size_t offset, size_t size, bool floating) { columns.push_back(Column{offset, size, floating}); };
+    add(offsetof(RobotStateSnapshot, cycle), sizeof(uint64_t), false);
+    add(offsetof(RobotStateSnapshot, timestamp_ns), sizeof(uint64_t), false);
+    add(offsetof(RobotStateSnapshot, joint_count), sizeof(uint8_t), false);
+    add(offsetof(RobotStateSnapshot, force_count), sizeof(uint8_t), false);
+    add(offsetof(RobotStateSnapshot, robot_state), sizeof(RobotState), false);
+    add(offsetof(RobotStateSnapshot, procedure_phase), sizeof(ProcedurePhase), false);
+    add(offsetof(RobotStateSnapshot, emergency_stop), sizeof(bool), false);
+    for (size_t i = 0; i < RobotStateSnapshot::MAX_JOINTS; ++i) {
+        add(offsetof(RobotStateSnapshot, joint_positions) + i * sizeof(double), sizeof(double), true);
+    }
+    for (size_t i = 0; i < RobotStateSnapshot::MAX_JOINTS; ++i) {
+        add(offsetof(RobotStateSnapshot, joint_velocities) + i * sizeof(double), sizeof(double), true);
+    }
+    for (size_t i = 0; i < RobotStateSnapshot::MAX_FORCE_CHANNELS; ++i) {
+        add(offsetof(RobotStateSnapshot, force_readings) + i * sizeof(double), sizeof(double), true);
+    }
+    add(offsetof(RobotStateSnapshot, collision_risk), sizeof(double), true);
+    add(offsetof(RobotStateSnapshot, procedure_duration), sizeof(double), true);
+    add(offsetof(RobotStateSnapshot, safety_score), sizeof(double), true);
+    return columns;
+}
+
+const std::vector<Column>& recordColumns() {
+    static const std::vector<Column> columns = buildColumns();
+    return columns;
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool getVarint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+        uint8_t byte = *cursor++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+void encodeColumn(const Column& column, const RobotStateSnapshot* records, uint64_t count, std::vector<uint8_t>& out) {
+    uint64_t previous = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t value = 0;
+        std::memcpy(&value, reinterpret_cast<const uint8_t*>(&records[i]) + column.offset, column.size);
+        if (column.floating) {
+            putVarint(out, value ^ previous);
+        } else {
+            putVarint(out, zigzag(static_cast<int64_t>(value - previous)));
+        }
+        previous = value;
+    }
+}
+
+bool decodeColumn(const Column& column, const uint8_t* cursor, const uint8_t* end, RobotStateSnapshot* records, uint64_t count) {
+    uint64_t previous = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t encoded = 0;
+        if (!getVarint(cursor, end, encoded)) return false;
+        uint64_t value = column.floating ? encoded ^ previous : previous + static_cast<uint64_t>(unzigzag(encoded));
+        std::memcpy(reinterpret_cast<uint8_t*>(&records[i]) + column.offset, &value, column.size);
+        previous = value;
+    }
+    return cursor == end;
+}
+
+int64_t unixNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string chunkPath(const std::string& directory, uint64_t index, bool sealed) {
+    char name[48];
+    std::snprintf(name, sizeof(name), "chunk_%016llu%s", static_cast<unsigned long long>(index),
+                  sealed ? SEALED_EXTENSION : RAW_EXTENSION);
+    return directory + "/" + name;
+}
+
+bool parseChunkName(const std::string& name, uint64_t& index, bool& sealed) {
+    unsigned long long value = 0;
+    int consumed = 0;
+    if (std::sscanf(name.c_str(), "chunk_%16llu%n", &value, &consumed) != 1) return false;
+    std::string extension = name.substr(static_cast<size_t>(consumed));
+    if (extension != RAW_EXTENSION && extension != SEALED_EXTENSION) return false;
+    index = value;
+    sealed = extension == SEALED_EXTENSION;
+    return true;
+}
+
+bool readWholeFile(const std::string& path, std::vector<uint8_t>& bytes) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0;
+    if (ok) {
+        bytes.resize(static_cast<size_t>(info.st_size));
+        size_t done = 0;
+        while (ok && done < bytes.size()) {
+            ssize_t result = ::read(fd, bytes.data() + done, bytes.size() - done);
+            if (result < 0 && errno == EINTR) continue;
+            ok = result > 0;
+            if (ok) done += static_cast<size_t>(result);
+        }
+    }
+    ::close(fd);
+    return ok;
+}
+
+bool readHeaderBytes(const std::string& path, void* header, size_t size) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    ssize_t result = pread(fd, header, size, 0);
+    ::close(fd);
+    return result == static_cast<ssize_t>(size);
+}
+
+// Record count of a raw chunk as far as its header and size vouch for it
+uint64_t rawRecordCount(const RawChunkHeader& header, size_t file_bytes) {
+    uint64_t stored = file_bytes > RAW_HEADER_SIZE ? (file_bytes - RAW_HEADER_SIZE) / sizeof(RobotStateSnapshot) : 0;
+    return std::min({header.committed.load(std::memory_order_acquire), header.capacity, stored});
+}
+
+bool validRawHeader(const RawChunkHeader& header) {
+    return header.magic == RAW_MAGIC && header.version == FORMAT_VERSION &&
+           header.record_size == sizeof(RobotStateSnapshot);
+}
+
+bool validSealedHeader(const SealedChunkHeader& header) {
+    return header.magic == SEALED_MAGIC && header.version == FORMAT_VERSION &&
+           header.record_size == sizeof(RobotStateSnapshot) && header.column_count == recordColumns().size();
+}
+
+// Writes next to the final path, syncs, then renames over it so a reader
+// sees either no sealed chunk or a complete one
+bool writeFileAtomically(const std::string& path, const std::vector<uint8_t>& bytes) {
+    std::string temporary = path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    size_t done = 0;
+    bool ok = true;
+    while (ok && done < bytes.size()) {
+        ssize_t result = ::write(fd, bytes.data() + done, bytes.size() - done);
+        if (result < 0 && errno == EINTR) continue;
+        ok = result > 0;
+        if (ok) done += static_cast<size_t>(result);
+    }
+    ok = ok && fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        int saved = errno;
+        unlink(temporary.c_str());
+        errno = saved;
+        return false;
+    }
+
+    std::string directory = std::filesystem::path(path).parent_path().string();
+    int directory_fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directory_fd >= 0) {
+        fsync(directory_fd);
+        ::close(directory_fd);
+    }
+    return true;
+}
+
+// Column-encodes the records into a sealed chunk. Returns the sealed size, 0 on failure.
+size_t sealRecords(const std::string& path, const RawChunkHeader& raw, const RobotStateSnapshot* records, uint64_t count) {
+    const std::vector<Column>& columns = recordColumns();
+    SealedChunkHeader header{SEALED_MAGIC, FORMAT_VERSION, static_cast<uint16_t>(sizeof(RobotStateSnapshot)),
+                             static_cast<uint32_t>(columns.size()), 0, raw.chunk_index, raw.session_id,
+                             raw.created_unix_ns, count};
+
+    std::vector<uint8_t> bytes(sizeof(header) + columns.size() * sizeof(uint32_t));
+    bytes.reserve(bytes.size() + count * sizeof(RobotStateSnapshot) / 2);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    for (size_t c = 0; c < columns.size(); ++c) {
+        size_t start = bytes.size();
+        encodeColumn(columns[c], records, count, bytes);
+        uint32_t length = static_cast<uint32_t>(bytes.size() - start);
+        std::memcpy(bytes.data() + sizeof(header) + c * sizeof(uint32_t), &length, sizeof(length));
+    }
+    return writeFileAtomically(path, bytes) ? bytes.size() : 0;
+}
+
+} // namespace
+
+struct FlightRecorder::Chunk {
+    std::string path;
+    uint8_t* base;
+    size_t mapped_bytes;
+    RawChunkHeader* header;
+    RobotStateSnapshot* records;
+    uint64_t capacity;
+};
+
+bool flightRecorderOptions(const RobotParameters& parameters, FlightRecorderOptions& options) {
+    options.directory = parameters.flight_recorder_directory;
+    options.records_per_chunk = parameters.flight_records_per_chunk;
+    options.retention = std::chrono::hours(24) * parameters.retention_period_days;
+    options.flush_interval = std::chrono::milliseconds(parameters.flight_flush_interval_ms);
+    return parameters.record_raw_sensor_data;
+}
+
+FlightRecorder::FlightRecorder(const FlightRecorderOptions& options)
+    : options(options), session_id(0), next_chunk_index(0), active(nullptr), active_count(0),
+      retired{}, retired_head(0), retired_tail(0), spare(nullptr), active_chunk(nullptr), stopping(false),
+      recorded(0), dropped(0), chunks_sealed(0), chunks_recovered(0), chunks_expired(0),
+      raw_bytes_sealed(0), sealed_bytes(0) {
+    this->options.records_per_chunk = std::max<size_t>(this->options.records_per_chunk, 1);
+}
+
+FlightRecorder::~FlightRecorder() {
+    close();
+}
+
+bool FlightRecorder::open() {
+    if (isOpen()) return true;
+    std::error_code error;
+    std::filesystem::create_directories(options.directory, error);
+    if (error) {
+        logMessage(DIRECTORY_FAILED, options.directory, error.message());
+        return false;
+    }
+
+    // Seal what an earlier run left behind and continue its numbering
+    next_chunk_index = 0;
+    for (const FlightChunkInfo& info : listFlightChunks(options.directory)) {
+        next_chunk_index = std::max(next_chunk_index, info.index + 1);
+        if (info.sealed) continue;
+
+        // A damaged raw chunk is left for inspection
+        std::vector<RobotStateSnapshot> records;
+        RawChunkHeader raw{};
+        if (!readFlightChunk(info.path, records) || !readHeaderBytes(info.path, &raw, sizeof(raw))) continue;
+        if (!records.empty()) {
+            size_t bytes = sealRecords(chunkPath(options.directory, info.index, true), raw, records.data(), records.size());
+            if (bytes == 0) {
+                logMessage(CHUNK_SEAL_FAILED, info.path, std::strerror(errno));
+                continue;
+            }
+            chunks_recovered.fetch_add(1, std::memory_order_relaxed);
+            logMessage(CHUNK_RECOVERED, info.path, records.size());
+        }
+        unlink(info.path.c_str());
+    }
+    expireChunks();
+
+    session_id = static_cast<uint64_t>(unixNanoseconds());
+    // The control thread starts on a mapped chunk; the background thread maps the spare
+    Chunk* first = createChunk();
+    if (!first) return false;
+    active = first;
+    active_count = 0;
+    active_chunk.store(first, std::memory_order_release);
+
+    stopping = false;
+    background_thread = std::thread(&FlightRecorder::backgroundLoop, this);
+    logMessage(RECORDER_OPENED, options.directory, session_id, options.records_per_chunk);
+    return true;
+}
+
+void FlightRecorder::close() {
+    if (!isOpen()) return;
+    {
+        std::lock_guard<std::mutex> lock(background_mutex);
+        stopping = true;
+    }
+    background_wake.notify_all();
+    background_thread.join();
+
+    drainRetired();
+    active_chunk.store(nullptr, std::memory_order_release);
+    if (active) releaseChunk(active, true);
+    active = nullptr;
+    active_count = 0;
+    Chunk* unused = spare.exchange(nullptr, std::memory_order_acq_rel);
+    if (unused) releaseChunk(unused, false);
+    logMessage(RECORDER_CLOSED, recorded.load(std::memory_order_relaxed), dropped.load(std::memory_order_relaxed));
+}
+
+bool FlightRecorder::append(const RobotStateSnapshot& record) {
+    if (active == nullptr || active_count == active->capacity) {
+        if (!switchChunk()) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    std::memcpy(static_cast<void*>(active->records + active_count), &record, sizeof(record));
+    active->header->committed.store(++active_count, std::memory_order_release);
+    recorded.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool FlightRecorder::switchChunk() {
+    if (active) {
+        uint64_t head = retired_head.load(std::memory_order_relaxed);
+        if (head - retired_tail.load(std::memory_order_acquire) == RETIRED_CAPACITY) return false;
+        retired[head % RETIRED_CAPACITY] = active;
+        retired_head.store(head + 1, std::memory_order_release);
+        active = nullptr;
+        active_chunk.store(nullptr, std::memory_order_release);
+    }
+    Chunk* next = spare.exchange(nullptr, std::memory_order_acq_rel);
+    if (!next) return false;
+    active = next;
+    active_count = 0;
+    active_chunk.store(next, std::memory_order_release);
+    return true;
+}
+
+FlightRecorder::Chunk* FlightRecorder::createChunk() {
+    std::string path = chunkPath(options.directory, next_chunk_index, false);
+    const size_t bytes = RAW_HEADER_SIZE + options.records_per_chunk * sizeof(RobotStateSnapshot);
+
+    int fd = ::open(path.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        logMessage(CHUNK_CREATE_FAILED, path, std::strerror(errno));
+        return nullptr;
+    }
+    // Allocated up front so a full disk fails here and not as SIGBUS in append()
+    int result = posix_fallocate(fd, 0, static_cast<off_t>(bytes));
+    void* mapped = result == 0 ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0) : MAP_FAILED;
+    if (result == 0 && mapped == MAP_FAILED) result = errno;
+    ::close(fd);
+    if (result != 0) {
+        logMessage(CHUNK_CREATE_FAILED, path, std::strerror(result));
+        unlink(path.c_str());
+        return nullptr;
+    }
+    ++next_chunk_index;
+
+    // Dirty every page now, so the control thread does not take the first write fault
+    auto* base = static_cast<uint8_t*>(mapped);
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t offset = 0; offset < bytes; offset += page) {
+        static_cast<volatile uint8_t*>(base)[offset] = 0;
+    }
+
+    auto* header = new (base) RawChunkHeader{RAW_MAGIC, FORMAT_VERSION, static_cast<uint16_t>(sizeof(RobotStateSnapshot)),
+                                             options.records_per_chunk, next_chunk_index - 1, session_id,
+                                             unixNanoseconds(), {0}};
+    return new Chunk{path, base, bytes, header, reinterpret_cast<RobotStateSnapshot*>(base + RAW_HEADER_SIZE),
+                     options.records_per_chunk};
+}
+
+void FlightRecorder::releaseChunk(Chunk* chunk, bool seal) {
+    uint64_t count = std::min(chunk->header->committed.load(std::memory_order_acquire), chunk->capacity);
+    bool keep_raw = false;
+    if (seal && count > 0) {
+        std::string sealed_path = chunk->path.substr(0, chunk->path.size() - std::strlen(RAW_EXTENSION)) + SEALED_EXTENSION;
+        size_t bytes = sealRecords(sealed_path, *chunk->header, chunk->records, count);
+        if (bytes == 0) {
+            logMessage(CHUNK_SEAL_FAILED, chunk->path, std::strerror(errno));
+            msync(chunk->base, chunk->mapped_bytes, MS_SYNC);
+            keep_raw = true;
+        } else {
+            chunks_sealed.fetch_add(1, std::memory_order_relaxed);
+            raw_bytes_sealed.fetch_add(count * sizeof(RobotStateSnapshot), std::memory_order_relaxed);
+            sealed_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+    munmap(chunk->base, chunk->mapped_bytes);
+    if (!keep_raw) unlink(chunk->path.c_str());
+    delete chunk;
+}
+
+void FlightRecorder::backgroundLoop() {
+    std::unique_lock<std::mutex> lock(background_mutex);
+    while (!stopping) {
+        lock.unlock();
+        if (!spare.load(std::memory_order_acquire)) {
+            Chunk* chunk = createChunk();
+            if (chunk) spare.store(chunk, std::memory_order_release);
+        }
+        drainRetired();
+        flushActive();
+        lock.lock();
+        if (!stopping) background_wake.wait_for(lock, options.flush_interval);
+    }
+}
+
+void FlightRecorder::drainRetired() {
+    bool sealed_any = false;
+    uint64_t tail = retired_tail.load(std::memory_order_relaxed);
+    while (tail != retired_head.load(std::memory_order_acquire)) {
+        Chunk* chunk = retired[tail % RETIRED_CAPACITY];
+        retired_tail.store(++tail, std::memory_order_release);
+        releaseChunk(chunk, true);
+        sealed_any = true;
+    }
+    if (sealed_any) expireChunks();
+}
+
+void FlightRecorder::flushActive() {
+    // Only this thread frees chunks, so the active one stays mapped until we return
+    Chunk* chunk = active_chunk.load(std::memory_order_acquire);
+    if (!chunk) return;
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t end = RAW_HEADER_SIZE + chunk->header->committed.load(std::memory_order_acquire) * sizeof(RobotStateSnapshot);
+    end = std::min((end + page - 1) / page * page, chunk->mapped_bytes);
+    msync(chunk->base, end, MS_SYNC);
+}
+
+void FlightRecorder::expireChunks() {
+    if (options.retention.count() <= 0) return;
+    const int64_t cutoff = unixNanoseconds() - std::chrono::duration_cast<std::chrono::nanoseconds>(options.retention).count();
+    uint64_t expired = 0;
+    for (const FlightChunkInfo& info : listFlightChunks(options.directory)) {
+        if (info.sealed && info.created_unix_ns < cutoff && unlink(info.path.c_str()) == 0) ++expired;
+    }
+    if (expired == 0) return;
+    chunks_expired.fetch_add(expired, std::memory_order_relaxed);
+    logMessage(CHUNKS_EXPIRED, expired);
+}
+
+FlightRecorderStats FlightRecorder::getStats() const {
+    return FlightRecorderStats{recorded.load(std::memory_order_relaxed),
+                               dropped.load(std::memory_order_relaxed),
+                               chunks_sealed.load(std::memory_order_relaxed),
+                               chunks_recovered.load(std::memory_order_relaxed),
+                               chunks_expired.load(std::memory_order_relaxed),
+                               raw_bytes_sealed.load(std::memory_order_relaxed),
+                               sealed_bytes.load(std::memory_order_relaxed)};
+}
+
+std::vector<FlightChunkInfo> listFlightChunks(const std::string& directory) {
+    std::vector<FlightChunkInfo> chunks;
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        FlightChunkInfo info{};
+        if (!parseChunkName(it->path().filename().string(), info.index, info.sealed)) continue;
+        info.path = it->path().string();
+
+        if (info.sealed) {
+            SealedChunkHeader header{};
+            if (!readHeaderBytes(info.path, &header, sizeof(header)) || !validSealedHeader(header)) continue;
+            info.session_id = header.session_id;
+            info.created_unix_ns = header.created_unix_ns;
+            info.record_count = header.record_count;
+        } else {
+            RawChunkHeader header{};
+            std::error_code size_error;
+            size_t file_bytes = static_cast<size_t>(std::filesystem::file_size(it->path(), size_error));
+            if (size_error || !readHeaderBytes(info.path, &header, sizeof(header)) || !validRawHeader(header)) continue;
+            info.session_id = header.session_id;
+            info.created_unix_ns = header.created_unix_ns;
+            info.record_count = rawRecordCount(header, file_bytes);
+        }
+        chunks.push_back(info);
+    }
+    std::sort(chunks.begin(), chunks.end(), [](const FlightChunkInfo& a, const FlightChunkInfo& b) { return a.index < b.index; });
+    return chunks;
+}
+
+bool readFlightChunk(const std::string& path, std::vector<RobotStateSnapshot>& records) {
+    std::vector<uint8_t> bytes;
+    if (!readWholeFile(path, bytes) || bytes.size() < sizeof(uint32_t)) return false;
+    uint32_t magic = 0;
+    std::memcpy(&magic, bytes.data(), sizeof(magic));
+
+    if (magic == RAW_MAGIC) {
+        if (bytes.size() < RAW_HEADER_SIZE) return false;
+        RawChunkHeader header{};
+        std::memcpy(static_cast<void*>(&header), bytes.data(), sizeof(header));
+        if (!validRawHeader(header)) return false;
+        uint64_t count = rawRecordCount(header, bytes.size());
+        size_t first = records.size();
+        records.resize(first + count);
+        std::memcpy(static_cast<void*>(records.data() + first), bytes.data() + RAW_HEADER_SIZE, count * sizeof(RobotStateSnapshot));
+        return true;
+    }
+
+    SealedChunkHeader header{};
+    const std::vector<Column>& columns = recordColumns();
+    size_t streams = sizeof(header) + columns.size() * sizeof(uint32_t);
+    if (bytes.size() < streams) return false;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (!validSealedHeader(header)) return false;
+    // Every value takes at least one varint byte in its column, so a count
+    // the file cannot hold is a damaged header, not a reason to allocate
+    if (header.record_count > (bytes.size() - streams) / columns.size()) return false;
+
+    size_t first = records.size();
+    records.resize(first + header.record_count, RobotStateSnapshot{});
+    const uint8_t* cursor = bytes.data() + streams;
+    const uint8_t* end = bytes.data() + bytes.size();
+    for (size_t c = 0; c < columns.size(); ++c) {
+        uint32_t length = 0;
+        std::memcpy(&length, bytes.data() + sizeof(header) + c * sizeof(uint32_t), sizeof(length));
+        if (length > static_cast<size_t>(end - cursor) ||
+            !decodeColumn(columns[c], cursor, cursor + length, records.data() + first, header.record_count)) {
+            records.resize(first);
+            return false;
+        }
+        cursor += length;
+    }
+    return true;
+}
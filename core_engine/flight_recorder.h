@@ -0,0 +1,137 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "robot_parameters.h"
+#include "robot_state_snapshot.h"
+
+// Defaults follow the logging section of robot_config.yaml
+struct FlightRecorderOptions {
+    std::string directory = "recordings";
+    size_t records_per_chunk = 65536;                   // ~65 s at 1 kHz, ~16 MB mapped
+    std::chrono::seconds retention{30 * 24 * 3600};     // retention_period_days; 0 keeps everything
+    std::chrono::milliseconds flush_interval{100};      // msync of the active chunk
+};
+
+// Recorder settings from the logging section of robot_config.yaml, as
+// parsed into `parameters`. False when raw_sensor_data is off, in which
+// case no recorder should be opened; `options` is filled either way.
+bool flightRecorderOptions(const RobotParameters& parameters, FlightRecorderOptions& options);
+
+struct FlightRecorderStats {
+    uint64_t recorded;
+    uint64_t dropped;                   // no mapped chunk was ready
+    uint64_t chunks_sealed;
+    uint64_t chunks_recovered;          // left unsealed by an earlier run and sealed on open()
+    uint64_t chunks_expired;
+    uint64_t raw_bytes_sealed;
+    uint64_t sealed_bytes;              // after compression
+};
+
+// One chunk file of a recording, sealed or still raw
+struct FlightChunkInfo {
+    std::string path;
+    uint64_t index;                     // increases across sessions in one directory
+    uint64_t session_id;                // system_clock ns at the recorder's open()
+    int64_t created_unix_ns;
+    uint64_t record_count;
+    bool sealed;
+};
+
+// Black-box recorder for the full-rate robot state.
+//
+// append() is called from the control thread and only copies the record
+// into a chunk file that is already memory-mapped, then publishes the new
+// record count in the chunk header: no syscall, lock or allocation. The
+// records land in the page cache as they are written, so a crashed process
+// loses nothing; a crash of the machine loses what was written since the
+// last flush, which the background thread does every flush_interval.
+//
+// The background thread keeps one pre-allocated, pre-faulted chunk mapped
+// ahead of the control thread, seals full chunks and applies retention.
+// Sealing stores every field as its own column, integers delta + zigzag
+// varint encoded and doubles XORed with the previous value and varint
+// encoded, so slowly changing channels shrink to a byte or two; the sealed
+// file replaces the raw chunk with an atomic rename. Raw chunks left by a
+// crashed run are sealed by the next open().
+//
+// When the background thread falls a chunk behind, append() drops records
+// rather than wait; getStats() counts them.
+class FlightRecorder {
+public:
+    explicit FlightRecorder(const FlightRecorderOptions& options = FlightRecorderOptions());
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // Creates the directory, seals chunks left by an earlier run, expires
+    // old ones and maps the first chunk
+    bool open();
+    // Seals the active chunk; the control thread must no longer append
+    void close();
+    bool isOpen() const { return background_thread.joinable(); }
+
+    // Control thread only
+    bool append(const RobotStateSnapshot& record);
+
+    FlightRecorderStats getStats() const;
+    uint64_t getSessionId() const { return session_id; }
+    const FlightRecorderOptions& getOptions() const { return options; }
+
+private:
+    struct Chunk;
+
+    Chunk* createChunk();
+    void releaseChunk(Chunk* chunk, bool seal);
+    bool switchChunk();
+    void backgroundLoop();
+    void drainRetired();
+    void flushActive();
+    void expireChunks();
+
+    FlightRecorderOptions options;
+    uint64_t session_id;
+    uint64_t next_chunk_index;          // background thread (or open/close)
+
+    // Control thread
+    Chunk* active;
+    uint64_t active_count;
+
+    // Control thread -> background thread
+    static constexpr size_t RETIRED_CAPACITY = 8;
+    Chunk* retired[RETIRED_CAPACITY];
+    std::atomic<uint64_t> retired_head;
+    std::atomic<uint64_t> retired_tail;
+    std::atomic<Chunk*> spare;          // mapped ahead, taken by the control thread
+    std::atomic<Chunk*> active_chunk;   // for the background flush
+
+    std::thread background_thread;
+    std::mutex background_mutex;
+    std::condition_variable background_wake;
+    bool stopping;
+
+    std::atomic<uint64_t> recorded;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> chunks_sealed;
+    std::atomic<uint64_t> chunks_recovered;
+    std::atomic<uint64_t> chunks_expired;
+    std::atomic<uint64_t> raw_bytes_sealed;
+    std::atomic<uint64_t> sealed_bytes;
+};
+
+// Chunks of a recording directory ordered by index; unreadable files are skipped
+std::vector<FlightChunkInfo> listFlightChunks(const std::string& directory);
+
+// Appends the records of a sealed or raw chunk. False for a damaged file.
+bool readFlightChunk(const std::string& path, std::vector<RobotStateSnapshot>& records);
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,383 @@
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <eigen3/Eigen/Dense>
+
+enum class KinematicsStatus {
+    Ok = 0,
+    InvalidInput,       // NaN/Inf joint angles or target
+    Unreachable,
+    NotConverged
+};
+
+// One row of a Denavit-Hartenberg table. theta_offset is added to the joint
+// angle; alpha, a and d are constant for the link.
+template <typename Scalar>
+struct DHParameters {
+    Scalar theta_offset;
+    Scalar alpha;
+    Scalar a;
+    Scalar d;
+};
+
+template <int DOF, typename Scalar = double>
+using DHTable = std::array<DHParameters<Scalar>, DOF>;
+
+// Budgets for the iterative inverse kinematics solver. At 1 kHz a warm
+// started solve normally converges in a handful of iterations; the time
+// budget bounds the worst case.
+template <typename Scalar = double>
+struct IKOptions {
+    int max_iterations = 50;
+    std::chrono::nanoseconds time_budget = std::chrono::microseconds(500);
+    Scalar damping = Scalar(0.01);         // lambda of damped least squares
+    Scalar tolerance = Scalar(1e-5);       // position residual, metres
+    Scalar max_step = Scalar(0.5);         // largest joint update per iteration, rad
+};
+
+template <typename Scalar = double>
+struct IKResult {
+    KinematicsStatus status = KinematicsStatus::NotConverged;
+    int iterations = 0;
+    Scalar residual = Scalar(0);           // |target - achieved position|
+    std::chrono::nanoseconds elapsed{0};
+};
+
+// Ethicon surgical robot DH parameters [theta, alpha, a, d] for each joint
+constexpr DHTable<6> ETHICON_ARM_DH_PARAMETERS = {{
+    {0.0,  M_PI/2, 0.0,  0.15},     // Joint 1
+    {0.0, -M_PI/2, 0.25, 0.0},      // Joint 2
+    {0.0,  M_PI/2, 0.0,  0.18},     // Joint 3
+    {0.0, -M_PI/2, 0.0,  0.0},      // Joint 4
+    {0.0,  M_PI/2, 0.0,  0.1},      // Joint 5
+    {0.0,  0.0,    0.0,  0.05}      // Joint 6 (end effector)
+}};
+
+// Fixed-DOF serial-arm kinematics. All inputs and outputs are fixed-size,
+// nothing allocates or throws, and the joint chain is expanded at compile
+// time so the compiler can fully unroll it.
+template <int DOF, typename Scalar = double>
+class Kinematics {
+public:
+    using JointVector = std::array<Scalar, DOF>;
+    using Vector3 = Eigen::Matrix<Scalar, 3, 1>;
+    using Rotation = Eigen::Matrix<Scalar, 3, 3>;
+    using Transform = Eigen::Matrix<Scalar, 4, 4>;
+    using Jacobian = Eigen::Matrix<Scalar, 6, DOF>;
+    using PositionJacobian = Eigen::Matrix<Scalar, 3, DOF>;
+
+    // Structure-of-arrays batch: joint j of configuration k is joints[j][k]
+    struct ConfigurationBlock {
+        std::array<const Scalar*, DOF> joints;
+        std::size_t count;
+    };
+
+    struct PositionBlock {
+        Scalar* x;
+        Scalar* y;
+        Scalar* z;
+    };
+
+    // Configurations evaluated together; each SIMD lane is one configuration
+    static constexpr int BATCH_TILE = 64;
+
+    explicit Kinematics(const DHTable<DOF, Scalar>& dh_table)
+        : dh_parameters(dh_table),
+          base_rotation(Rotation::Identity()),
+          base_translation(Vector3::Zero()) {
+        // alpha is constant per link, so its sin/cos are computed once
+        for (int i = 0; i < DOF; ++i) {
+            cos_alpha[i] = std::cos(dh_parameters[i].alpha);
+            sin_alpha[i] = std::sin(dh_parameters[i].alpha);
+            max_reach += std::hypot(dh_parameters[i].a, dh_parameters[i].d);
+        }
+    }
+
+    // Forward kinematics: joint angles -> end effector pose / position
+    KinematicsStatus forwardPose(const JointVector& joint_angles, Transform& pose) const noexcept {
+        if (!isFinite(joint_angles)) return KinematicsStatus::InvalidInput;
+
+        Rotation rotation = base_rotation;
+        Vector3 translation = base_translation;
+        chainLinks(joint_angles, rotation, translation, std::make_index_sequence<DOF>{});
+
+        pose.setIdentity();
+        pose.template block<3,3>(0,0) = rotation;
+        pose.template block<3,1>(0,3) = translation;
+        return KinematicsStatus::Ok;
+    }
+
+    KinematicsStatus forwardKinematics(const JointVector& joint_angles, Vector3& position) const noexcept {
+        if (!isFinite(joint_angles)) return KinematicsStatus::InvalidInput;
+
+        Rotation rotation = base_rotation;
+        Vector3 translation = base_translation;
+        chainLinks(joint_angles, rotation, translation, std::make_index_sequence<DOF>{});
+
+        position = translation;
+        return KinematicsStatus::Ok;
+    }
+
+    // Forward kinematics for configurations [begin, end) of a batch. The
+    // chain is evaluated for a whole tile at once with the rotation and
+    // translation kept as per-lane arrays, so every operation is a SIMD op
+    // across configurations. Non-finite inputs yield non-finite outputs for
+    // that configuration only.
+    void forwardKinematicsBatch(const ConfigurationBlock& configurations, const PositionBlock& positions,
+                                std::size_t begin, std::size_t end) const noexcept {
+        using Lanes = Eigen::Array<Scalar, BATCH_TILE, 1>;
+        using ConstLanesMap = Eigen::Map<const Lanes>;
+
+        for (std::size_t tile = begin; tile < end; tile += BATCH_TILE) {
+            const std::size_t lanes = std::min<std::size_t>(BATCH_TILE, end - tile);
+
+            std::array<Lanes, DOF> joint_tile;
+            for (int j = 0; j < DOF; ++j) {
+                if (lanes == BATCH_TILE) {
+                    joint_tile[j] = ConstLanesMap(configurations.joints[j] + tile);
+                } else {
+                    joint_tile[j].setZero();
+                    joint_tile[j].head(lanes) = Eigen::Map<const Eigen::Array<Scalar, Eigen::Dynamic, 1>>(
+                        configurations.joints[j] + tile, lanes);
+                }
+            }
+
+            Lanes x, y, z;
+            chainLinksBatch(joint_tile, x, y, z);
+
+            for (std::size_t k = 0; k < lanes; ++k) {
+                positions.x[tile + k] = x[k];
+                positions.y[tile + k] = y[k];
+                positions.z[tile + k] = z[k];
+            }
+        }
+    }
+
+    // Base origin followed by every frame origin down to the end effector;
+    // consecutive entries bound one link, e.g. for capsule collision models
+    KinematicsStatus jointPositions(const JointVector& joint_angles,
+                                    std::array<Vector3, DOF + 1>& positions) const noexcept {
+        if (!isFinite(joint_angles)) return KinematicsStatus::InvalidInput;
+
+        JointFrames frames;
+        Rotation rotation = base_rotation;
+        Vector3 translation = base_translation;
+        chainLinks(joint_angles, rotation, translation, frames, std::make_index_sequence<DOF>{});
+
+        for (int i = 0; i < DOF; ++i) positions[i] = frames.origins[i];
+        positions[DOF] = translation;
+        return KinematicsStatus::Ok;
+    }
+
+    // Geometric Jacobian (linear rows on top, angular below), built from
+    // the joint axes and origins collected during the forward pass
+    KinematicsStatus calculateJacobian(const JointVector& joint_angles, Jacobian& jacobian) const noexcept {
+        Transform pose;
+        return forwardPoseAndJacobian(joint_angles, pose, jacobian);
+    }
+
+    KinematicsStatus forwardPoseAndJacobian(const JointVector& joint_angles, Transform& pose,
+                                            Jacobian& jacobian) const noexcept {
+        if (!isFinite(joint_angles)) return KinematicsStatus::InvalidInput;
+
+        JointFrames frames;
+        Rotation rotation = base_rotation;
+        Vector3 translation = base_translation;
+        chainLinks(joint_angles, rotation, translation, frames, std::make_index_sequence<DOF>{});
+
+        for (int i = 0; i < DOF; ++i) {
+            jacobian.template block<3,1>(0, i) = frames.axes[i].cross(translation - frames.origins[i]);
+            jacobian.template block<3,1>(3, i) = frames.axes[i];
+        }
+
+        pose.setIdentity();
+        pose.template block<3,3>(0,0) = rotation;
+        pose.template block<3,1>(0,3) = translation;
+        return KinematicsStatus::Ok;
+    }
+
+    // Position-only damped least squares IK, warm-started from seed:
+    //   dq = J^T (J J^T + lambda^2 I)^-1 e
+    // solution holds the final iterate; the result reports whether it
+    // converged, how many iterations it took and the remaining residual.
+    IKResult<Scalar> inverseKinematics(const Vector3& target, const JointVector& seed,
+                                       JointVector& solution,
+                                       const IKOptions<Scalar>& options = IKOptions<Scalar>()) const noexcept {
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        IKResult<Scalar> result;
+        solution = seed;
+
+        if (!isFinite(seed) || !target.allFinite()) {
+            result.status = KinematicsStatus::InvalidInput;
+            return result;
+        }
+        if ((target - base_translation).norm() > max_reach) {
+            result.status = KinematicsStatus::Unreachable;
+            return result;
+        }
+
+        const Scalar damping_sq = options.damping * options.damping;
+        for (;;) {
+            JointFrames frames;
+            Rotation rotation = base_rotation;
+            Vector3 position = base_translation;
+            chainLinks(solution, rotation, position, frames, std::make_index_sequence<DOF>{});
+
+            const Vector3 error = target - position;
+            result.residual = error.norm();
+            if (result.residual <= options.tolerance) {
+                result.status = KinematicsStatus::Ok;
+                break;
+            }
+            if (result.iterations >= options.max_iterations ||
+                Clock::now() - start >= options.time_budget) {
+                break;
+            }
+
+            PositionJacobian jacobian;
+            for (int i = 0; i < DOF; ++i) {
+                jacobian.col(i) = frames.axes[i].cross(position - frames.origins[i]);
+            }
+
+            Eigen::Matrix<Scalar, 3, 3> normal = jacobian * jacobian.transpose();
+            normal.diagonal().array() += damping_sq;
+            Eigen::Matrix<Scalar, DOF, 1> step = jacobian.transpose() * normal.ldlt().solve(error);
+
+            const Scalar step_norm = step.template lpNorm<Eigen::Infinity>();
+            if (step_norm > options.max_step) step *= options.max_step / step_norm;
+            for (int i = 0; i < DOF; ++i) solution[i] += step[i];
+
+            ++result.iterations;
+        }
+
+        result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+        return result;
+    }
+
+    // Upper bound on the distance from the base to the end effector
+    Scalar maxReach() const { return max_reach; }
+
+    void setBaseTransform(const Transform& base) {
+        base_rotation = base.template block<3,3>(0,0);
+        base_translation = base.template block<3,1>(0,3);
+    }
+
+    const DHTable<DOF, Scalar>& dhParameters() const { return dh_parameters; }
+    const Vector3& baseTranslation() const { return base_translation; }
+
+    static bool isFinite(const JointVector& joint_angles) noexcept {
+        for (Scalar angle : joint_angles) {
+            if (!std::isfinite(angle)) return false;
+        }
+        return true;
+    }
+
+    static constexpr int dof() { return DOF; }
+
+private:
+    // Joint axis z_{i-1} and origin o_{i-1} of every joint, in base coordinates
+    struct JointFrames {
+        std::array<Vector3, DOF> axes;
+        std::array<Vector3, DOF> origins;
+    };
+
+    // Applies link I's DH transform to the running pose. The last row of a
+    // DH transform is always [0 0 0 1], so only the 3x4 affine part is kept.
+    template <std::size_t I>
+    void applyLink(const JointVector& joint_angles, Rotation& rotation, Vector3& translation) const {
+        const DHParameters<Scalar>& link = dh_parameters[I];
+        const Scalar theta = joint_angles[I] + link.theta_offset;
+        const Scalar ct = std::cos(theta);
+        const Scalar st = std::sin(theta);
+        const Scalar ca = cos_alpha[I];
+        const Scalar sa = sin_alpha[I];
+
+        Rotation link_rotation;
+        link_rotation << ct, -st * ca,  st * sa,
+                         st,  ct * ca, -ct * sa,
+                         Scalar(0), sa, ca;
+        const Vector3 link_translation(link.a * ct, link.a * st, link.d);
+
+        translation += rotation * link_translation;
+        rotation = rotation * link_rotation;
+    }
+
+    template <std::size_t I>
+    void applyLink(const JointVector& joint_angles, Rotation& rotation, Vector3& translation,
+                   JointFrames& frames) const {
+        frames.axes[I] = rotation.col(2);
+        frames.origins[I] = translation;
+        applyLink<I>(joint_angles, rotation, translation);
+    }
+
+    template <std::size_t... I>
+    void chainLinks(const JointVector& joint_angles, Rotation& rotation, Vector3& translation,
+                    std::index_sequence<I...>) const {
+        (applyLink<I>(joint_angles, rotation, translation), ...);
+    }
+
+    template <std::size_t... I>
+    void chainLinks(const JointVector& joint_angles, Rotation& rotation, Vector3& translation,
+                    JointFrames& frames, std::index_sequence<I...>) const {
+        (applyLink<I>(joint_angles, rotation, translation, frames), ...);
+    }
+
+    // Batch counterpart of chainLinks. Multiplying by a DH link rotation
+    // only mixes the columns of each rotation row, so row r becomes
+    //   c0' = c0*ct + c1*st
+    //   c1' = ca*(c1*ct - c0*st) + sa*c2
+    //   c2' = ca*c2 - sa*(c1*ct - c0*st)
+    // and the translation gains a*c0' + d*c2.
+    template <typename Lanes>
+    void chainLinksBatch(const std::array<Lanes, DOF>& joint_tile, Lanes& x, Lanes& y, Lanes& z) const {
+        std::array<Lanes, 9> rotation;
+        std::array<Lanes, 3> translation;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) rotation[r * 3 + c].setConstant(base_rotation(r, c));
+            translation[r].setConstant(base_translation[r]);
+        }
+
+        for (int j = 0; j < DOF; ++j) {
+            const DHParameters<Scalar>& link = dh_parameters[j];
+            const Lanes theta = joint_tile[j] + link.theta_offset;
+            const Lanes ct = theta.cos();
+            const Lanes st = theta.sin();
+            const Scalar ca = cos_alpha[j];
+            const Scalar sa = sin_alpha[j];
+
+            for (int r = 0; r < 3; ++r) {
+                Lanes& c0 = rotation[r * 3];
+                Lanes& c1 = rotation[r * 3 + 1];
+                Lanes& c2 = rotation[r * 3 + 2];
+
+                const Lanes mixed = c1 * ct - c0 * st;
+                const Lanes new_c0 = c0 * ct + c1 * st;
+                translation[r] += link.a * new_c0 + link.d * c2;
+
+                c0 = new_c0;
+                c1 = ca * mixed + sa * c2;
+                c2 = ca * c2 - sa * mixed;
+            }
+        }
+
+        x = translation[0];
+        y = translation[1];
+        z = translation[2];
+    }
+
+    DHTable<DOF, Scalar> dh_parameters;
+    std::array<Scalar, DOF> cos_alpha;
+    std::array<Scalar, DOF> sin_alpha;
+    Rotation base_rotation;
+    Vector3 base_translation;
+    Scalar max_reach = Scalar(0);
+};
+
+#endif // KINEMATICS_H
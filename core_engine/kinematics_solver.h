@@ -3,14 +3,27 @@
 
 #include <vector>
 #include <eigen3/Eigen/Dense>
+#include <string>
+#include "kinematics.h"
+#include "reachability_map.h"
 
+// Dynamic-size, exception-based front end over Kinematics<6>. Real-time
+// callers should use the fixed-size solver() directly.
 class RoboticsKinematics {
+public:
+    static constexpr int DOF = 6;
+    using Solver = Kinematics<DOF, double>;
+    
 private:
-    std::vector<double> dh_parameters; // Denavit-Hartenberg parameters
-    Eigen::Matrix4d base_transform;
+    Solver kinematics;
+    IKOptions<double> ik_options;
+    IKResult<double> last_ik_result;
+    Solver::JointVector warm_start; // last converged IK solution
+    ReachabilityMap reachability_map;
+    bool exact_reachability_refinement;
     
 public:
-    RoboticsKinematics();
+    explicit RoboticsKinematics(const DHTable<DOF>& dh_parameters = ETHICON_ARM_DH_PARAMETERS);
     
     // Forward kinematics: joint angles -> end effector position
     Eigen::Vector3d forwardKinematics(const std::vector<double>& joint_angles);
@@ -25,9 +38,24 @@ public:
     bool validateSolution(const std::vector<double>& joint_angles);
     bool isReachable(const Eigen::Vector3d& target_position);
     
+    // Precomputed workspace map: once built or loaded, isReachable answers
+    // interior and unreached voxels from the map in O(1) and runs IK for
+    // boundary voxels, or for every reached voxel when exact refinement is on
+    void buildReachabilityMap(const ReachabilityMapOptions& options = ReachabilityMapOptions());
+    bool loadReachabilityMap(const std::string& path);
+    bool saveReachabilityMap(const std::string& path) const { return reachability_map.save(path); }
+    void setExactReachabilityRefinement(bool enabled) { exact_reachability_refinement = enabled; }
+    float estimateManipulability(const Eigen::Vector3d& target_position) const;
+    
+    const Solver& solver() const { return kinematics; }
+    
+    // IK budgets and per-call cost reporting
+    void setIKOptions(const IKOptions<double>& options) { ik_options = options; }
+    const IKResult<double>& getLastIKResult() const { return last_ik_result; }
+    
 private:
     std::vector<double> validateJointSolution(const std::vector<double>& joint_angles);
-    Eigen::Matrix4d calculateTransform(double theta, double alpha, double a, double d);
+    Solver::JointVector toJointVector(const std::vector<double>& joint_angles) const;
 };
 
 #endif // KINEMATICS_SOLVER_H
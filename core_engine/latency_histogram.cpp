@@ -0,0 +1,152 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// Prometheus bucket edges in nanoseconds: 1-2-5 steps from 1 us to 1 s
+const uint64_t EXPORT_BOUNDS_NS[] = {
+    1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000,
+    1000000, 2000000, 5000000, 10000000, 20000000, 50000000, 100000000,
+    200000000, 500000000, 1000000000
+};
+
+struct ExportQuantile {
+    const char* label;
+    double quantile;
+};
+
+const ExportQuantile EXPORT_QUANTILES[] = {
+    {"0.5", 0.5}, {"0.99", 0.99}, {"0.999", 0.999}, {"1", 1.0}
+};
+
+void appendSeconds(std::string& out, uint64_t nanoseconds) {
+    char number[32];
+    std::snprintf(number, sizeof(number), "%.9g", static_cast<double>(nanoseconds) * 1e-9);
+    out += number;
+}
+
+std::string labelSet(const std::string& label_name, const std::string& label_value, const char* extra_name = nullptr,
+                     const std::string& extra_value = std::string()) {
+    std::string labels = "{" + label_name + "=\"" + label_value + "\"";
+    if (extra_name) labels += std::string(",") + extra_name + "=\"" + extra_value + "\"";
+    return labels + "}";
+}
+
+} // namespace
+
+uint64_t LatencySnapshot::percentile(double quantile) const {
+    if (count == 0) return 0;
+    if (quantile >= 1.0) return max_ns;
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::max(quantile, 0.0) * static_cast<double>(count)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) return std::min(LatencyHistogram::bucketUpperBound(i), max_ns);
+    }
+    return max_ns;
+}
+
+uint64_t LatencySnapshot::countAtOrBelow(uint64_t value_ns) const {
+    if (buckets.empty()) return 0;
+    // Buckets straddling value_ns are counted as above it
+    size_t last = LatencyHistogram::bucketIndex(std::min(value_ns, LatencyHistogram::MAX_TRACKABLE_NS));
+    if (LatencyHistogram::bucketUpperBound(last) > value_ns) {
+        if (last == 0) return 0;
+        --last;
+    }
+    uint64_t total = 0;
+    for (size_t i = 0; i <= last && i < buckets.size(); ++i) total += buckets[i];
+    return total;
+}
+
+LatencyHistogram::LatencyHistogram(uint64_t overrun_threshold)
+    : count(0), sum_ns(0), max_ns(0), overruns(0), overrun_threshold_ns(overrun_threshold) {
+    for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < SUB_BUCKETS) return index;
+    size_t offset = index - SUB_BUCKETS;
+    int shift = static_cast<int>(offset / HALF_SUB_BUCKETS) + 1;
+    uint64_t top = HALF_SUB_BUCKETS + offset % HALF_SUB_BUCKETS;
+    return ((top + 1) << shift) - 1;
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const {
+    LatencySnapshot result;
+    result.buckets.resize(BUCKET_COUNT);
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        result.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        total += result.buckets[i];
+    }
+    // Use the bucket total so percentiles are consistent with the buckets
+    // even while record() runs concurrently
+    result.count = total;
+    result.sum_ns = sum_ns.load(std::memory_order_relaxed);
+    result.max_ns = max_ns.load(std::memory_order_relaxed);
+    result.overruns = overruns.load(std::memory_order_relaxed);
+    return result;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    sum_ns.store(0, std::memory_order_relaxed);
+    max_ns.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+}
+
+void appendPrometheusHistograms(std::string& out, const std::string& metric, const std::string& label_name,
+                                const std::vector<LabelledLatency>& series) {
+    const std::string histogram = metric + "_seconds";
+    const std::string quantiles = metric + "_quantile_seconds";
+    const std::string overruns = metric + "_overruns_total";
+
+    out += "# HELP " + histogram + " Latency distribution\n# TYPE " + histogram + " histogram\n";
+    for (const auto& entry : series) {
+        for (uint64_t bound : EXPORT_BOUNDS_NS) {
+            std::string le;
+            appendSeconds(le, bound);
+            out += histogram + "_bucket" + labelSet(label_name, entry.label_value, "le", le) + " " +
+                   std::to_string(entry.snapshot.countAtOrBelow(bound)) + "\n";
+        }
+        out += histogram + "_bucket" + labelSet(label_name, entry.label_value, "le", "+Inf") + " " +
+               std::to_string(entry.snapshot.count) + "\n";
+        out += histogram + "_sum" + labelSet(label_name, entry.label_value) + " ";
+        appendSeconds(out, entry.snapshot.sum_ns);
+        out += "\n" + histogram + "_count" + labelSet(label_name, entry.label_value) + " " +
+               std::to_string(entry.snapshot.count) + "\n";
+    }
+
+    out += "# HELP " + quantiles + " Latency quantiles (1 = max)\n# TYPE " + quantiles + " gauge\n";
+    for (const auto& entry : series) {
+        for (const auto& quantile : EXPORT_QUANTILES) {
+            out += quantiles + labelSet(label_name, entry.label_value, "quantile", quantile.label) + " ";
+            appendSeconds(out, entry.snapshot.percentile(quantile.quantile));
+            out += "\n";
+        }
+    }
+
+    out += "# HELP " + overruns + " Samples above the latency budget\n# TYPE " + overruns + " counter\n";
+    for (const auto& entry : series) {
+        out += overruns + labelSet(label_name, entry.label_value) + " " + std::to_string(entry.snapshot.overruns) + "\n";
+    }
+}
+
+bool writeMetricsFile(const std::string& path, const std::string& text) {
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "w");
+    if (!file) return false;
+    bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
@@ -0,0 +1,106 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Point-in-time copy of a LatencyHistogram, taken on the reading thread
+struct LatencySnapshot {
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+    uint64_t overruns;                  // samples above the histogram's overrun threshold
+    std::vector<uint64_t> buckets;
+
+    // Upper edge of the bucket holding the q-quantile (at most max_ns);
+    // 0 when empty
+    uint64_t percentile(double quantile) const;
+    uint64_t countAtOrBelow(uint64_t value_ns) const;
+    double meanNanoseconds() const { return count ? static_cast<double>(sum_ns) / count : 0.0; }
+};
+
+// Log-linear (HDR-style) latency histogram in nanoseconds. Values below 64
+// ns get exact buckets; above that every power of two is split into 32
+// buckets, so any recorded value is known to within about 3%. Values past
+// MAX_TRACKABLE_NS land in the last bucket.
+//
+// record() is a handful of relaxed atomic increments, safe from any number
+// of threads; snapshot() can run concurrently from another thread and sees
+// each counter at some recent value.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 6;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr uint64_t HALF_SUB_BUCKETS = SUB_BUCKETS / 2;
+    static constexpr int MAX_VALUE_BITS = 40;                   // ~18 minutes
+    static constexpr uint64_t MAX_TRACKABLE_NS = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+    static constexpr size_t BUCKET_COUNT =
+        SUB_BUCKETS + (MAX_VALUE_BITS - SUB_BUCKET_BITS) * HALF_SUB_BUCKETS;
+
+    explicit LatencyHistogram(uint64_t overrun_threshold_ns = UINT64_MAX);
+
+    void record(uint64_t value_ns) {
+        if (value_ns > MAX_TRACKABLE_NS) value_ns = MAX_TRACKABLE_NS;
+        buckets[bucketIndex(value_ns)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum_ns.fetch_add(value_ns, std::memory_order_relaxed);
+        uint64_t current_max = max_ns.load(std::memory_order_relaxed);
+        while (value_ns > current_max &&
+               !max_ns.compare_exchange_weak(current_max, value_ns, std::memory_order_relaxed)) {}
+        if (value_ns > overrun_threshold_ns.load(std::memory_order_relaxed)) {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void setOverrunThreshold(uint64_t threshold_ns) { overrun_threshold_ns.store(threshold_ns, std::memory_order_relaxed); }
+    LatencySnapshot snapshot() const;
+    // Not synchronised with concurrent record() calls; samples recorded
+    // during a reset may be partly kept
+    void reset();
+
+    static size_t bucketIndex(uint64_t value_ns) {
+        if (value_ns < SUB_BUCKETS) return static_cast<size_t>(value_ns);
+        int msb = 63 - __builtin_clzll(value_ns);
+        int shift = msb - (SUB_BUCKET_BITS - 1);
+        return static_cast<size_t>(SUB_BUCKETS + (shift - 1) * HALF_SUB_BUCKETS +
+                                   ((value_ns >> shift) - HALF_SUB_BUCKETS));
+    }
+    // Largest value that maps to bucket index
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets;
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum_ns;
+    std::atomic<uint64_t> max_ns;
+    std::atomic<uint64_t> overruns;
+    std::atomic<uint64_t> overrun_threshold_ns;
+};
+
+// Monotonic timestamp for latency measurement
+inline uint64_t latencyTimestampNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct LabelledLatency {
+    std::string label_value;
+    LatencySnapshot snapshot;
+};
+
+// Appends labelled histograms in Prometheus text exposition format, one
+// family at a time: <metric>_seconds (cumulative buckets, sum, count),
+// <metric>_quantile_seconds (p50/p99/p99.9/max gauges) and
+// <metric>_overruns_total.
+void appendPrometheusHistograms(std::string& out, const std::string& metric, const std::string& label_name,
+                                const std::vector<LabelledLatency>& series);
+
+// Writes text to path via a temporary file and rename, so scrapers (e.g. a
+// node_exporter textfile collector) never read a partial file
+bool writeMetricsFile(const std::string& path, const std::string& text);
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,188 @@
+#include "obstacle_cloud.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define OBSTACLE_CLOUD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t PADDING = 8;   // floats per AVX2 register
+
+using MinSquaredDistanceKernel = float (*)(const float*, const float*, const float*, size_t,
+                                           float, float, float);
+
+float minSquaredDistanceScalar(const float* xs, const float* ys, const float* zs, size_t padded_count,
+                               float px, float py, float pz) {
+    float best = std::numeric_limits<float>::max();
+    for (size_t i = 0; i < padded_count; ++i) {
+        float dx = xs[i] - px;
+        float dy = ys[i] - py;
+        float dz = zs[i] - pz;
+        best = std::min(best, dx * dx + dy * dy + dz * dz);
+    }
+    return best;
+}
+
+#ifdef OBSTACLE_CLOUD_X86
+
+float minSquaredDistanceSSE(const float* xs, const float* ys, const float* zs, size_t padded_count,
+                            float px, float py, float pz) {
+    const __m128 x = _mm_set1_ps(px);
+    const __m128 y = _mm_set1_ps(py);
+    const __m128 z = _mm_set1_ps(pz);
+    // Two accumulators hide the latency of the min chain
+    __m128 best0 = _mm_set1_ps(std::numeric_limits<float>::max());
+    __m128 best1 = best0;
+    
+    for (size_t i = 0; i < padded_count; i += 8) {
+        __m128 dx0 = _mm_sub_ps(_mm_loadu_ps(xs + i), x);
+        __m128 dy0 = _mm_sub_ps(_mm_loadu_ps(ys + i), y);
+        __m128 dz0 = _mm_sub_ps(_mm_loadu_ps(zs + i), z);
+        __m128 dx1 = _mm_sub_ps(_mm_loadu_ps(xs + i + 4), x);
+        __m128 dy1 = _mm_sub_ps(_mm_loadu_ps(ys + i + 4), y);
+        __m128 dz1 = _mm_sub_ps(_mm_loadu_ps(zs + i + 4), z);
+        __m128 d0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx0, dx0), _mm_mul_ps(dy0, dy0)), _mm_mul_ps(dz0, dz0));
+        __m128 d1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx1, dx1), _mm_mul_ps(dy1, dy1)), _mm_mul_ps(dz1, dz1));
+        best0 = _mm_min_ps(best0, d0);
+        best1 = _mm_min_ps(best1, d1);
+    }
+    
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, _mm_min_ps(best0, best1));
+    return std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+}
+
+__attribute__((target("avx2,fma")))
+float minSquaredDistanceAVX2(const float* xs, const float* ys, const float* zs, size_t padded_count,
+                             float px, float py, float pz) {
+    const __m256 x = _mm256_set1_ps(px);
+    const __m256 y = _mm256_set1_ps(py);
+    const __m256 z = _mm256_set1_ps(pz);
+    __m256 best0 = _mm256_set1_ps(std::numeric_limits<float>::max());
+    __m256 best1 = best0;
+    
+    size_t i = 0;
+    for (; i + 16 <= padded_count; i += 16) {
+        __m256 dx0 = _mm256_sub_ps(_mm256_loadu_ps(xs + i), x);
+        __m256 dy0 = _mm256_sub_ps(_mm256_loadu_ps(ys + i), y);
+        __m256 dz0 = _mm256_sub_ps(_mm256_loadu_ps(zs + i), z);
+        __m256 dx1 = _mm256_sub_ps(_mm256_loadu_ps(xs + i + 8), x);
+        __m256 dy1 = _mm256_sub_ps(_mm256_loadu_ps(ys + i + 8), y);
+        __m256 dz1 = _mm256_sub_ps(_mm256_loadu_ps(zs + i + 8), z);
+        __m256 d0 = _mm256_fmadd_ps(dz0, dz0, _mm256_fmadd_ps(dy0, dy0, _mm256_mul_ps(dx0, dx0)));
+        __m256 d1 = _mm256_fmadd_ps(dz1, dz1, _mm256_fmadd_ps(dy1, dy1, _mm256_mul_ps(dx1, dx1)));
+        best0 = _mm256_min_ps(best0, d0);
+        best1 = _mm256_min_ps(best1, d1);
+    }
+    for (; i < padded_count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(xs + i), x);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ys + i), y);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(zs + i), z);
+        best0 = _mm256_min_ps(best0, _mm256_fmadd_ps(dz, dz, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dx, dx))));
+    }
+    
+    __m256 best = _mm256_min_ps(best0, best1);
+    __m128 half = _mm_min_ps(_mm256_castps256_ps128(best), _mm256_extractf128_ps(best, 1));
+    half = _mm_min_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_min_ss(half, _mm_shuffle_ps(half, half, 1));
+    return _mm_cvtss_f32(half);
+}
+
+#endif // OBSTACLE_CLOUD_X86
+
+DistanceKernel detectKernel() {
+#ifdef OBSTACLE_CLOUD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return DistanceKernel::AVX2;
+    return DistanceKernel::SSE;
+#else
+    return DistanceKernel::Scalar;
+#endif
+}
+
+MinSquaredDistanceKernel kernelFunction(DistanceKernel kernel) {
+#ifdef OBSTACLE_CLOUD_X86
+    if (kernel == DistanceKernel::AVX2) return minSquaredDistanceAVX2;
+    if (kernel == DistanceKernel::SSE) return minSquaredDistanceSSE;
+#endif
+    (void)kernel;
+    return minSquaredDistanceScalar;
+}
+
+} // namespace
+
+const char* distanceKernelName(DistanceKernel kernel) {
+    switch (kernel) {
+        case DistanceKernel::AVX2: return "AVX2";
+        case DistanceKernel::SSE: return "SSE";
+        default: return "Scalar";
+    }
+}
+
+DistanceKernel ObstacleCloudSoA::activeKernel() {
+    static const DistanceKernel kernel = detectKernel();
+    return kernel;
+}
+
+void ObstacleCloudSoA::assign(const std::vector<Eigen::Vector3d>& obstacles) {
+    clear();
+    xs.reserve(obstacles.size() + PADDING);
+    ys.reserve(obstacles.size() + PADDING);
+    zs.reserve(obstacles.size() + PADDING);
+    for (const auto& obstacle : obstacles) {
+        xs.push_back(static_cast<float>(obstacle[0]));
+        ys.push_back(static_cast<float>(obstacle[1]));
+        zs.push_back(static_cast<float>(obstacle[2]));
+    }
+    count = obstacles.size();
+    pad();
+}
+
+void ObstacleCloudSoA::assign(const std::vector<std::vector<double>>& obstacles) {
+    clear();
+    for (const auto& obstacle : obstacles) {
+        if (obstacle.size() != 3) continue;
+        xs.push_back(static_cast<float>(obstacle[0]));
+        ys.push_back(static_cast<float>(obstacle[1]));
+        zs.push_back(static_cast<float>(obstacle[2]));
+    }
+    count = xs.size();
+    pad();
+}
+
+void ObstacleCloudSoA::clear() {
+    xs.clear();
+    ys.clear();
+    zs.clear();
+    count = 0;
+}
+
+void ObstacleCloudSoA::pad() {
+    size_t padded = (count + PADDING - 1) / PADDING * PADDING;
+    const float far_away = std::numeric_limits<float>::infinity();
+    xs.resize(padded, far_away);
+    ys.resize(padded, far_away);
+    zs.resize(padded, far_away);
+}
+
+float ObstacleCloudSoA::minSquaredDistance(const Eigen::Vector3d& point) const {
+    return minSquaredDistance(point, activeKernel());
+}
+
+float ObstacleCloudSoA::minSquaredDistance(const Eigen::Vector3d& point, DistanceKernel kernel) const {
+    if (count == 0) return std::numeric_limits<float>::max();
+    if (kernel == DistanceKernel::AVX2 && activeKernel() != DistanceKernel::AVX2) kernel = activeKernel();
+    
+    return kernelFunction(kernel)(xs.data(), ys.data(), zs.data(), xs.size(),
+                                  static_cast<float>(point[0]), static_cast<float>(point[1]),
+                                  static_cast<float>(point[2]));
+}
+
+double ObstacleCloudSoA::minDistance(const Eigen::Vector3d& point) const {
+    if (count == 0) return std::numeric_limits<double>::max();
+    return std::sqrt(static_cast<double>(minSquaredDistance(point)));
+}
@@ -0,0 +1,51 @@
+#ifndef OBSTACLE_CLOUD_H
+#define OBSTACLE_CLOUD_H
+
+#include <cstddef>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+
+enum class DistanceKernel {
+    Scalar,
+    SSE,
+    AVX2
+};
+
+const char* distanceKernelName(DistanceKernel kernel);
+
+// Structure-of-arrays float copy of an obstacle set for brute-force
+// distance queries. Coordinates are padded to a multiple of the widest
+// SIMD width with +inf so kernels never need a scalar tail. The minimum is
+// reduced on squared distances and the square root taken once at the end.
+// The kernel is picked once at startup from the CPU's features (AVX2+FMA,
+// else SSE, else scalar).
+class ObstacleCloudSoA {
+public:
+    ObstacleCloudSoA() = default;
+    explicit ObstacleCloudSoA(const std::vector<Eigen::Vector3d>& obstacles) { assign(obstacles); }
+
+    void assign(const std::vector<Eigen::Vector3d>& obstacles);
+    // Entries that are not 3-dimensional are skipped
+    void assign(const std::vector<std::vector<double>>& obstacles);
+    void clear();
+
+    // max() for an empty cloud
+    float minSquaredDistance(const Eigen::Vector3d& point) const;
+    float minSquaredDistance(const Eigen::Vector3d& point, DistanceKernel kernel) const;
+    double minDistance(const Eigen::Vector3d& point) const;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    static DistanceKernel activeKernel();
+
+private:
+    void pad();
+
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<float> zs;
+    size_t count = 0;
+};
+
+#endif // OBSTACLE_CLOUD_H
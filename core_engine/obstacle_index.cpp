@@ -0,0 +1,156 @@
+#include "obstacle_index.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+struct ObstacleIndex::BuildEntry {
+    Eigen::Vector3d point;
+    uint32_t id;
+};
+
+void ObstacleIndex::build(const std::vector<Eigen::Vector3d>& obstacles) {
+    std::vector<BuildEntry> entries(obstacles.size());
+    for(size_t i = 0; i < obstacles.size(); ++i) {
+        entries[i] = {obstacles[i], static_cast<uint32_t>(i)};
+    }
+    
+    split_axis.assign(entries.size(), 0);
+    buildRange(entries.data(), 0, entries.size());
+    
+    points.resize(entries.size());
+    original_index.resize(entries.size());
+    for(size_t i = 0; i < entries.size(); ++i) {
+        points[i] = entries[i].point;
+        original_index[i] = entries[i].id;
+    }
+    ++build_generation;
+}
+
+void ObstacleIndex::clear() {
+    points.clear();
+    original_index.clear();
+    split_axis.clear();
+    ++build_generation;
+}
+
+void ObstacleIndex::buildRange(BuildEntry* entries, size_t begin, size_t end) {
+    if(end - begin <= LEAF_SIZE) return;
+    
+    // Split along the axis with the largest extent
+    Eigen::Vector3d low = entries[begin].point;
+    Eigen::Vector3d high = entries[begin].point;
+    for(size_t i = begin + 1; i < end; ++i) {
+        low = low.cwiseMin(entries[i].point);
+        high = high.cwiseMax(entries[i].point);
+    }
+    int axis;
+    (high - low).maxCoeff(&axis);
+    
+    size_t mid = begin + (end - begin) / 2;
+    std::nth_element(entries + begin, entries + mid, entries + end,
+                     [axis](const BuildEntry& a, const BuildEntry& b) { return a.point[axis] < b.point[axis]; });
+    
+    split_axis[mid] = static_cast<uint8_t>(axis);
+    buildRange(entries, begin, mid);
+    buildRange(entries, mid + 1, end);
+}
+
+double ObstacleIndex::nearestDistance(const Eigen::Vector3d& point, size_t* nearest_index) const {
+    double best_distance_sq = std::numeric_limits<double>::max();
+    size_t best = NO_OBSTACLE;
+    nearestInRange(point, 0, points.size(), best_distance_sq, best);
+    
+    if(nearest_index) *nearest_index = best == NO_OBSTACLE ? NO_OBSTACLE : original_index[best];
+    return best == NO_OBSTACLE ? std::numeric_limits<double>::max() : std::sqrt(best_distance_sq);
+}
+
+ObstacleIndex::NearestObstacle ObstacleIndex::nearest(const Eigen::Vector3d& point, double max_distance) const {
+    double best_distance_sq = max_distance < std::sqrt(std::numeric_limits<double>::max())
+                                  ? max_distance * max_distance
+                                  : std::numeric_limits<double>::max();
+    size_t best = NO_OBSTACLE;
+    nearestInRange(point, 0, points.size(), best_distance_sq, best);
+    
+    if(best == NO_OBSTACLE) {
+        return {std::numeric_limits<double>::max(), NO_OBSTACLE, Eigen::Vector3d::Zero()};
+    }
+    return {std::sqrt(best_distance_sq), original_index[best], points[best]};
+}
+
+void ObstacleIndex::nearestInRange(const Eigen::Vector3d& point, size_t begin, size_t end,
+                                   double& best_distance_sq, size_t& best) const {
+    if(end - begin <= LEAF_SIZE) {
+        for(size_t i = begin; i < end; ++i) {
+            double distance_sq = (points[i] - point).squaredNorm();
+            if(distance_sq < best_distance_sq) {
+                best_distance_sq = distance_sq;
+                best = i;
+            }
+        }
+        return;
+    }
+    
+    size_t mid = begin + (end - begin) / 2;
+    double distance_sq = (points[mid] - point).squaredNorm();
+    if(distance_sq < best_distance_sq) {
+        best_distance_sq = distance_sq;
+        best = mid;
+    }
+    
+    double offset = point[split_axis[mid]] - points[mid][split_axis[mid]];
+    if(offset < 0) {
+        nearestInRange(point, begin, mid, best_distance_sq, best);
+        if(offset * offset < best_distance_sq) nearestInRange(point, mid + 1, end, best_distance_sq, best);
+    } else {
+        nearestInRange(point, mid + 1, end, best_distance_sq, best);
+        if(offset * offset < best_distance_sq) nearestInRange(point, begin, mid, best_distance_sq, best);
+    }
+}
+
+size_t ObstacleIndex::radiusSearch(const Eigen::Vector3d& point, double radius, std::vector<size_t>& out) const {
+    out.clear();
+    radiusInRange(point, radius * radius, 0, points.size(), out);
+    return out.size();
+}
+
+void ObstacleIndex::radiusInRange(const Eigen::Vector3d& point, double radius_sq, size_t begin, size_t end,
+                                  std::vector<size_t>& out) const {
+    if(end - begin <= LEAF_SIZE) {
+        for(size_t i = begin; i < end; ++i) {
+            if((points[i] - point).squaredNorm() < radius_sq) out.push_back(original_index[i]);
+        }
+        return;
+    }
+    
+    size_t mid = begin + (end - begin) / 2;
+    if((points[mid] - point).squaredNorm() < radius_sq) out.push_back(original_index[mid]);
+    
+    double offset = point[split_axis[mid]] - points[mid][split_axis[mid]];
+    if(offset < 0 || offset * offset < radius_sq) radiusInRange(point, radius_sq, begin, mid, out);
+    if(offset >= 0 || offset * offset < radius_sq) radiusInRange(point, radius_sq, mid + 1, end, out);
+}
+
+bool ObstacleIndex::anyWithin(const Eigen::Vector3d& point, double radius) const {
+    return anyInRange(point, radius * radius, 0, points.size());
+}
+
+bool ObstacleIndex::anyInRange(const Eigen::Vector3d& point, double radius_sq, size_t begin, size_t end) const {
+    if(end - begin <= LEAF_SIZE) {
+        for(size_t i = begin; i < end; ++i) {
+            if((points[i] - point).squaredNorm() < radius_sq) return true;
+        }
+        return false;
+    }
+    
+    size_t mid = begin + (end - begin) / 2;
+    if((points[mid] - point).squaredNorm() < radius_sq) return true;
+    
+    // Near side first so a violation is usually found on the first descent
+    double offset = point[split_axis[mid]] - points[mid][split_axis[mid]];
+    bool near_low = offset < 0;
+    if(anyInRange(point, radius_sq, near_low ? begin : mid + 1, near_low ? mid : end)) return true;
+    if(offset * offset < radius_sq) {
+        return anyInRange(point, radius_sq, near_low ? mid + 1 : begin, near_low ? end : mid);
+    }
+    return false;
+}
@@ -0,0 +1,67 @@
+#ifndef OBSTACLE_INDEX_H
+#define OBSTACLE_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+
+// Static k-d tree over an obstacle point cloud, rebuilt once per obstacle
+// update. The tree is implicit: points are reordered so that every range
+// [begin, end) is split at its middle element, so it needs no node storage
+// beyond one split axis per point and queries never allocate.
+class ObstacleIndex {
+public:
+    static constexpr size_t NO_OBSTACLE = std::numeric_limits<size_t>::max();
+
+    struct NearestObstacle {
+        double distance;            // max() when nothing was found
+        size_t index;               // build() input index, NO_OBSTACLE when nothing was found
+        Eigen::Vector3d position;
+    };
+
+    ObstacleIndex() = default;
+
+    void build(const std::vector<Eigen::Vector3d>& obstacles);
+    void clear();
+
+    // Distance to the closest obstacle, or max() for an empty index.
+    // nearest_index receives the obstacle's index in the build() input.
+    double nearestDistance(const Eigen::Vector3d& point, size_t* nearest_index = nullptr) const;
+
+    // Nearest obstacle strictly closer than max_distance. A tight bound
+    // prunes the search to the neighbourhood of point.
+    NearestObstacle nearest(const Eigen::Vector3d& point,
+                            double max_distance = std::numeric_limits<double>::max()) const;
+
+    // Appends the input indices of all obstacles within radius to out
+    // (out is cleared first, so callers can reuse its capacity).
+    size_t radiusSearch(const Eigen::Vector3d& point, double radius, std::vector<size_t>& out) const;
+
+    // Early-out test: stops at the first obstacle closer than radius
+    bool anyWithin(const Eigen::Vector3d& point, double radius) const;
+
+    bool empty() const { return points.empty(); }
+    size_t size() const { return points.size(); }
+    // Incremented by every build()/clear() so cached query state can be invalidated
+    uint64_t generation() const { return build_generation; }
+
+private:
+    static constexpr size_t LEAF_SIZE = 8;
+
+    struct BuildEntry;
+    void buildRange(BuildEntry* entries, size_t begin, size_t end);
+    void nearestInRange(const Eigen::Vector3d& point, size_t begin, size_t end,
+                        double& best_distance_sq, size_t& best) const;
+    void radiusInRange(const Eigen::Vector3d& point, double radius_sq, size_t begin, size_t end,
+                       std::vector<size_t>& out) const;
+    bool anyInRange(const Eigen::Vector3d& point, double radius_sq, size_t begin, size_t end) const;
+
+    std::vector<Eigen::Vector3d> points;    // reordered into k-d order
+    std::vector<uint32_t> original_index;   // k-d order -> build() input index
+    std::vector<uint8_t> split_axis;        // split axis of the range whose middle is i
+    uint64_t build_generation = 0;
+};
+
+#endif // OBSTACLE_INDEX_H
@@ -0,0 +1,212 @@
+#include "parameter_store.h"
+#include "async_logger.h"
+#include <sys/stat.h>
+
+namespace {
+
+const LogSite PARAMETERS_PUBLISHED{LogLevel::Info, "ParameterStore", "Parameters version {} published"};
+const LogSite PARAMETERS_KEPT{LogLevel::Warning, "ParameterStore", "Reload failed, keeping parameters version {}"};
+const LogSite NO_READER_SLOT{LogLevel::Error, "ParameterStore", "All {} reader slots in use"};
+
+int64_t modificationTimeNs(const std::string& path) {
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) return -1;
+    return static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+}
+
+} // namespace
+
+bool ParameterReader::attach(ParameterStore& target) {
+    detach();
+    slot = target.acquireSlot();
+    if (!slot) return false;
+    store = &target;
+    return true;
+}
+
+void ParameterReader::detach() {
+    if (!slot) return;
+    store->releaseSlot(slot);
+    slot = nullptr;
+    store = nullptr;
+}
+
+ParameterPin::ParameterPin(ParameterStore* store, const RobotParameters& fallback)
+    : slot(nullptr), block(&fallback) {
+    if (!store) return;
+    for (int attempt = 0; attempt < PIN_ATTEMPTS && !slot; ++attempt) slot = store->tryPinSlot();
+    if (!slot) {
+        // The writer mutex is only held for short, bounded sections
+        logMessage(NO_READER_SLOT, ParameterStore::MAX_READERS);
+        copy = store->snapshot();
+        block = &copy;
+        return;
+    }
+    // Sequentially consistent with the writer's swap and slot scan: either
+    // the scan sees this slot online or this load sees the new block
+    block = store->current.load(std::memory_order_seq_cst);
+}
+
+ParameterPin::~ParameterPin() {
+    if (slot) slot->store(ParameterStore::OFFLINE, std::memory_order_release);
+}
+
+ParameterStore::ParameterStore(const RobotParameters& initial)
+    : grace_period(1), version(1), safety_json_mtime_ns(-1), robot_yaml_mtime_ns(-1), watch_stopping(false) {
+    RobotParameters* block = new RobotParameters(initial);
+    block->version = 1;
+    current.store(block, std::memory_order_release);
+}
+
+ParameterStore::~ParameterStore() {
+    stopWatching();
+    delete current.load(std::memory_order_acquire);
+    for (const RetiredBlock& entry : retired) delete entry.block;
+}
+
+std::atomic<uint64_t>* ParameterStore::acquireSlot() {
+    // Under the writer mutex, so no retirement can slip between the
+    // reader going online and the writer's scan of the slots
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    std::atomic<uint64_t>* slot = tryPinSlot();
+    if (!slot) logMessage(NO_READER_SLOT, MAX_READERS);
+    return slot;
+}
+
+std::atomic<uint64_t>* ParameterStore::tryPinSlot() {
+    // Slots are also claimed by ParameterPin without the writer mutex
+    for (ReaderSlot& entry : slots) {
+        uint64_t expected = OFFLINE;
+        if (entry.seen.load(std::memory_order_relaxed) == OFFLINE &&
+            entry.seen.compare_exchange_strong(expected, grace_period.load(std::memory_order_seq_cst),
+                                               std::memory_order_seq_cst)) {
+            return &entry.seen;
+        }
+    }
+    return nullptr;
+}
+
+void ParameterStore::releaseSlot(std::atomic<uint64_t>* slot) {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    slot->store(OFFLINE, std::memory_order_release);
+    reclaimLocked();
+}
+
+uint64_t ParameterStore::publish(const RobotParameters& parameters) {
+    RobotParameters* block = new RobotParameters(parameters);
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    block->version = version.load(std::memory_order_relaxed) + 1;
+    const RobotParameters* previous = current.exchange(block, std::memory_order_seq_cst);
+    version.store(block->version, std::memory_order_release);
+    // Release: a reader that sees the new grace period also sees the new block
+    uint64_t period = grace_period.fetch_add(1, std::memory_order_acq_rel) + 1;
+    retired.push_back(RetiredBlock{previous, period});
+    reclaimLocked();
+    logMessage(PARAMETERS_PUBLISHED, block->version);
+    return block->version;
+}
+
+bool ParameterStore::reload(const std::string& safety_json, const std::string& robot_yaml) {
+    int64_t safety_mtime = modificationTimeNs(safety_json);
+    int64_t robot_mtime = modificationTimeNs(robot_yaml);
+    RobotParameters parameters = snapshot();
+    bool loaded = loadRobotParameters(safety_json, robot_yaml, parameters);
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        safety_json_path = safety_json;
+        robot_yaml_path = robot_yaml;
+        // A rejected file is not retried until it changes again
+        safety_json_mtime_ns = safety_mtime;
+        robot_yaml_mtime_ns = robot_mtime;
+    }
+    if (!loaded) {
+        logMessage(PARAMETERS_KEPT, getVersion());
+        return false;
+    }
+    publish(parameters);
+    return true;
+}
+
+bool ParameterStore::reloadIfChanged() {
+    std::string safety_json, robot_yaml;
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        if (safety_json_path.empty()) return false;
+        if (modificationTimeNs(safety_json_path) == safety_json_mtime_ns &&
+            modificationTimeNs(robot_yaml_path) == robot_yaml_mtime_ns) {
+            return false;
+        }
+        safety_json = safety_json_path;
+        robot_yaml = robot_yaml_path;
+    }
+    return reload(safety_json, robot_yaml);
+}
+
+bool ParameterStore::startWatching(std::chrono::milliseconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        if (safety_json_path.empty()) return false;
+    }
+    if (watch_thread.joinable() || interval.count() <= 0) return false;
+    watch_stopping = false;
+    watch_thread = std::thread(&ParameterStore::watchLoop, this, interval);
+    return true;
+}
+
+void ParameterStore::stopWatching() {
+    {
+        std::lock_guard<std::mutex> lock(watch_mutex);
+        watch_stopping = true;
+    }
+    watch_wake.notify_all();
+    if (watch_thread.joinable()) watch_thread.join();
+}
+
+void ParameterStore::watchLoop(std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lock(watch_mutex);
+    while (!watch_stopping) {
+        auto next = std::chrono::steady_clock::now() + interval;
+        while (!watch_stopping && std::chrono::steady_clock::now() < next) {
+            watch_wake.wait_for(lock, next - std::chrono::steady_clock::now());
+        }
+        if (watch_stopping) break;
+        lock.unlock();
+        reloadIfChanged();
+        reclaim();
+        lock.lock();
+    }
+}
+
+RobotParameters ParameterStore::snapshot() const {
+    // Blocks are only freed under the writer mutex
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    return *current.load(std::memory_order_acquire);
+}
+
+size_t ParameterStore::getRetiredCount() const {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    return retired.size();
+}
+
+void ParameterStore::reclaim() {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    reclaimLocked();
+}
+
+void ParameterStore::reclaimLocked() {
+    if (retired.empty()) return;
+    uint64_t oldest_seen = grace_period.load(std::memory_order_acquire);
+    for (const ReaderSlot& entry : slots) {
+        uint64_t seen = entry.seen.load(std::memory_order_seq_cst);
+        if (seen != OFFLINE && seen < oldest_seen) oldest_seen = seen;
+    }
+    size_t kept = 0;
+    for (const RetiredBlock& entry : retired) {
+        if (entry.grace_period <= oldest_seen) {
+            delete entry.block;
+        } else {
+            retired[kept++] = entry;
+        }
+    }
+    retired.resize(kept);
+}
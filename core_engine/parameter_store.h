@@ -0,0 +1,165 @@
+#ifndef PARAMETER_STORE_H
+#define PARAMETER_STORE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "robot_parameters.h"
+
+class ParameterStore;
+
+// Read side of a ParameterStore, one per thread (or per object whose calls
+// are already serialized). get() is a single acquire load; quiescent()
+// tells the store that no block obtained before it is still in use, which
+// is what lets replaced blocks be freed. Neither takes a lock, allocates
+// or waits on the writer. A reader that stops calling quiescent() only
+// delays reclamation.
+class ParameterReader {
+public:
+    ParameterReader() : store(nullptr), slot(nullptr) {}
+    explicit ParameterReader(ParameterStore& store) : store(nullptr), slot(nullptr) { attach(store); }
+    ~ParameterReader() { detach(); }
+
+    ParameterReader(const ParameterReader&) = delete;
+    ParameterReader& operator=(const ParameterReader&) = delete;
+
+    // False when the store has no free reader slot. Not for the control loop.
+    bool attach(ParameterStore& store);
+    void detach();
+    bool isAttached() const { return slot != nullptr; }
+
+    // Newest published block; valid until this reader's next quiescent() or detach()
+    inline const RobotParameters& get() const;
+    inline void quiescent();
+
+private:
+    ParameterStore* store;
+    std::atomic<uint64_t>* slot;
+};
+
+// Pins the current block for one short read by a thread that has no
+// ParameterReader of its own. Claiming a reader slot is a compare-and-swap,
+// so neither the constructor nor the destructor takes a lock; the slot goes
+// offline again on destruction and never delays reclamation afterwards.
+// When every slot stays taken for PIN_ATTEMPTS passes the pin copies the
+// current block instead of waiting for a slot. Without a store the
+// fallback is used.
+class ParameterPin {
+public:
+    static constexpr int PIN_ATTEMPTS = 4;
+
+    ParameterPin(ParameterStore* store, const RobotParameters& fallback);
+    ~ParameterPin();
+
+    ParameterPin(const ParameterPin&) = delete;
+    ParameterPin& operator=(const ParameterPin&) = delete;
+
+    const RobotParameters& get() const { return *block; }
+
+private:
+    std::atomic<uint64_t>* slot;
+    const RobotParameters* block;
+    RobotParameters copy;               // owned block when no slot was free
+};
+
+// Publishes immutable RobotParameters blocks to the control loop.
+//
+// The current block is reached through one atomic pointer. publish() copies
+// the new values into a fresh block, swaps the pointer and retires the old
+// block; readers pick the new one up on their next get(), so a limit change
+// takes effect on the next cycle without stopping the loop. Reclamation is
+// quiescent-state based: each retirement bumps a grace-period counter, and
+// a retired block is freed once every attached reader has announced a
+// quiescent state after it. Writers serialize on a mutex readers never see.
+class ParameterStore {
+public:
+    static constexpr size_t MAX_READERS = 16;
+
+    explicit ParameterStore(const RobotParameters& initial = defaultRobotParameters());
+    // Readers must be detached first
+    ~ParameterStore();
+
+    ParameterStore(const ParameterStore&) = delete;
+    ParameterStore& operator=(const ParameterStore&) = delete;
+
+    // Returns the version given to the new block
+    uint64_t publish(const RobotParameters& parameters);
+    // Parses both files on top of the current block and publishes the
+    // result; an unreadable or invalid file keeps the current block.
+    // Remembers the paths for reloadIfChanged().
+    bool reload(const std::string& safety_json_path, const std::string& robot_yaml_path);
+    // Reloads when either file changed since the last reload(). True only
+    // when a new block was published.
+    bool reloadIfChanged();
+
+    // Polls the files every interval on a background thread, which also
+    // frees retired blocks. Needs a successful reload() first.
+    bool startWatching(std::chrono::milliseconds interval);
+    void stopWatching();
+
+    // Copy of the current block for code outside the read path
+    RobotParameters snapshot() const;
+    uint64_t getVersion() const { return version.load(std::memory_order_acquire); }
+    // Blocks replaced but still waiting for a reader's quiescent state
+    size_t getRetiredCount() const;
+    // Frees the retired blocks no reader can still hold; publish() does this too
+    void reclaim();
+
+private:
+    friend class ParameterReader;
+    friend class ParameterPin;
+
+    static constexpr uint64_t OFFLINE = 0;
+
+    struct RetiredBlock {
+        const RobotParameters* block;
+        uint64_t grace_period;          // free once every reader has seen this
+    };
+
+    std::atomic<uint64_t>* acquireSlot();
+    void releaseSlot(std::atomic<uint64_t>* slot);
+    // Lock-free claim of a free slot, nullptr when all are taken
+    std::atomic<uint64_t>* tryPinSlot();
+    void reclaimLocked();
+    void watchLoop(std::chrono::milliseconds interval);
+
+    std::atomic<const RobotParameters*> current;
+    std::atomic<uint64_t> grace_period;
+    std::atomic<uint64_t> version;
+    // Grace period each reader last announced, OFFLINE for a free slot
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> seen{OFFLINE};
+    };
+    std::array<ReaderSlot, MAX_READERS> slots;
+
+    mutable std::mutex writer_mutex;
+    std::vector<RetiredBlock> retired;
+    std::string safety_json_path;
+    std::string robot_yaml_path;
+    int64_t safety_json_mtime_ns;
+    int64_t robot_yaml_mtime_ns;
+
+    std::thread watch_thread;
+    std::mutex watch_mutex;
+    std::condition_variable watch_wake;
+    bool watch_stopping;
+};
+
+inline const RobotParameters& ParameterReader::get() const {
+    return *store->current.load(std::memory_order_acquire);
+}
+
+inline void ParameterReader::quiescent() {
+    // Release: every read of an earlier block happens before the writer
+    // sees this grace period and frees it
+    slot->store(store->grace_period.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+#endif // PARAMETER_STORE_H
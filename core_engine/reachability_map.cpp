@@ -0,0 +1,186 @@
+#include "reachability_map.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+
+namespace {
+
+const char CACHE_MAGIC[4] = {'R', 'M', 'A', 'P'};
+const uint32_t CACHE_VERSION = 2;     // 2: per-voxel minimum, eroded boundary
+
+} // namespace
+
+ReachabilityMap::ReachabilityMap()
+    : origin(Eigen::Vector3d::Zero()), voxel_size(0.0), inverse_voxel_size(0.0), dims{0, 0, 0} {
+}
+
+std::vector<double> ReachabilityMap::flattenDH(const Kinematics<DOF>& kinematics) {
+    std::vector<double> signature;
+    for(const auto& link : kinematics.dhParameters()) {
+        signature.insert(signature.end(), {link.theta_offset, link.alpha, link.a, link.d});
+    }
+    const auto& base = kinematics.baseTranslation();
+    signature.insert(signature.end(), {base[0], base[1], base[2]});
+    return signature;
+}
+
+void ReachabilityMap::build(const Kinematics<DOF>& kinematics, const ReachabilityMapOptions& options) {
+    voxel_size = options.voxel_size;
+    inverse_voxel_size = 1.0 / voxel_size;
+    dh_signature = flattenDH(kinematics);
+    
+    // Cube of side 2 * reach around the base, padded by one voxel
+    double reach = kinematics.maxReach() + voxel_size;
+    origin = kinematics.baseTranslation() - Eigen::Vector3d::Constant(reach);
+    int side = static_cast<int>(std::ceil(2.0 * reach * inverse_voxel_size));
+    dims[0] = dims[1] = dims[2] = side;
+    voxels.assign(static_cast<size_t>(side) * side * side, std::numeric_limits<float>::infinity());
+    
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<double> joint_distribution(options.joint_min, options.joint_max);
+    
+    Kinematics<DOF>::JointVector joint_angles;
+    Kinematics<DOF>::Transform pose;
+    Kinematics<DOF>::Jacobian jacobian;
+    
+    for(size_t sample = 0; sample < options.samples; ++sample) {
+        for(double& angle : joint_angles) angle = joint_distribution(rng);
+        if(kinematics.forwardPoseAndJacobian(joint_angles, pose, jacobian) != KinematicsStatus::Ok) continue;
+        
+        size_t index;
+        if(!voxelIndex(pose.block<3,1>(0,3), index)) continue;
+        
+        Eigen::Matrix3d linear = jacobian.topRows<3>() * jacobian.topRows<3>().transpose();
+        // Keep reached voxels non-zero even at singular configurations
+        float measure = std::max(static_cast<float>(std::sqrt(std::max(0.0, linear.determinant()))),
+                                 std::numeric_limits<float>::min());
+        voxels[index] = std::min(voxels[index], measure);
+    }
+    for(float& voxel : voxels) {
+        if(std::isinf(voxel)) voxel = 0.0f;
+    }
+    markBoundary();
+}
+
+void ReachabilityMap::markBoundary() {
+    const size_t stride[3] = {1, static_cast<size_t>(dims[0]), static_cast<size_t>(dims[0]) * dims[1]};
+    std::vector<uint8_t> boundary(voxels.size(), 0);
+    size_t index = 0;
+    for(int z = 0; z < dims[2]; ++z) {
+        for(int y = 0; y < dims[1]; ++y) {
+            for(int x = 0; x < dims[0]; ++x, ++index) {
+                if(voxels[index] <= 0.0f) continue;
+                const int cell[3] = {x, y, z};
+                for(int axis = 0; axis < 3 && !boundary[index]; ++axis) {
+                    boundary[index] = cell[axis] == 0 || cell[axis] == dims[axis] - 1 ||
+                                      voxels[index - stride[axis]] <= 0.0f || voxels[index + stride[axis]] <= 0.0f;
+                }
+            }
+        }
+    }
+    for(size_t i = 0; i < voxels.size(); ++i) {
+        if(boundary[i]) voxels[i] = -voxels[i];
+    }
+}
+
+bool ReachabilityMap::voxelIndex(const Eigen::Vector3d& position, size_t& index) const {
+    if(voxels.empty()) return false;
+    
+    Eigen::Vector3d cell = (position - origin) * inverse_voxel_size;
+    int ix = static_cast<int>(std::floor(cell[0]));
+    int iy = static_cast<int>(std::floor(cell[1]));
+    int iz = static_cast<int>(std::floor(cell[2]));
+    if(ix < 0 || iy < 0 || iz < 0 || ix >= dims[0] || iy >= dims[1] || iz >= dims[2]) return false;
+    
+    index = (static_cast<size_t>(iz) * dims[1] + iy) * dims[0] + ix;
+    return true;
+}
+
+VoxelReach ReachabilityMap::classify(const Eigen::Vector3d& position) const {
+    size_t index;
+    if(!position.allFinite() || !voxelIndex(position, index)) return VoxelReach::Unreachable;
+    if(voxels[index] > 0.0f) return VoxelReach::Interior;
+    return voxels[index] < 0.0f ? VoxelReach::Boundary : VoxelReach::Unreachable;
+}
+
+float ReachabilityMap::manipulability(const Eigen::Vector3d& position) const {
+    size_t index;
+    if(!position.allFinite() || !voxelIndex(position, index)) return 0.0f;
+    return std::max(voxels[index], 0.0f);
+}
+
+size_t ReachabilityMap::getReachedVoxelCount() const {
+    return static_cast<size_t>(std::count_if(voxels.begin(), voxels.end(), [](float v) { return v != 0.0f; }));
+}
+
+bool ReachabilityMap::save(const std::string& path) const {
+    if(voxels.empty()) return false;
+    
+    std::ofstream file(path, std::ios::binary);
+    if(!file) return false;
+    
+    uint32_t signature_size = static_cast<uint32_t>(dh_signature.size());
+    file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&CACHE_VERSION), sizeof(CACHE_VERSION));
+    file.write(reinterpret_cast<const char*>(&signature_size), sizeof(signature_size));
+    file.write(reinterpret_cast<const char*>(dh_signature.data()), signature_size * sizeof(double));
+    file.write(reinterpret_cast<const char*>(origin.data()), 3 * sizeof(double));
+    file.write(reinterpret_cast<const char*>(&voxel_size), sizeof(voxel_size));
+    file.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    file.write(reinterpret_cast<const char*>(voxels.data()), voxels.size() * sizeof(float));
+    return static_cast<bool>(file);
+}
+
+bool ReachabilityMap::load(const std::string& path, const Kinematics<DOF>& kinematics) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file) return false;
+    
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t signature_size = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&signature_size), sizeof(signature_size));
+    if(!file || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0 || version != CACHE_VERSION) return false;
+    
+    // Sizes are checked before anything is allocated from them
+    std::vector<double> expected_signature = flattenDH(kinematics);
+    if(signature_size != expected_signature.size()) return false;
+    std::vector<double> signature(signature_size);
+    file.read(reinterpret_cast<char*>(signature.data()), signature_size * sizeof(double));
+    if(!file || signature != expected_signature) return false;
+    
+    Eigen::Vector3d loaded_origin;
+    double loaded_voxel_size = 0.0;
+    int loaded_dims[3];
+    file.read(reinterpret_cast<char*>(loaded_origin.data()), 3 * sizeof(double));
+    file.read(reinterpret_cast<char*>(&loaded_voxel_size), sizeof(loaded_voxel_size));
+    file.read(reinterpret_cast<char*>(loaded_dims), sizeof(loaded_dims));
+    if(!file || !(loaded_voxel_size > 0.0) || !loaded_origin.allFinite()) return false;
+    size_t voxel_count = 1;
+    for(int axis = 0; axis < 3; ++axis) {
+        if(loaded_dims[axis] <= 0 || static_cast<size_t>(loaded_dims[axis]) > MAX_VOXELS) return false;
+        voxel_count *= static_cast<size_t>(loaded_dims[axis]);
+        if(voxel_count > MAX_VOXELS) return false;
+    }
+    std::streamoff header_end = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff file_end = file.tellg();
+    if(header_end < 0 || file_end - header_end != static_cast<std::streamoff>(voxel_count * sizeof(float))) return false;
+    file.seekg(header_end);
+    
+    std::vector<float> loaded_voxels(voxel_count);
+    file.read(reinterpret_cast<char*>(loaded_voxels.data()), loaded_voxels.size() * sizeof(float));
+    if(!file) return false;
+    
+    origin = loaded_origin;
+    voxel_size = loaded_voxel_size;
+    inverse_voxel_size = 1.0 / voxel_size;
+    std::copy(loaded_dims, loaded_dims + 3, dims);
+    voxels = std::move(loaded_voxels);
+    dh_signature = std::move(signature);
+    return true;
+}
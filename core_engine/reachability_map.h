@@ -0,0 +1,67 @@
+#ifndef REACHABILITY_MAP_H
+#define REACHABILITY_MAP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "kinematics.h"
+
+struct ReachabilityMapOptions {
+    double voxel_size = 0.02;           // metres
+    size_t samples = 500000;            // random joint-space samples
+    double joint_min = -M_PI;
+    double joint_max = M_PI;
+    uint32_t seed = 42;
+};
+
+enum class VoxelReach : uint8_t {
+    Unreachable = 0,    // no sample landed in the voxel
+    Boundary,           // reached, but next to an unreached voxel: only part of it may be reachable
+    Interior            // reached, and so are its six face neighbours
+};
+
+// Voxel grid over the arm's workspace, built once by sampling joint space.
+// Each voxel stores the smallest position manipulability sqrt(det(Jp Jp^T))
+// seen among the samples that landed in it. The map is conservative:
+// reachable voxels are eroded by one voxel, so only Interior voxels count
+// as reachable and report a manipulability; Boundary voxels answer 0 and
+// need an exact check (RoboticsKinematics runs IK for them). Lookups are a
+// single array access.
+class ReachabilityMap {
+public:
+    static constexpr int DOF = 6;
+    // load() refuses larger grids, ~256 MB of voxels
+    static constexpr size_t MAX_VOXELS = size_t(1) << 26;
+
+    ReachabilityMap();
+
+    void build(const Kinematics<DOF>& kinematics, const ReachabilityMapOptions& options = ReachabilityMapOptions());
+
+    // Binary cache. load() rejects files built for different DH parameters.
+    bool save(const std::string& path) const;
+    bool load(const std::string& path, const Kinematics<DOF>& kinematics);
+
+    bool isReachable(const Eigen::Vector3d& position) const { return classify(position) == VoxelReach::Interior; }
+    VoxelReach classify(const Eigen::Vector3d& position) const;
+    // Sampled minimum for Interior voxels, 0 elsewhere
+    float manipulability(const Eigen::Vector3d& position) const;
+
+    bool empty() const { return voxels.empty(); }
+    double getVoxelSize() const { return voxel_size; }
+    size_t getReachedVoxelCount() const;
+
+private:
+    bool voxelIndex(const Eigen::Vector3d& position, size_t& index) const;
+    void markBoundary();
+    static std::vector<double> flattenDH(const Kinematics<DOF>& kinematics);
+
+    Eigen::Vector3d origin;             // minimum corner of the grid
+    double voxel_size;
+    double inverse_voxel_size;
+    int dims[3];
+    std::vector<float> voxels;          // x-fastest layout; negated for Boundary voxels, 0 unreached
+    std::vector<double> dh_signature;
+};
+
+#endif // REACHABILITY_MAP_H
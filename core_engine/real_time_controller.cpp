@@ -1,21 +1,157 @@
 #include "real_time_controller.h"
-#include <iostream>
+#include "async_logger.h"
+#include "flight_recorder.h"
+#include "parameter_store.h"
+#include "safety_monitor.h"
 #include <chrono>
 #include <thread>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <algorithm>
 
-RealTimeController::RealTimeController() : is_running(false), control_frequency(1000) {
-    std::cout << "RealTimeController initialized with " << control_frequency << "Hz frequency" << std::endl;
+namespace {
+
+const LogSite CONTROLLER_INITIALIZED{LogLevel::Info, "RealTimeController", "RealTimeController initialized with {}Hz frequency"};
+const LogSite LOOP_ALREADY_RUNNING{LogLevel::Warning, "RealTimeController", "Control loop already running"};
+const LogSite LOOP_STARTED{LogLevel::Info, "RealTimeController", "Control loop started"};
+const LogSite LOOP_STOPPED{LogLevel::Info, "RealTimeController", "Control loop stopped"};
+const LogSite TIMING_VIOLATION{LogLevel::Warning, "RealTimeController", "⚠️  Control loop timing violation: {}μs"};
+const LogSite CYCLE_COMPLETED{LogLevel::Info, "RealTimeController", "Control cycle {} completed"};
+const LogSite FREQUENCY_SET{LogLevel::Info, "RealTimeController", "Control frequency set to {}Hz"};
+const LogSite INVALID_FREQUENCY{LogLevel::Error, "RealTimeController", "Invalid control frequency: {}Hz"};
+const LogSite FIFO_UNAVAILABLE{LogLevel::Warning, "RealTimeController", "SCHED_FIFO priority {} unavailable ({}), using default scheduling"};
+const LogSite AFFINITY_UNAVAILABLE{LogLevel::Warning, "RealTimeController", "Cannot pin control thread to CPU {} ({})"};
+const LogSite MLOCK_UNAVAILABLE{LogLevel::Warning, "RealTimeController", "mlockall failed ({}), memory may page-fault"};
+const LogSite INVALID_RATE_GROUP{LogLevel::Error, "RealTimeController", "Rejected rate group '{}': {}"};
+const LogSite RATE_GROUP_OVERRUN{LogLevel::Warning, "RealTimeController", "Rate group '{}' overran its budget: {}us"};
+const LogSite REALTIME_MODE{LogLevel::Info, "RealTimeController", "Real-time mode: absolute deadlines, fifo {}, cpu pinned {}, memory locked {}"};
+
+constexpr int64_t NANOSECONDS_PER_SECOND = 1000000000;
+
+int64_t toNanoseconds(const timespec& time) {
+    return static_cast<int64_t>(time.tv_sec) * NANOSECONDS_PER_SECOND + time.tv_nsec;
+}
+
+timespec toTimespec(int64_t nanoseconds) {
+    timespec time;
+    time.tv_sec = static_cast<time_t>(nanoseconds / NANOSECONDS_PER_SECOND);
+    time.tv_nsec = static_cast<long>(nanoseconds % NANOSECONDS_PER_SECOND);
+    return time;
+}
+
+int64_t monotonicNanoseconds() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return toNanoseconds(now);
+}
+
+// Idle strategy for the pipeline stage threads: spin briefly for the next
+// frame (it is normally a fraction of a period away), then yield the core
+void waitForFrame(unsigned& idle_polls) {
+    if (++idle_polls < 256) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+// Touches size bytes of fresh stack so later growth within it never faults
+__attribute__((noinline)) void prefaultStack(size_t size) {
+    constexpr size_t CHUNK = 16 * 1024;
+    unsigned char chunk[CHUNK];
+    std::memset(chunk, 0, CHUNK);
+    asm volatile("" : : "r"(chunk) : "memory");     // keep the writes
+    if (size > CHUNK) prefaultStack(size - CHUNK);
+}
+
+} // namespace
+
+struct RealTimeController::RateGroup {
+    RateGroupConfig config;
+    std::function<void()> task;
+    int64_t period_ns = 0;
+    int64_t overrun_ns = 0;             // budget, or the period when no budget is set
+    std::atomic<uint64_t> runs{0};
+    std::atomic<uint64_t> overruns{0};
+    std::atomic<uint64_t> skipped{0};
+    LatencyHistogram latency;
+    std::thread worker;
+    
+    void recordRun(int64_t duration_ns) {
+        latency.record(static_cast<uint64_t>(duration_ns));
+        runs.fetch_add(1, std::memory_order_relaxed);
+        if (duration_ns > overrun_ns) {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            logMessage(RATE_GROUP_OVERRUN, config.name, duration_ns / 1000);
+        }
+    }
+};
+
+const char* controlPhaseName(ControlPhase phase) {
+    switch (phase) {
+        case ControlPhase::ReadSensors: return "read_sensors";
+        case ControlPhase::SafetyChecks: return "safety_checks";
+        case ControlPhase::SendCommands: return "send_commands";
+        case ControlPhase::FullCycle: return "full_cycle";
+        case ControlPhase::WakeupJitter: return "wakeup_jitter";
+        case ControlPhase::SensorToCommand: return "sensor_to_command";
+        default: return "unknown";
+    }
+}
+
+RealTimeController::RealTimeController()
+    : is_running(false), control_frequency(1000), cycle_count(0),
+      realtime_status{false, false, false, false, false},
+      cycle_state{}, safety_monitor(nullptr), flight_recorder(nullptr), cycle_parameters(nullptr),
+      base_epoch_ns(0), current_tick(0), cycle_deadline_ns(0) {
+    resetTimingStats();
+    logMessage(CONTROLLER_INITIALIZED, control_frequency);
 }
 
 void RealTimeController::startControlLoop() {
     if (is_running) {
-        std::cout << "Control loop already running" << std::endl;
+        logMessage(LOOP_ALREADY_RUNNING);
         return;
     }
     
     is_running = true;
-    control_thread = std::thread(&RealTimeController::controlLoop, this);
-    std::cout << "Control loop started" << std::endl;
+    const int64_t base_period_ns = basePeriodNanoseconds();
+    phase_latency[static_cast<size_t>(ControlPhase::FullCycle)].setOverrunThreshold(
+        static_cast<uint64_t>(base_period_ns));
+    
+    inline_groups.clear();
+    for (auto& group : rate_groups) {
+        group->period_ns = base_period_ns * group->config.divisor;
+        group->overrun_ns = group->config.budget_ns > 0 ? group->config.budget_ns : group->period_ns;
+        if (!group->config.secondary_thread) inline_groups.push_back(group.get());
+    }
+    std::stable_sort(inline_groups.begin(), inline_groups.end(), [](const RateGroup* a, const RateGroup* b) {
+        return a->config.priority > b->config.priority;
+    });
+    
+    // Every loop and secondary group releases on the grid starting here
+    base_epoch_ns = monotonicNanoseconds() + base_period_ns;
+    std::promise<void> started;
+    std::future<void> ready = started.get_future();
+    control_thread = std::thread(&RealTimeController::controlLoop, this, &started);
+    ready.wait();
+    
+    for (auto& group : rate_groups) {
+        if (group->config.secondary_thread) {
+            group->worker = std::thread(&RealTimeController::secondaryGroupLoop, this, group.get());
+        }
+    }
+    if (pipeline_options.mode == PipelineMode::Pipelined) {
+        safety_check_thread = std::thread(&RealTimeController::safetyCheckStageLoop, this);
+        command_thread = std::thread(&RealTimeController::commandStageLoop, this);
+    }
+    logMessage(LOOP_STARTED);
 }
 
 void RealTimeController::stopControlLoop() {
@@ -23,72 +159,456 @@ void RealTimeController::stopControlLoop() {
     if (control_thread.joinable()) {
         control_thread.join();
     }
-    std::cout << "Control loop stopped" << std::endl;
+    for (auto& group : rate_groups) {
+        if (group->worker.joinable()) group->worker.join();
+    }
+    if (safety_check_thread.joinable()) safety_check_thread.join();
+    if (command_thread.joinable()) command_thread.join();
+    logMessage(LOOP_STOPPED);
 }
 
-void RealTimeController::controlLoop() {
+void RealTimeController::controlLoop(std::promise<void>* started) {
+    if (realtime_options.enabled) {
+        applyRealTimeSettings();
+        started->set_value();
+        controlLoopAbsolute();
+        return;
+    }
+    
+    realtime_status = RealTimeStatus{false, false, false, false, false};
+    started->set_value();
     auto control_interval = std::chrono::microseconds(1000000 / control_frequency);
+    auto release = std::chrono::steady_clock::now();
     
     while (is_running) {
-        auto loop_start = std::chrono::high_resolution_clock::now();
+        auto loop_start = std::chrono::steady_clock::now();
+        current_tick = cycle_count.load(std::memory_order_relaxed);
+        cycle_deadline_ns = monotonicNanoseconds() + basePeriodNanoseconds();
         
         // Execute one control cycle
         executeControlCycle();
         
-        auto loop_end = std::chrono::high_resolution_clock::now();
+        auto loop_end = std::chrono::steady_clock::now();
         auto loop_duration = std::chrono::duration_cast<std::chrono::microseconds>(loop_end - loop_start);
+        recordCycle(std::chrono::duration_cast<std::chrono::nanoseconds>(loop_start - release).count(),
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(loop_end - loop_start).count());
         
         // Maintain real-time performance
         if (loop_duration < control_interval) {
+            release = loop_end + (control_interval - loop_duration);
             std::this_thread::sleep_for(control_interval - loop_duration);
         } else {
-            std::cout << "⚠️  Control loop timing violation: " << loop_duration.count() << "μs" << std::endl;
+            release = loop_end;
+            overrun_count.fetch_add(1, std::memory_order_relaxed);
+            logMessage(TIMING_VIOLATION, loop_duration.count());
+        }
+        
+        cycle_count++;
+    }
+}
+
+void RealTimeController::applyRealTimeSettings() {
+    RealTimeStatus status{true, false, false, false, false};
+    
+    if (realtime_options.lock_memory) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+            status.memory_locked = true;
+        } else {
+            logMessage(MLOCK_UNAVAILABLE, std::strerror(errno));
+        }
+    }
+    
+    if (realtime_options.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(realtime_options.cpu, &cpus);
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (error == 0) {
+            status.cpu_pinned = true;
+        } else {
+            logMessage(AFFINITY_UNAVAILABLE, realtime_options.cpu, std::strerror(error));
+        }
+    }
+    
+    if (realtime_options.fifo_priority > 0) {
+        sched_param parameters{};
+        parameters.sched_priority = realtime_options.fifo_priority;
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters);
+        if (error == 0) {
+            status.fifo_scheduling = true;
+        } else {
+            logMessage(FIFO_UNAVAILABLE, realtime_options.fifo_priority, std::strerror(error));
         }
+    }
+    
+    if (realtime_options.stack_prefault_bytes > 0) {
+        prefaultStack(realtime_options.stack_prefault_bytes);
+        status.stack_prefaulted = true;
+    }
+    
+    realtime_status = status;
+    logMessage(REALTIME_MODE, status.fifo_scheduling, status.cpu_pinned, status.memory_locked);
+}
+
+void RealTimeController::controlLoopAbsolute() {
+    const int64_t period_ns = basePeriodNanoseconds();
+    // Releases are multiples of the period from the epoch, so sleep and
+    // execution time never accumulate as drift
+    int64_t release_ns = base_epoch_ns;
+    
+    while (is_running) {
+        timespec release = toTimespec(release_ns);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &release, nullptr) == EINTR) {}
+        current_tick = static_cast<uint64_t>((release_ns - base_epoch_ns) / period_ns);
+        cycle_deadline_ns = release_ns + period_ns;
         
+        int64_t start_ns = monotonicNanoseconds();
+        executeControlCycle();
+        int64_t end_ns = monotonicNanoseconds();
+        recordCycle(start_ns - release_ns, end_ns - start_ns);
         cycle_count++;
+        
+        release_ns += period_ns;
+        if (end_ns > release_ns) {
+            overrun_count.fetch_add(1, std::memory_order_relaxed);
+            logMessage(TIMING_VIOLATION, (end_ns - start_ns) / 1000);
+            // Skip the releases already in the past instead of bursting to catch up
+            int64_t missed = (end_ns - release_ns) / period_ns;
+            if (missed > 0) {
+                missed_period_count.fetch_add(static_cast<uint64_t>(missed), std::memory_order_relaxed);
+                release_ns += missed * period_ns;
+            }
+        }
+    }
+}
+
+void RealTimeController::recordCycle(int64_t jitter_ns, int64_t cycle_ns) {
+    if (jitter_ns < 0) jitter_ns = 0;
+    phase_latency[static_cast<size_t>(ControlPhase::WakeupJitter)].record(static_cast<uint64_t>(jitter_ns));
+    total_jitter_ns.fetch_add(jitter_ns, std::memory_order_relaxed);
+    if (jitter_ns > max_jitter_ns.load(std::memory_order_relaxed)) {
+        max_jitter_ns.store(jitter_ns, std::memory_order_relaxed);
+    }
+    if (cycle_ns > max_cycle_ns.load(std::memory_order_relaxed)) {
+        max_cycle_ns.store(cycle_ns, std::memory_order_relaxed);
     }
 }
 
+ControlTimingStats RealTimeController::getTimingStats() const {
+    ControlTimingStats stats;
+    stats.cycles = cycle_count.load(std::memory_order_relaxed);
+    stats.overruns = overrun_count.load(std::memory_order_relaxed);
+    stats.missed_periods = missed_period_count.load(std::memory_order_relaxed);
+    stats.max_jitter_ns = max_jitter_ns.load(std::memory_order_relaxed);
+    stats.mean_jitter_ns = stats.cycles > 0
+        ? static_cast<double>(total_jitter_ns.load(std::memory_order_relaxed)) / stats.cycles : 0.0;
+    stats.max_cycle_ns = max_cycle_ns.load(std::memory_order_relaxed);
+    stats.pipeline_drops = pipeline_drop_count.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void RealTimeController::resetTimingStats() {
+    cycle_count = 0;
+    overrun_count = 0;
+    missed_period_count = 0;
+    max_jitter_ns = 0;
+    total_jitter_ns = 0;
+    max_cycle_ns = 0;
+    pipeline_drop_count = 0;
+    for (auto& histogram : phase_latency) histogram.reset();
+    for (auto& group : rate_groups) {
+        group->runs = 0;
+        group->overruns = 0;
+        group->skipped = 0;
+        group->latency.reset();
+    }
+}
+
+LatencySnapshot RealTimeController::getPhaseLatency(ControlPhase phase) const {
+    return phase_latency[static_cast<size_t>(phase)].snapshot();
+}
+
+std::string RealTimeController::formatMetrics() const {
+    std::vector<LabelledLatency> series;
+    for (size_t i = 0; i < phase_latency.size(); ++i) {
+        series.push_back({controlPhaseName(static_cast<ControlPhase>(i)), phase_latency[i].snapshot()});
+    }
+    
+    std::string text;
+    appendPrometheusHistograms(text, "control_phase_latency", "phase", series);
+    
+    if (!rate_groups.empty()) {
+        std::vector<LabelledLatency> groups;
+        std::string skipped;
+        for (size_t i = 0; i < rate_groups.size(); ++i) {
+            RateGroupStats stats = getRateGroupStats(static_cast<int>(i));
+            skipped += "rate_group_skipped_total{group=\"" + stats.name + "\"} " + std::to_string(stats.skipped) + "\n";
+            groups.push_back({stats.name, std::move(stats.latency)});
+        }
+        appendPrometheusHistograms(text, "rate_group_latency", "group", groups);
+        text += "# HELP rate_group_skipped_total Rate group releases not run\n# TYPE rate_group_skipped_total counter\n";
+        text += skipped;
+    }
+    
+    ControlTimingStats stats = getTimingStats();
+    text += "# HELP control_cycles_total Completed control cycles\n# TYPE control_cycles_total counter\n";
+    text += "control_cycles_total " + std::to_string(stats.cycles) + "\n";
+    text += "# HELP control_missed_periods_total Control periods skipped after overruns\n"
+            "# TYPE control_missed_periods_total counter\n";
+    text += "control_missed_periods_total " + std::to_string(stats.missed_periods) + "\n";
+    return text;
+}
+
 void RealTimeController::executeControlCycle() {
-    // This is where the actual control logic would run
-    // For demonstration, we'll just simulate some work
+    uint64_t cycle_start = latencyTimestampNs();
+    
+    if (parameter_reader) {
+        parameter_reader->quiescent();
+        cycle_parameters = &parameter_reader->get();
+    }
     
     // Simulate reading sensor data
     readSensorData();
+    uint64_t sensors_done = latencyTimestampNs();
+    phase_latency[static_cast<size_t>(ControlPhase::ReadSensors)].record(sensors_done - cycle_start);
     
-    // Simulate safety checks
-    performSafetyChecks();
+    if (pipeline_options.mode == PipelineMode::Pipelined) {
+        // Checks and commands for this frame run on the stage threads
+        ControlFrame& frame = sensor_frames.writeBuffer();
+        frame.cycle = current_tick;
+        frame.sensor_timestamp_ns = cycle_start;
+        if (!sensor_frames.publish()) pipeline_drop_count.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        // Simulate safety checks
+        performSafetyChecks();
+        uint64_t checks_done = latencyTimestampNs();
+        
+        // Simulate sending control commands
+        sendControlCommands();
+        uint64_t commands_done = latencyTimestampNs();
+        
+        phase_latency[static_cast<size_t>(ControlPhase::SafetyChecks)].record(checks_done - sensors_done);
+        phase_latency[static_cast<size_t>(ControlPhase::SendCommands)].record(commands_done - checks_done);
+        phase_latency[static_cast<size_t>(ControlPhase::SensorToCommand)].record(commands_done - cycle_start);
+    }
     
-    // Simulate sending control commands
-    sendControlCommands();
+    publishState(sensors_done);
+    if (!inline_groups.empty()) runInlineGroups();
+    phase_latency[static_cast<size_t>(ControlPhase::FullCycle)].record(latencyTimestampNs() - cycle_start);
     
     // Log performance occasionally
     if (cycle_count % 1000 == 0) {
-        std::cout << "Control cycle " << cycle_count << " completed" << std::endl;
+        logMessage(CYCLE_COMPLETED, cycle_count.load(std::memory_order_relaxed));
+    }
+}
+
+void RealTimeController::configureStageThread(int cpu) {
+    if (cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (error != 0) logMessage(AFFINITY_UNAVAILABLE, cpu, std::strerror(error));
+    }
+    if (realtime_status.fifo_scheduling) {
+        sched_param parameters{};
+        parameters.sched_priority = realtime_options.fifo_priority;
+        pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters);
     }
 }
 
+void RealTimeController::safetyCheckStageLoop() {
+    configureStageThread(pipeline_options.safety_check_cpu);
+    unsigned idle_polls = 0;
+    
+    while (is_running) {
+        if (!sensor_frames.update()) {
+            waitForFrame(idle_polls);
+            continue;
+        }
+        idle_polls = 0;
+        ControlFrame frame = sensor_frames.readBuffer();
+        
+        uint64_t start = latencyTimestampNs();
+        performSafetyChecks();
+        phase_latency[static_cast<size_t>(ControlPhase::SafetyChecks)].record(latencyTimestampNs() - start);
+        
+        checked_frames.writeBuffer() = frame;
+        if (!checked_frames.publish()) pipeline_drop_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void RealTimeController::commandStageLoop() {
+    configureStageThread(pipeline_options.command_cpu);
+    unsigned idle_polls = 0;
+    
+    while (is_running) {
+        if (!checked_frames.update()) {
+            waitForFrame(idle_polls);
+            continue;
+        }
+        idle_polls = 0;
+        const ControlFrame& frame = checked_frames.readBuffer();
+        
+        uint64_t start = latencyTimestampNs();
+        sendControlCommands();
+        uint64_t done = latencyTimestampNs();
+        phase_latency[static_cast<size_t>(ControlPhase::SendCommands)].record(done - start);
+        phase_latency[static_cast<size_t>(ControlPhase::SensorToCommand)].record(done - frame.sensor_timestamp_ns);
+    }
+}
+
+void RealTimeController::runInlineGroups() {
+    for (RateGroup* group : inline_groups) {
+        if (current_tick % group->config.divisor != group->config.offset) continue;
+        
+        int64_t start_ns = monotonicNanoseconds();
+        if (group->config.budget_ns > 0 && start_ns + group->config.budget_ns > cycle_deadline_ns) {
+            group->skipped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        group->task();
+        group->recordRun(monotonicNanoseconds() - start_ns);
+    }
+}
+
+void RealTimeController::secondaryGroupLoop(RateGroup* group) {
+    if (realtime_status.fifo_scheduling && group->config.priority > 0) {
+        sched_param parameters{};
+        parameters.sched_priority = std::min(group->config.priority, realtime_options.fifo_priority - 1);
+        if (parameters.sched_priority > 0) pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters);
+    }
+    
+    // First release on the group's grid at or after the epoch
+    const int64_t base_period_ns = basePeriodNanoseconds();
+    int64_t release_ns = base_epoch_ns + static_cast<int64_t>(group->config.offset) * base_period_ns;
+    
+    while (is_running) {
+        timespec release = toTimespec(release_ns);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &release, nullptr) == EINTR) {}
+        if (!is_running) break;
+        
+        int64_t start_ns = monotonicNanoseconds();
+        group->task();
+        int64_t end_ns = monotonicNanoseconds();
+        group->recordRun(end_ns - start_ns);
+        
+        release_ns += group->period_ns;
+        if (end_ns > release_ns) {
+            int64_t missed = (end_ns - release_ns) / group->period_ns + 1;
+            group->skipped.fetch_add(static_cast<uint64_t>(missed), std::memory_order_relaxed);
+            release_ns += missed * group->period_ns;
+        }
+    }
+}
+
+int64_t RealTimeController::basePeriodNanoseconds() const {
+    return NANOSECONDS_PER_SECOND / control_frequency;
+}
+
+int RealTimeController::addRateGroup(const RateGroupConfig& config, std::function<void()> task) {
+    const char* problem = nullptr;
+    if (is_running) {
+        problem = "control loop is running";
+    } else if (!task) {
+        problem = "no task";
+    } else if (config.divisor == 0 || config.offset >= config.divisor) {
+        problem = "offset must be below a non-zero divisor";
+    } else if (!config.secondary_thread && config.budget_ns >= basePeriodNanoseconds()) {
+        problem = "inline budget must fit in one base tick";
+    }
+    if (problem) {
+        logMessage(INVALID_RATE_GROUP, config.name, problem);
+        return -1;
+    }
+    
+    auto group = std::make_unique<RateGroup>();
+    group->config = config;
+    group->task = std::move(task);
+    rate_groups.push_back(std::move(group));
+    return static_cast<int>(rate_groups.size() - 1);
+}
+
+RateGroupStats RealTimeController::getRateGroupStats(int group_id) const {
+    const RateGroup& group = *rate_groups.at(static_cast<size_t>(group_id));
+    return RateGroupStats{group.config.name,
+                          basePeriodNanoseconds() * group.config.divisor,
+                          group.runs.load(std::memory_order_relaxed),
+                          group.overruns.load(std::memory_order_relaxed),
+                          group.skipped.load(std::memory_order_relaxed),
+                          group.latency.snapshot()};
+}
+
 void RealTimeController::readSensorData() {
     // Simulate reading from force sensors, encoders, etc.
     // In real implementation, this would interface with hardware
+    if (phase_handlers[0]) phase_handlers[0]();
 }
 
 void RealTimeController::performSafetyChecks() {
     // Simulate safety monitoring
     // In real implementation, this would use the SafetyMonitor
+    if (phase_handlers[1]) phase_handlers[1]();
 }
 
 void RealTimeController::sendControlCommands() {
     // Simulate sending commands to motors/actuators
     // In real implementation, this would interface with hardware
+    if (phase_handlers[2]) phase_handlers[2]();
+}
+
+void RealTimeController::publishState(uint64_t timestamp_ns) {
+    cycle_state.cycle = cycle_count.load(std::memory_order_relaxed) + 1;
+    cycle_state.timestamp_ns = timestamp_ns;
+    if (state_source) state_source(cycle_state);
+    if (safety_monitor) {
+        cycle_state.emergency_stop = safety_monitor->isEmergencyStopEngaged();
+        cycle_state.safety_score = safety_monitor->calculateOverallSafetyScore();
+    }
+    cycle_state.robot_state = cycle_state.emergency_stop ? RobotState::EmergencyStop : RobotState::Operational;
+    state_snapshot.store(cycle_state);
+    if (flight_recorder) flight_recorder->append(cycle_state);
+}
+
+void RealTimeController::setStateSource(std::function<void(RobotStateSnapshot&)> source) {
+    if (is_running) return;
+    state_source = std::move(source);
+}
+
+void RealTimeController::attachSafetyMonitor(const SurgicalSafetyMonitor* monitor) {
+    if (is_running) return;
+    safety_monitor = monitor;
+}
+
+void RealTimeController::attachFlightRecorder(FlightRecorder* recorder) {
+    if (is_running) return;
+    flight_recorder = recorder;
+}
+
+bool RealTimeController::attachParameterStore(ParameterStore* store) {
+    if (is_running) return false;
+    cycle_parameters = nullptr;
+    parameter_reader.reset();
+    if (!store) return true;
+    auto reader = std::make_unique<ParameterReader>();
+    if (!reader->attach(*store)) return false;
+    parameter_reader = std::move(reader);
+    cycle_parameters = &parameter_reader->get();
+    return true;
+}
+
+void RealTimeController::setPhaseHandler(ControlPhase phase, std::function<void()> handler) {
+    size_t stage = static_cast<size_t>(phase);
+    if (is_running || stage >= phase_handlers.size()) return;
+    phase_handlers[stage] = std::move(handler);
 }
 
 void RealTimeController::setControlFrequency(int frequency) {
     if (frequency > 0 && frequency <= 10000) {  // Reasonable limits
         control_frequency = frequency;
-        std::cout << "Control frequency set to " << control_frequency << "Hz" << std::endl;
+        logMessage(FREQUENCY_SET, control_frequency);
     } else {
-        std::cout << "Invalid control frequency: " << frequency << "Hz" << std::endl;
+        logMessage(INVALID_FREQUENCY, frequency);
     }
 }
 
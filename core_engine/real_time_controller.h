@@ -3,31 +3,247 @@
 
 #include <thread>
 #include <atomic>
+#include <future>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "latency_histogram.h"
+#include "robot_state_snapshot.h"
+#include "seqlock.h"
+#include "triple_buffer.h"
+
+// Real-time scheduling mode. Absolute-deadline sleeping is always used when
+// enabled; every other setting is optional and skipped (with a warning) when
+// the process lacks the privilege for it.
+struct RealTimeOptions {
+    bool enabled = false;               // false: legacy relative sleep_for loop
+    int fifo_priority = 0;              // SCHED_FIFO priority 1-99, 0 keeps the default policy
+    int cpu = -1;                       // pin the control thread to this CPU, -1 leaves it floating
+    bool lock_memory = false;           // mlockall(MCL_CURRENT | MCL_FUTURE)
+    size_t stack_prefault_bytes = 256 * 1024;   // touched once so the loop never page-faults on stack
+};
+
+// What the control thread actually got
+struct RealTimeStatus {
+    bool absolute_deadlines;
+    bool fifo_scheduling;
+    bool cpu_pinned;
+    bool memory_locked;
+    bool stack_prefaulted;
+};
+
+// Wakeup jitter is the delay between a cycle's scheduled release time and
+// the moment the control thread actually started it. An overrun is a cycle
+// that finished after the next release time; periods skipped entirely are
+// counted as missed.
+struct ControlTimingStats {
+    uint64_t cycles;
+    uint64_t overruns;
+    uint64_t missed_periods;
+    int64_t max_jitter_ns;
+    double mean_jitter_ns;
+    int64_t max_cycle_ns;
+    uint64_t pipeline_drops;            // pipelined mode: frames replaced before the next stage took them
+};
+
+// Serial runs read -> check -> command for one cycle on the control thread.
+// Pipelined runs each stage on its own thread: while the control thread
+// reads cycle k+1, the safety check stage works on cycle k and the command
+// stage on the newest checked frame, handed over through wait-free triple
+// buffers. The pipeline's rate is set by its slowest stage rather than the
+// sum of all three, at the cost of one handoff per stage in latency.
+enum class PipelineMode : uint8_t {
+    Serial = 0,
+    Pipelined
+};
+
+struct PipelineOptions {
+    PipelineMode mode = PipelineMode::Serial;
+    int safety_check_cpu = -1;          // pin the stage threads, -1 leaves them floating
+    int command_cpu = -1;
+};
+
+// Stages of one control cycle with their own latency histogram.
+// WakeupJitter holds the release-to-start delay of each cycle and
+// SensorToCommand the time from the start of a sensor read to the end of
+// the command output built from it. In pipelined mode FullCycle covers
+// only the control thread's share of the cycle.
+enum class ControlPhase : uint8_t {
+    ReadSensors = 0,
+    SafetyChecks,
+    SendCommands,
+    FullCycle,
+    WakeupJitter,
+    SensorToCommand,
+    Count
+};
+
+const char* controlPhaseName(ControlPhase phase);
+
+// A task that runs every `divisor` base ticks of the control loop, on tick
+// numbers congruent to `offset` so groups of equal rate can be staggered.
+//
+// Inline groups run on the control thread after the base phases, highest
+// priority first. With a budget set, an inline group is only started when
+// its budget still fits before the next base tick; otherwise that release
+// is skipped so slow work never delays the fast safety checks.
+//
+// Secondary groups run on their own thread, released on the same tick grid
+// with absolute deadlines. When the control thread runs SCHED_FIFO,
+// priority is used as the secondary thread's FIFO priority (kept below the
+// control thread's).
+struct RateGroupConfig {
+    std::string name;
+    unsigned divisor = 1;
+    unsigned offset = 0;
+    int64_t budget_ns = 0;              // 0: no admission check, overrun against the group period
+    int priority = 0;
+    bool secondary_thread = false;
+};
+
+struct RateGroupStats {
+    std::string name;
+    int64_t period_ns;
+    uint64_t runs;
+    uint64_t overruns;                  // runs longer than the budget (or period)
+    uint64_t skipped;                   // releases not started: no room in the tick, or already missed
+    LatencySnapshot latency;
+};
+
+class SurgicalSafetyMonitor;
+class FlightRecorder;
+class ParameterStore;
+class ParameterReader;
+struct RobotParameters;
 
 class RealTimeController {
 private:
     std::thread control_thread;
     std::atomic<bool> is_running;
     int control_frequency;
-    unsigned long cycle_count;
+    std::atomic<unsigned long> cycle_count;
+
+    RealTimeOptions realtime_options;
+    RealTimeStatus realtime_status;
+    // Written by the control thread only, readable at any time
+    std::atomic<uint64_t> overrun_count;
+    std::atomic<uint64_t> missed_period_count;
+    std::atomic<int64_t> max_jitter_ns;
+    std::atomic<int64_t> total_jitter_ns;
+    std::atomic<int64_t> max_cycle_ns;
+    std::array<LatencyHistogram, static_cast<size_t>(ControlPhase::Count)> phase_latency;
+    
+    // Frame handed between pipeline stages
+    struct ControlFrame {
+        uint64_t cycle;
+        uint64_t sensor_timestamp_ns;
+    };
     
-    void controlLoop();
+    PipelineOptions pipeline_options;
+    TripleBuffer<ControlFrame> sensor_frames;      // read stage -> safety check stage
+    TripleBuffer<ControlFrame> checked_frames;     // safety check stage -> command stage
+    std::thread safety_check_thread;
+    std::thread command_thread;
+    std::atomic<uint64_t> pipeline_drop_count;
+    std::array<std::function<void()>, 3> phase_handlers;
+    
+    // Published once per cycle by the control thread
+    SeqLock<RobotStateSnapshot> state_snapshot;
+    RobotStateSnapshot cycle_state;                 // control thread's working copy
+    std::function<void(RobotStateSnapshot&)> state_source;
+    const SurgicalSafetyMonitor* safety_monitor;
+    FlightRecorder* flight_recorder;
+    std::unique_ptr<ParameterReader> parameter_reader;     // quiescent at the start of every cycle
+    const RobotParameters* cycle_parameters;
+    
+    struct RateGroup;
+    std::vector<std::unique_ptr<RateGroup>> rate_groups;    // fixed while the loop runs
+    std::vector<RateGroup*> inline_groups;                  // by descending priority
+    int64_t base_epoch_ns;              // release time of base tick 0
+    uint64_t current_tick;              // set by the loop before each cycle
+    int64_t cycle_deadline_ns;          // next base release
+
+    void controlLoop(std::promise<void>* started);
+    void controlLoopAbsolute();
+    void applyRealTimeSettings();
+    void recordCycle(int64_t jitter_ns, int64_t cycle_ns);
+    void runInlineGroups();
+    void safetyCheckStageLoop();
+    void commandStageLoop();
+    void configureStageThread(int cpu);
+    void secondaryGroupLoop(RateGroup* group);
+    int64_t basePeriodNanoseconds() const;
+    void publishState(uint64_t timestamp_ns);
     void executeControlCycle();
     void readSensorData();
     void performSafetyChecks();
     void sendControlCommands();
-    
+
 public:
     RealTimeController();
     ~RealTimeController();
-    
+
     void startControlLoop();
     void stopControlLoop();
     void setControlFrequency(int frequency);
     
+    // Takes effect at the next startControlLoop()
+    void setPipelineOptions(const PipelineOptions& options) { pipeline_options = options; }
+    const PipelineOptions& getPipelineOptions() const { return pipeline_options; }
+    // Work for the ReadSensors, SafetyChecks or SendCommands stage; only
+    // while the loop is stopped. Runs on that stage's thread.
+    void setPhaseHandler(ControlPhase phase, std::function<void()> handler);
+    
+    // Fills the joint, force and procedure fields of each cycle's state
+    // snapshot; runs on the control thread after the sensor read. Only
+    // while the loop is stopped.
+    void setStateSource(std::function<void(RobotStateSnapshot&)> source);
+    // E-stop state and safety score are read from the monitor lock-free
+    void attachSafetyMonitor(const SurgicalSafetyMonitor* monitor);
+    // Every published snapshot is also appended to the recorder, on the
+    // control thread. Only while the loop is stopped; nullptr detaches.
+    void attachFlightRecorder(FlightRecorder* recorder);
+    // The control thread picks up the store's current block at the start
+    // of each cycle, so a publish() applies from the next cycle on. Only
+    // while the loop is stopped; nullptr detaches.
+    bool attachParameterStore(ParameterStore* store);
+    // Block in force for the running cycle: for the control thread (phase
+    // handlers in serial mode, inline rate groups, the state source) only.
+    // nullptr without a store.
+    const RobotParameters* getCycleParameters() const { return cycle_parameters; }
+    
+    // Latest published state. Never blocks the control thread; any number
+    // of threads may read concurrently. cycle is 0 until the first cycle.
+    RobotStateSnapshot getStateSnapshot() const { return state_snapshot.load(); }
+    bool tryGetStateSnapshot(RobotStateSnapshot& snapshot) const { return state_snapshot.tryLoad(snapshot); }
+    
+    // Registers a rate group; only while the loop is stopped. Returns the
+    // group id, or -1 for an invalid configuration.
+    int addRateGroup(const RateGroupConfig& config, std::function<void()> task);
+    size_t getRateGroupCount() const { return rate_groups.size(); }
+    RateGroupStats getRateGroupStats(int group_id) const;
+    // Takes effect at the next startControlLoop()
+    void setRealTimeOptions(const RealTimeOptions& options) { realtime_options = options; }
+
     bool isRunning() const { return is_running; }
     int getControlFrequency() const { return control_frequency; }
-    unsigned long getCycleCount() const { return cycle_count; }
+    unsigned long getCycleCount() const { return cycle_count.load(std::memory_order_relaxed); }
+    const RealTimeOptions& getRealTimeOptions() const { return realtime_options; }
+    // Filled in by the control thread before startControlLoop() returns
+    RealTimeStatus getRealTimeStatus() const { return realtime_status; }
+    ControlTimingStats getTimingStats() const;
+    void resetTimingStats();
+    
+    // Per-phase latency, safe to call while the loop runs. FullCycle
+    // overruns count cycles longer than the control period.
+    LatencySnapshot getPhaseLatency(ControlPhase phase) const;
+    // Prometheus text format: phase and rate group histograms plus cycle counters
+    std::string formatMetrics() const;
+    bool exportMetrics(const std::string& path) const { return writeMetricsFile(path, formatMetrics()); }
 };
 
 #endif // REAL_TIME_CONTROLLER_H
@@ -0,0 +1,37 @@
+#include <cstdlib>
+#include <iostream>
+#include "async_logger.h"
+#include "session_replay.h"
+
+// Replays every session of a flight recorder directory through the safety
+// stack and prints the per-session violation summary and throughput.
+//
+//   replay_sessions <directory> [threads] [block_samples]
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <directory> [threads] [block_samples]" << std::endl;
+        return 2;
+    }
+    // The monitor reports every reaction it would have taken; only errors matter here
+    AsyncLoggerOptions log_options;
+    log_options.min_level = LogLevel::Error;
+    AsyncLogger::instance().configure(log_options);
+    
+    ReplayOptions options;
+    if (argc > 2) options.thread_count = static_cast<unsigned>(std::atoi(argv[2]));
+    if (argc > 3) options.block_samples = static_cast<size_t>(std::atol(argv[3]));
+    
+    std::vector<ReplaySession> sessions = findReplaySessions(argv[1]);
+    if (sessions.empty()) {
+        std::cerr << "no recorded sessions in " << argv[1] << std::endl;
+        return 1;
+    }
+    ReplayReport report = replaySessions(sessions, options);
+    std::cout << formatReplayReport(report);
+    
+    for (const SessionReplayResult& result : report.sessions) {
+        if (!result.complete) return 1;
+    }
+    return 0;
+}
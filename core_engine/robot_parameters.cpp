@@ -0,0 +1,455 @@
+#include "robot_parameters.h"
+#include "async_logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+const LogSite CONFIG_FILE_UNREADABLE{LogLevel::Error, "RobotParameters", "Cannot read config file '{}'"};
+const LogSite CONFIG_SYNTAX_ERROR{LogLevel::Error, "RobotParameters", "{}: syntax error at line {}"};
+const LogSite CONFIG_VALUE_INVALID{LogLevel::Error, "RobotParameters", "Invalid value for '{}'"};
+const LogSite CONFIG_REJECTED{LogLevel::Error, "RobotParameters", "Parameters rejected: {}"};
+
+// Scalars of a document by dotted path; array elements are numbered
+// from 0, so dh_parameters.joint_1.2 is the a of joint 1
+using KeyMap = std::map<std::string, std::string>;
+
+std::string trim(const std::string& text) {
+    size_t first = 0;
+    while (first < text.size() && std::isspace(static_cast<unsigned char>(text[first]))) ++first;
+    size_t last = text.size();
+    while (last > first && std::isspace(static_cast<unsigned char>(text[last - 1]))) --last;
+    return text.substr(first, last - first);
+}
+
+std::string joinKey(const std::string& prefix, const std::string& key) {
+    return prefix.empty() ? key : prefix + "." + key;
+}
+
+size_t lineOf(const std::string& text, size_t position) {
+    return 1 + static_cast<size_t>(std::count(text.begin(), text.begin() + std::min(position, text.size()), '\n'));
+}
+
+// Just enough JSON for the config files: objects, arrays, strings without
+// unicode escapes, numbers and literals
+class JsonReader {
+public:
+    JsonReader(const std::string& text, KeyMap& keys) : text(text), keys(keys), position(0) {}
+
+    bool read() {
+        if (!value("")) return false;
+        skipSpace();
+        return position == text.size();
+    }
+
+    size_t errorLine() const { return lineOf(text, position); }
+
+private:
+    void skipSpace() {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) ++position;
+    }
+
+    bool consume(char expected) {
+        skipSpace();
+        if (position >= text.size() || text[position] != expected) return false;
+        ++position;
+        return true;
+    }
+
+    bool string(std::string& out) {
+        if (!consume('"')) return false;
+        out.clear();
+        while (position < text.size() && text[position] != '"') {
+            char c = text[position++];
+            if (c == '\\') {
+                if (position >= text.size()) return false;
+                char escaped = text[position++];
+                switch (escaped) {
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case '"': case '\\': case '/': c = escaped; break;
+                    default: return false;
+                }
+            }
+            out.push_back(c);
+        }
+        return consume('"');
+    }
+
+    bool value(const std::string& path) {
+        skipSpace();
+        if (position >= text.size()) return false;
+        char c = text[position];
+        if (c == '{') {
+            ++position;
+            if (consume('}')) return true;
+            do {
+                std::string key;
+                if (!string(key) || !consume(':') || !value(joinKey(path, key))) return false;
+            } while (consume(','));
+            return consume('}');
+        }
+        if (c == '[') {
+            ++position;
+            if (consume(']')) return true;
+            size_t index = 0;
+            do {
+                if (!value(joinKey(path, std::to_string(index++)))) return false;
+            } while (consume(','));
+            return consume(']');
+        }
+        if (c == '"') {
+            std::string scalar;
+            if (!string(scalar)) return false;
+            keys[path] = scalar;
+            return true;
+        }
+        size_t start = position;
+        while (position < text.size() && text[position] != ',' && text[position] != '}' &&
+               text[position] != ']' && !std::isspace(static_cast<unsigned char>(text[position]))) {
+            ++position;
+        }
+        if (position == start) return false;
+        keys[path] = text.substr(start, position - start);
+        return true;
+    }
+
+    const std::string& text;
+    KeyMap& keys;
+    size_t position;
+};
+
+std::string unquote(const std::string& text) {
+    if (text.size() >= 2 && (text.front() == '"' || text.front() == '\'') && text.back() == text.front()) {
+        return text.substr(1, text.size() - 2);
+    }
+    return text;
+}
+
+// Block mappings nested by indentation, with plain or quoted scalars and
+// flow sequences of scalars as values: the subset robot_config.yaml uses.
+// Returns 0 on success, otherwise the offending line.
+size_t readYaml(const std::string& text, KeyMap& keys) {
+    std::vector<std::pair<size_t, std::string>> parents;   // indent, path
+    std::istringstream lines(text);
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(lines, line)) {
+        ++line_number;
+        size_t comment = line.find(" #");
+        if (comment != std::string::npos) line.erase(comment);
+        if (!line.empty() && line[0] == '#') line.clear();
+        std::string content = trim(line);
+        if (content.empty()) continue;
+        if (content == "---") continue;
+
+        size_t indent = line.find_first_not_of(' ');
+        if (line[indent] == '\t' || content[0] == '-') return line_number;   // tabs, block sequences
+        size_t colon = content.find(':');
+        if (colon == std::string::npos || colon == 0) return line_number;
+
+        while (!parents.empty() && parents.back().first >= indent) parents.pop_back();
+        std::string path = joinKey(parents.empty() ? "" : parents.back().second, trim(content.substr(0, colon)));
+        std::string scalar = trim(content.substr(colon + 1));
+
+        if (scalar.empty()) {
+            parents.emplace_back(indent, path);
+        } else if (scalar[0] == '[') {
+            if (scalar.back() != ']') return line_number;
+            std::istringstream items(scalar.substr(1, scalar.size() - 2));
+            std::string item;
+            size_t index = 0;
+            while (std::getline(items, item, ',')) {
+                item = trim(item);
+                if (item.empty()) return line_number;
+                keys[joinKey(path, std::to_string(index++))] = unquote(item);
+            }
+        } else {
+            keys[path] = unquote(scalar);
+        }
+    }
+    return 0;
+}
+
+// Lookups fail only on a present but malformed value; an absent key
+// leaves `value` alone
+class KeyReader {
+public:
+    KeyReader(const KeyMap& keys, const std::string& prefix) : keys(keys), prefix(prefix), valid(true) {}
+
+    bool has(const std::string& key) const { return keys.count(prefix + key) != 0; }
+
+    bool number(const std::string& key, double& value) {
+        auto found = keys.find(prefix + key);
+        if (found == keys.end()) return false;
+        char* end = nullptr;
+        double parsed = std::strtod(found->second.c_str(), &end);
+        if (found->second.empty() || *end != '\0' || !std::isfinite(parsed)) return invalid(found->first);
+        value = parsed;
+        return true;
+    }
+
+    bool count(const std::string& key, uint32_t& value) {
+        double parsed = 0.0;
+        if (!number(key, parsed)) return false;
+        if (parsed < 0.0 || parsed > 4294967295.0 || parsed != std::floor(parsed)) return invalid(prefix + key);
+        value = static_cast<uint32_t>(parsed);
+        return true;
+    }
+
+    bool flag(const std::string& key, bool& value) {
+        auto found = keys.find(prefix + key);
+        if (found == keys.end()) return false;
+        if (found->second != "true" && found->second != "false") return invalid(found->first);
+        value = found->second == "true";
+        return true;
+    }
+
+    // NUL-terminated copy into a fixed buffer; too long is malformed
+    bool text(const std::string& key, char* value, size_t capacity) {
+        auto found = keys.find(prefix + key);
+        if (found == keys.end()) return false;
+        if (found->second.size() >= capacity) return invalid(found->first);
+        std::memcpy(value, found->second.c_str(), found->second.size() + 1);
+        return true;
+    }
+
+    bool ok() const { return valid; }
+
+private:
+    bool invalid(const std::string& key) {
+        logMessage(CONFIG_VALUE_INVALID, key);
+        valid = false;
+        return false;
+    }
+
+    const KeyMap& keys;
+    const std::string prefix;
+    bool valid;
+};
+
+bool reject(const char* reason) {
+    logMessage(CONFIG_REJECTED, reason);
+    return false;
+}
+
+bool applySafetyKeys(const KeyMap& keys, RobotParameters& p) {
+    KeyReader safety(keys, "safety_parameters.");
+
+    double max_force = 0.0;
+    if (safety.number("force_limits.max_force_newtons", max_force)) {
+        std::fill(p.max_force_newtons, p.max_force_newtons + RobotParameters::MAX_FORCE_CHANNELS, max_force);
+    }
+    safety.number("force_limits.warning_threshold", p.force_warning_newtons);
+    safety.number("force_limits.rapid_change_threshold", p.rapid_force_change_newtons);
+
+    double max_velocity = 0.0;
+    if (safety.number("velocity_limits.max_velocity_mm_per_sec", max_velocity)) {
+        std::fill(p.max_velocity_mm_per_sec, p.max_velocity_mm_per_sec + RobotParameters::VELOCITY_CHANNELS,
+                  max_velocity);
+    }
+    safety.number("velocity_limits.warning_threshold", p.velocity_warning_mm_per_sec);
+    safety.number("position_limits.workspace_boundary_mm", p.workspace_boundary_mm);
+
+    safety.number("collision_detection.min_safe_distance_mm", p.min_safe_distance_mm);
+    safety.number("collision_detection.warning_distance_mm", p.warning_distance_mm);
+    safety.number("collision_detection.critical_distance_mm", p.critical_distance_mm);
+
+    safety.flag("emergency_procedures.auto_emergency_stop", p.auto_emergency_stop);
+    safety.flag("emergency_procedures.require_manual_reset", p.require_manual_reset);
+    safety.count("emergency_procedures.stop_delay_ms", p.stop_delay_ms);
+    return safety.ok();
+}
+
+// Joint limits are applied after the joint count is known. The envelope
+// (min/max_joint_angle_degrees) bounds every joint; joint_limits_degrees
+// narrows the first joints, the others get the whole envelope.
+bool applyJointLimitKeys(const KeyMap& keys, uint32_t previous_joint_count, RobotParameters& p) {
+    KeyReader limits(keys, "safety_parameters.position_limits.");
+    double envelope_min = *std::min_element(p.joint_min_degrees, p.joint_min_degrees + previous_joint_count);
+    double envelope_max = *std::max_element(p.joint_max_degrees, p.joint_max_degrees + previous_joint_count);
+    bool envelope_given = limits.number("min_joint_angle_degrees", envelope_min);
+    envelope_given = limits.number("max_joint_angle_degrees", envelope_max) || envelope_given;
+    if (!limits.ok()) return false;
+    if (!(envelope_min < envelope_max)) return reject("joint angle envelope is empty");
+
+    for (uint32_t joint = 0; joint < p.joint_count; ++joint) {
+        std::string pair = "joint_limits_degrees." + std::to_string(joint);
+        if (limits.has(pair + ".0") || limits.has(pair + ".1")) {
+            if (!limits.number(pair + ".0", p.joint_min_degrees[joint]) ||
+                !limits.number(pair + ".1", p.joint_max_degrees[joint])) {
+                return reject("joint limit needs both a minimum and a maximum");
+            }
+            if (!(p.joint_min_degrees[joint] < p.joint_max_degrees[joint]) ||
+                p.joint_min_degrees[joint] < envelope_min || p.joint_max_degrees[joint] > envelope_max) {
+                return reject("joint limit outside the joint angle envelope");
+            }
+        } else if (envelope_given || joint >= previous_joint_count) {
+            p.joint_min_degrees[joint] = envelope_min;
+            p.joint_max_degrees[joint] = envelope_max;
+        }
+    }
+    if (limits.has("joint_limits_degrees." + std::to_string(p.joint_count) + ".0")) {
+        return reject("more joint limits than position sensors");
+    }
+    return true;
+}
+
+bool applyRobotKeys(const KeyMap& keys, RobotParameters& p) {
+    KeyReader robot(keys, "robot_configuration.");
+
+    for (size_t joint = 0; joint < RobotParameters::DOF; ++joint) {
+        std::string row = "kinematics.dh_parameters.joint_" + std::to_string(joint + 1) + ".";
+        if (!robot.has(row + "0")) continue;
+        double values[4];
+        for (size_t column = 0; column < 4; ++column) {
+            if (!robot.number(row + std::to_string(column), values[column])) {
+                return reject("DH parameters need [theta, alpha, a, d]");
+            }
+        }
+        if (robot.has(row + "4")) return reject("DH parameters need [theta, alpha, a, d]");
+        p.dh_parameters[joint] = DHParameters<double>{values[0], values[1], values[2], values[3]};
+    }
+    if (robot.has("kinematics.dh_parameters.joint_" + std::to_string(RobotParameters::DOF + 1) + ".0")) {
+        return reject("DH table has more rows than the arm has joints");
+    }
+
+    robot.count("sensors.position_sensors.count", p.joint_count);
+    robot.count("sensors.force_sensors.count", p.force_channel_count);
+    robot.count("sensors.force_sensors.sampling_rate_hz", p.force_sampling_rate_hz);
+    robot.count("communication.update_rate_hz", p.dds_update_rate_hz);
+    robot.count("logging.retention_period_days", p.retention_period_days);
+    robot.flag("logging.raw_sensor_data", p.record_raw_sensor_data);
+    robot.text("logging.flight_recorder.directory", p.flight_recorder_directory, RobotParameters::MAX_PATH_LENGTH);
+    robot.count("logging.flight_recorder.records_per_chunk", p.flight_records_per_chunk);
+    robot.count("logging.flight_recorder.flush_interval_ms", p.flight_flush_interval_ms);
+    return robot.ok();
+}
+
+bool validate(const RobotParameters& p) {
+    if (p.joint_count == 0 || p.joint_count > RobotParameters::MAX_JOINTS) return reject("position sensor count");
+    if (p.force_channel_count > RobotParameters::MAX_FORCE_CHANNELS) return reject("force sensor count");
+    for (size_t c = 0; c < p.force_channel_count; ++c) {
+        if (!(p.max_force_newtons[c] > 0.0)) return reject("max force must be positive");
+    }
+    for (size_t c = 0; c < RobotParameters::VELOCITY_CHANNELS; ++c) {
+        if (!(p.max_velocity_mm_per_sec[c] > 0.0)) return reject("max velocity must be positive");
+    }
+    if (!(p.force_warning_newtons > 0.0 && p.force_warning_newtons <= p.max_force_newtons[0])) {
+        return reject("force warning threshold must lie in (0, max force]");
+    }
+    if (!(p.velocity_warning_mm_per_sec > 0.0 && p.velocity_warning_mm_per_sec <= p.max_velocity_mm_per_sec[0])) {
+        return reject("velocity warning threshold must lie in (0, max velocity]");
+    }
+    if (!(p.rapid_force_change_newtons > 0.0)) return reject("rapid force change threshold must be positive");
+    if (!(p.workspace_boundary_mm > 0.0)) return reject("workspace boundary must be positive");
+    if (!(p.critical_distance_mm > 0.0 && p.critical_distance_mm <= p.min_safe_distance_mm &&
+          p.min_safe_distance_mm <= p.warning_distance_mm)) {
+        return reject("collision distances must satisfy 0 < critical <= min safe <= warning");
+    }
+    if (p.flight_records_per_chunk == 0) return reject("flight recorder chunks need at least one record");
+    if (p.flight_flush_interval_ms == 0) return reject("flight recorder flush interval must be positive");
+    if (p.flight_recorder_directory[0] == '\0') return reject("flight recorder directory must not be empty");
+    for (const auto& row : p.dh_parameters) {
+        if (!std::isfinite(row.theta_offset) || !std::isfinite(row.alpha) || !std::isfinite(row.a) ||
+            !std::isfinite(row.d)) {
+            return reject("DH parameters must be finite");
+        }
+    }
+    return true;
+}
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path);
+    if (!file) {
+        logMessage(CONFIG_FILE_UNREADABLE, path);
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+RobotParameters shippedParameters() {
+    RobotParameters p{};
+    p.joint_count = 6;
+    p.force_channel_count = 3;
+    // Ethicon arm specification; joints 5 and 6 use the whole envelope
+    const double joint_range[RobotParameters::DOF] = {180.0, 90.0, 120.0, 150.0, 180.0, 180.0};
+    for (size_t joint = 0; joint < RobotParameters::MAX_JOINTS; ++joint) {
+        double range = joint < RobotParameters::DOF ? joint_range[joint] : 180.0;
+        p.joint_min_degrees[joint] = -range;
+        p.joint_max_degrees[joint] = range;
+    }
+    std::fill(p.max_force_newtons, p.max_force_newtons + RobotParameters::MAX_FORCE_CHANNELS, 15.0);
+    std::fill(p.max_velocity_mm_per_sec, p.max_velocity_mm_per_sec + RobotParameters::VELOCITY_CHANNELS, 50.0);
+    p.rapid_force_change_newtons = 5.0;
+    p.min_safe_distance_mm = 2.0;
+    p.warning_distance_mm = 5.0;
+    p.critical_distance_mm = 1.0;
+    p.force_warning_newtons = 10.0;
+    p.velocity_warning_mm_per_sec = 40.0;
+    p.workspace_boundary_mm = 500.0;
+    p.auto_emergency_stop = true;
+    p.require_manual_reset = true;
+    p.stop_delay_ms = 50;
+    p.dh_parameters = ETHICON_ARM_DH_PARAMETERS;
+    p.force_sampling_rate_hz = 1000;
+    p.dds_update_rate_hz = 100;
+    p.retention_period_days = 30;
+    p.record_raw_sensor_data = true;
+    p.flight_records_per_chunk = 65536;
+    p.flight_flush_interval_ms = 100;
+    std::strcpy(p.flight_recorder_directory, "recordings");
+    return p;
+}
+
+} // namespace
+
+const RobotParameters& defaultRobotParameters() {
+    static const RobotParameters parameters = shippedParameters();
+    return parameters;
+}
+
+bool parseRobotParameters(const std::string& safety_json, const std::string& robot_yaml,
+                          RobotParameters& parameters) {
+    KeyMap safety_keys;
+    JsonReader json(safety_json, safety_keys);
+    if (!json.read()) {
+        logMessage(CONFIG_SYNTAX_ERROR, "safety parameters", json.errorLine());
+        return false;
+    }
+    KeyMap robot_keys;
+    if (size_t line = readYaml(robot_yaml, robot_keys)) {
+        logMessage(CONFIG_SYNTAX_ERROR, "robot configuration", line);
+        return false;
+    }
+
+    RobotParameters parsed = parameters;
+    if (!applySafetyKeys(safety_keys, parsed) || !applyRobotKeys(robot_keys, parsed)) return false;
+    if (parsed.joint_count == 0 || parsed.joint_count > RobotParameters::MAX_JOINTS) {
+        return reject("position sensor count");
+    }
+    uint32_t previous_joint_count = std::min<uint32_t>(std::max<uint32_t>(parameters.joint_count, 1),
+                                                       RobotParameters::MAX_JOINTS);
+    if (!applyJointLimitKeys(safety_keys, previous_joint_count, parsed) || !validate(parsed)) return false;
+
+    parsed.version = 0;
+    parameters = parsed;
+    return true;
+}
+
+bool loadRobotParameters(const std::string& safety_json_path, const std::string& robot_yaml_path,
+                         RobotParameters& parameters) {
+    std::string safety_json, robot_yaml;
+    if (!readFile(safety_json_path, safety_json) || !readFile(robot_yaml_path, robot_yaml)) return false;
+    return parseRobotParameters(safety_json, robot_yaml, parameters);
+}
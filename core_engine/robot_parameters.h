@@ -0,0 +1,68 @@
+#ifndef ROBOT_PARAMETERS_H
+#define ROBOT_PARAMETERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "kinematics.h"
+
+// Everything the control loop reads from config/safety_parameters.json and
+// config/robot_config.yaml, parsed once into a flat block: no heap
+// pointers, the per-cycle limits packed at the front so a safety check
+// touches a few cache lines. Blocks are immutable once published through a
+// ParameterStore; a change is a new block.
+struct alignas(64) RobotParameters {
+    static constexpr size_t MAX_JOINTS = 8;
+    static constexpr size_t MAX_FORCE_CHANNELS = 8;
+    static constexpr size_t VELOCITY_CHANNELS = 3;     // Cartesian instrument velocity
+    static constexpr size_t DOF = 6;                   // rows of the DH table
+    static constexpr size_t MAX_PATH_LENGTH = 256;     // including the terminating NUL
+
+    uint64_t version;                   // assigned by ParameterStore::publish, 0 for unpublished blocks
+
+    // Checked every cycle
+    uint32_t joint_count;               // position_sensors.count
+    uint32_t force_channel_count;       // force_sensors.count
+    double joint_min_degrees[MAX_JOINTS];
+    double joint_max_degrees[MAX_JOINTS];
+    double max_force_newtons[MAX_FORCE_CHANNELS];
+    double max_velocity_mm_per_sec[VELOCITY_CHANNELS];
+    double rapid_force_change_newtons;
+    double min_safe_distance_mm;
+    double warning_distance_mm;
+    double critical_distance_mm;
+
+    double force_warning_newtons;
+    double velocity_warning_mm_per_sec;
+    double workspace_boundary_mm;
+    bool auto_emergency_stop;
+    bool require_manual_reset;
+    uint32_t stop_delay_ms;
+
+    DHTable<DOF> dh_parameters;
+
+    uint32_t force_sampling_rate_hz;
+    uint32_t dds_update_rate_hz;
+    uint32_t retention_period_days;
+
+    // logging section; the flight recorder runs only with raw_sensor_data
+    bool record_raw_sensor_data;
+    uint32_t flight_records_per_chunk;
+    uint32_t flight_flush_interval_ms;
+    char flight_recorder_directory[MAX_PATH_LENGTH];
+};
+
+// The values shipped in config/, for monitors built without a store
+const RobotParameters& defaultRobotParameters();
+
+// Reads the safety_parameters.json and robot_config.yaml documents on top
+// of `parameters`: settings absent from a document keep their current
+// value. The result is validated as a whole (limits ordered and finite,
+// channel counts within the block's capacity); on any error `parameters`
+// is left untouched and false is returned.
+bool parseRobotParameters(const std::string& safety_json, const std::string& robot_yaml,
+                          RobotParameters& parameters);
+bool loadRobotParameters(const std::string& safety_json_path, const std::string& robot_yaml_path,
+                         RobotParameters& parameters);
+
+#endif // ROBOT_PARAMETERS_H
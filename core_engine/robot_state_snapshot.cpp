@@ -0,0 +1,14 @@
+#include "robot_state_snapshot.h"
+
+const char* procedurePhaseName(ProcedurePhase phase) {
+    switch (phase) {
+        case ProcedurePhase::Initialization: return "INITIALIZATION";
+        case ProcedurePhase::Preparation: return "PREPARATION";
+        case ProcedurePhase::Incision: return "INCISION";
+        case ProcedurePhase::Dissection: return "DISSECTION";
+        case ProcedurePhase::Suturing: return "SUTURING";
+        case ProcedurePhase::Closure: return "CLOSURE";
+        case ProcedurePhase::Completed: return "COMPLETED";
+        default: return "UNKNOWN";
+    }
+}
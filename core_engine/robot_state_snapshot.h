@@ -0,0 +1,43 @@
+#ifndef ROBOT_STATE_SNAPSHOT_H
+#define ROBOT_STATE_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "safety_event_log.h"
+
+enum class ProcedurePhase : uint8_t {
+    Initialization = 0,
+    Preparation,
+    Incision,
+    Dissection,
+    Suturing,
+    Closure,
+    Completed
+};
+
+const char* procedurePhaseName(ProcedurePhase phase);
+
+// Fixed-size copy of the robot's state as of one control cycle, published
+// through a SeqLock so non-real-time readers (DDS publisher, dashboard
+// bridge, analytics) never touch the control thread's locks. Mirrors
+// SafetyMetrics with inline arrays instead of vectors and strings.
+struct RobotStateSnapshot {
+    static constexpr size_t MAX_JOINTS = 8;
+    static constexpr size_t MAX_FORCE_CHANNELS = 8;
+
+    uint64_t cycle;                     // control cycle that published it, 0: nothing yet
+    uint64_t timestamp_ns;              // steady_clock
+    uint8_t joint_count;
+    uint8_t force_count;
+    RobotState robot_state;
+    ProcedurePhase procedure_phase;
+    bool emergency_stop;
+    double joint_positions[MAX_JOINTS];
+    double joint_velocities[MAX_JOINTS];
+    double force_readings[MAX_FORCE_CHANNELS];
+    double collision_risk;
+    double procedure_duration;          // seconds
+    double safety_score;
+};
+
+#endif // ROBOT_STATE_SNAPSHOT_H
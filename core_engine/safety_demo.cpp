@@ -2,6 +2,7 @@
 #include <vector>
 #include <thread>
 #include <chrono>
+#include "parameter_store.h"
 #include "safety_monitor.h"
 #include "kinematics_solver.h"
 #include "collision_detector.h"
@@ -10,9 +11,14 @@ int main() {
     std::cout << "🚀 J&J Surgical Robotics Safety Platform - Enhanced Demo" << std::endl;
     std::cout << "========================================================" << std::endl;
     
+    // Limits and DH table from config/; the shipped values when run elsewhere
+    ParameterStore parameters;
+    parameters.reload("config/safety_parameters.json", "config/robot_config.yaml");
+    
     // Initialize all components
     SurgicalSafetyMonitor safety_monitor;
-    RoboticsKinematics kinematics_solver;
+    safety_monitor.attachParameterStore(parameters);
+    RoboticsKinematics kinematics_solver(parameters.snapshot().dh_parameters);
     CollisionDetector collision_detector;
     
     std::cout << "\n📋 Testing Safety Monitor..." << std::endl;
@@ -0,0 +1,229 @@
+#include "safety_event_log.h"
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char* const BUILTIN_EVENT_NAMES[] = {
+    "INVALID_JOINT_DATA",
+    "JOINT_SAFETY_VIOLATION",
+    "EXCESSIVE_FORCE",
+    "RAPID_FORCE_CHANGE",
+    "EXCESSIVE_VELOCITY",
+    "COLLISION_IMMINENT",
+    "EMERGENCY_STOP_TRIGGERED",
+    "FORCE_REDUCTION_APPLIED",
+    "NORMAL_OPERATION_RESUMED"
+};
+
+static_assert(sizeof(BUILTIN_EVENT_NAMES) / sizeof(BUILTIN_EVENT_NAMES[0]) ==
+              static_cast<size_t>(SafetyEventType::BuiltinCount),
+              "Built-in event names must match SafetyEventType");
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+uint64_t committedMarker(uint64_t sequence) { return (sequence + 1) << 1; }
+uint64_t writingMarker(uint64_t sequence) { return (sequence << 1) | 1; }
+
+} // namespace
+
+const char* robotStateName(RobotState state) {
+    return state == RobotState::EmergencyStop ? "EMERGENCY_STOP" : "OPERATIONAL";
+}
+
+SafetyEventTypeRegistry& SafetyEventTypeRegistry::instance() {
+    static SafetyEventTypeRegistry registry;
+    return registry;
+}
+
+SafetyEventTypeRegistry::SafetyEventTypeRegistry() : entry_count(0) {
+    for (const char* name : BUILTIN_EVENT_NAMES) {
+        add(name);
+    }
+}
+
+void SafetyEventTypeRegistry::add(const char* name) {
+    size_t index = entry_count.load(std::memory_order_relaxed);
+    Entry& entry = entries[index];
+    std::strncpy(entry.name.data(), name, MAX_NAME_LENGTH);
+    entry.name[MAX_NAME_LENGTH] = '\0';
+    // Severity rule carried over from the original string-based log
+    entry.severity = std::strstr(entry.name.data(), "EMERGENCY") != nullptr ? 5 : 3;
+    entry_count.store(index + 1, std::memory_order_release);
+}
+
+SafetyEventTypeId SafetyEventTypeRegistry::find(const std::string& name) const {
+    size_t count = entry_count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        if (std::strncmp(entries[i].name.data(), name.c_str(), MAX_NAME_LENGTH) == 0) {
+            return static_cast<SafetyEventTypeId>(i);
+        }
+    }
+    return UNKNOWN_TYPE;
+}
+
+SafetyEventTypeId SafetyEventTypeRegistry::intern(const std::string& name) {
+    SafetyEventTypeId id = find(name);
+    if (id != UNKNOWN_TYPE) return id;
+
+    std::lock_guard<std::mutex> lock(intern_mutex);
+    id = find(name);
+    if (id != UNKNOWN_TYPE) return id;
+
+    size_t count = entry_count.load(std::memory_order_relaxed);
+    if (count >= UNKNOWN_TYPE) return UNKNOWN_TYPE;
+
+    add(name.c_str());
+    return static_cast<SafetyEventTypeId>(count);
+}
+
+const char* SafetyEventTypeRegistry::name(SafetyEventTypeId id) const {
+    if (id >= entry_count.load(std::memory_order_acquire)) return "UNKNOWN";
+    return entries[id].name.data();
+}
+
+uint8_t SafetyEventTypeRegistry::severity(SafetyEventTypeId id) const {
+    if (id >= entry_count.load(std::memory_order_acquire)) return 3;
+    return entries[id].severity;
+}
+
+SafetyEventLog::SafetyEventLog(size_t min_capacity)
+    : slots(new Slot[roundUpToPowerOfTwo(min_capacity)]),
+      slot_mask(roundUpToPowerOfTwo(min_capacity) - 1),
+      head(0) {
+    for (size_t i = 0; i <= slot_mask; ++i) {
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t SafetyEventLog::nowNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void SafetyEventLog::append(SafetyEventTypeId event_type, double value,
+                            RobotState robot_state, uint8_t severity_level) {
+    uint64_t claimed = head.fetch_add((static_cast<uint64_t>(severity_level) << SEVERITY_SHIFT) | 1,
+                                      std::memory_order_relaxed);
+    uint64_t sequence = claimed & SEQUENCE_MASK;
+    uint64_t cumulative = ((claimed >> SEVERITY_SHIFT) + severity_level) & SEVERITY_MASK;
+    Slot& slot = slots[sequence & slot_mask];
+
+    uint64_t value_bits;
+    std::memcpy(&value_bits, &value, sizeof(value_bits));
+    uint64_t meta = static_cast<uint64_t>(event_type) |
+                    (static_cast<uint64_t>(robot_state) << 16) |
+                    (static_cast<uint64_t>(severity_level) << 24) |
+                    (cumulative << 32);
+
+    slot.sequence.store(writingMarker(sequence), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestamp_ns.store(nowNanoseconds(), std::memory_order_relaxed);
+    slot.value_bits.store(value_bits, std::memory_order_relaxed);
+    slot.packed_meta.store(meta, std::memory_order_relaxed);
+    slot.sequence.store(committedMarker(sequence), std::memory_order_release);
+}
+
+bool SafetyEventLog::readSlot(uint64_t sequence, SafetyEventRecord& out) const {
+    const Slot& slot = slots[sequence & slot_mask];
+
+    uint64_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before != committedMarker(sequence)) return false;
+
+    uint64_t timestamp_ns = slot.timestamp_ns.load(std::memory_order_relaxed);
+    uint64_t value_bits = slot.value_bits.load(std::memory_order_relaxed);
+    uint64_t meta = slot.packed_meta.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != before) return false;
+
+    out.sequence = sequence;
+    out.timestamp_ns = timestamp_ns;
+    std::memcpy(&out.value, &value_bits, sizeof(out.value));
+    out.event_type = static_cast<SafetyEventTypeId>(meta & 0xFFFF);
+    out.robot_state = static_cast<RobotState>((meta >> 16) & 0xFF);
+    out.severity_level = static_cast<uint8_t>((meta >> 24) & 0xFF);
+    out.cumulative_severity = static_cast<uint32_t>(meta >> 32);
+    return true;
+}
+
+size_t SafetyEventLog::snapshot(SafetyEventRecord* out, size_t max_count) const {
+    if (max_count == 0) return 0;
+
+    uint64_t end = head.load(std::memory_order_acquire) & SEQUENCE_MASK;
+    uint64_t oldest = end > capacity() ? end - capacity() : 0;
+
+    // Walk backwards from the newest record, filling out from the back so
+    // the result ends up oldest first without a second buffer.
+    size_t written = 0;
+    for (uint64_t sequence = end; sequence > oldest && written < max_count; --sequence) {
+        SafetyEventRecord record;
+        if (readSlot(sequence - 1, record)) {
+            out[max_count - 1 - written] = record;
+            ++written;
+        }
+    }
+
+    if (written < max_count) {
+        std::memmove(out, out + (max_count - written), written * sizeof(SafetyEventRecord));
+    }
+    return written;
+}
+
+uint64_t SafetyEventLog::prefixSeverity(uint64_t count, uint64_t end, uint64_t& prefix) const {
+    for (; count < end; ++count) {
+        if (count == 0) {
+            prefix = 0;
+            return count;
+        }
+        SafetyEventRecord record;
+        if (readSlot(count - 1, record)) {
+            prefix = record.cumulative_severity;
+            return count;
+        }
+    }
+    return end;
+}
+
+SeverityWindow SafetyEventLog::windowFrom(uint64_t first, uint64_t end_word) const {
+    uint64_t end = end_word & SEQUENCE_MASK;
+    uint64_t prefix = 0;
+    first = prefixSeverity(first, end, prefix);
+    if (first >= end) return {0, 0};
+
+    uint64_t total = end_word >> SEVERITY_SHIFT;
+    return {end - first, (total - prefix) & SEVERITY_MASK};
+}
+
+SeverityWindow SafetyEventLog::severityOfLastEvents(size_t count) const {
+    uint64_t end_word = head.load(std::memory_order_acquire);
+    uint64_t end = end_word & SEQUENCE_MASK;
+    uint64_t window = std::min<uint64_t>(count, std::min<uint64_t>(end, capacity() - 1));
+    return windowFrom(end - window, end_word);
+}
+
+SeverityWindow SafetyEventLog::severitySince(uint64_t since_ns) const {
+    uint64_t end_word = head.load(std::memory_order_acquire);
+    uint64_t end = end_word & SEQUENCE_MASK;
+    uint64_t oldest = end >= capacity() ? end - capacity() + 1 : 0;
+
+    // Binary search for the first event at or after since_ns. Timestamps
+    // increase with sequence; an unreadable slot is treated as recent.
+    uint64_t low = oldest;
+    uint64_t high = end;
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        SafetyEventRecord record;
+        if (readSlot(mid, record) && record.timestamp_ns < since_ns) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return windowFrom(low, end_word);
+}
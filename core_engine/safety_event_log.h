@@ -0,0 +1,137 @@
+#ifndef SAFETY_EVENT_LOG_H
+#define SAFETY_EVENT_LOG_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Interned identifier for a safety event type. Built-in types have fixed
+// ids; any other name is interned once on first use.
+using SafetyEventTypeId = uint16_t;
+
+enum class SafetyEventType : SafetyEventTypeId {
+    InvalidJointData = 0,
+    JointSafetyViolation,
+    ExcessiveForce,
+    RapidForceChange,
+    ExcessiveVelocity,
+    CollisionImminent,
+    EmergencyStopTriggered,
+    ForceReductionApplied,
+    NormalOperationResumed,
+    BuiltinCount
+};
+
+enum class RobotState : uint8_t {
+    Operational = 0,
+    EmergencyStop
+};
+
+const char* robotStateName(RobotState state);
+
+// Name <-> id table for safety event types. Lookups never allocate; a new
+// name takes a mutex once, when it is first interned.
+class SafetyEventTypeRegistry {
+public:
+    static constexpr size_t MAX_TYPES = 256;
+    static constexpr size_t MAX_NAME_LENGTH = 47;
+    static constexpr SafetyEventTypeId UNKNOWN_TYPE = MAX_TYPES - 1;
+
+    static SafetyEventTypeRegistry& instance();
+
+    SafetyEventTypeId intern(const std::string& name);
+    const char* name(SafetyEventTypeId id) const;
+    uint8_t severity(SafetyEventTypeId id) const;
+
+private:
+    struct Entry {
+        std::array<char, MAX_NAME_LENGTH + 1> name;
+        uint8_t severity;
+    };
+
+    SafetyEventTypeRegistry();
+    SafetyEventTypeId find(const std::string& name) const;
+    void add(const char* name);
+
+    std::array<Entry, MAX_TYPES> entries;
+    std::atomic<size_t> entry_count;
+    std::mutex intern_mutex;
+};
+
+// Plain-old-data event record as stored in the ring buffer.
+struct SafetyEventRecord {
+    uint64_t sequence;
+    uint64_t timestamp_ns;      // steady_clock, monotonic
+    double value;
+    SafetyEventTypeId event_type;
+    RobotState robot_state;
+    uint8_t severity_level;     // 1-5, 5 being most critical
+    uint32_t cumulative_severity; // running severity total including this event, mod 2^24
+};
+
+// Event count and summed severity over a window of the log.
+struct SeverityWindow {
+    uint64_t event_count;
+    uint64_t severity_sum;
+};
+
+// Fixed-capacity multi-producer ring of safety events. Producers claim a
+// slot with a single fetch_add and never wait; readers copy out records and
+// validate them with a per-slot sequence, so they never block producers.
+// The oldest records are overwritten once the ring is full.
+//
+// The head counter also carries a running severity total, so every record
+// knows the prefix sum up to itself and any window sum is the difference of
+// two prefix sums: O(1) for the last N events, O(log capacity) for the last
+// T seconds.
+class SafetyEventLog {
+public:
+    explicit SafetyEventLog(size_t min_capacity);
+
+    void append(SafetyEventTypeId event_type, double value,
+                RobotState robot_state, uint8_t severity_level);
+
+    // Copies up to max_count of the most recent committed records into out,
+    // oldest first. Returns the number of records written.
+    size_t snapshot(SafetyEventRecord* out, size_t max_count) const;
+
+    // Windows are clamped to the ring capacity. Events still being written
+    // at the window edge are not counted.
+    SeverityWindow severityOfLastEvents(size_t count) const;
+    SeverityWindow severitySince(uint64_t since_ns) const;
+
+    uint64_t totalAppended() const { return head.load(std::memory_order_acquire) & SEQUENCE_MASK; }
+    size_t capacity() const { return slot_mask + 1; }
+
+    static uint64_t nowNanoseconds();
+
+private:
+    // head packs the event sequence (low 40 bits) with the running severity
+    // total mod 2^24 (high 24 bits) so one fetch_add claims both.
+    static constexpr int SEVERITY_SHIFT = 40;
+    static constexpr uint64_t SEQUENCE_MASK = (uint64_t(1) << SEVERITY_SHIFT) - 1;
+    static constexpr uint64_t SEVERITY_MASK = (uint64_t(1) << (64 - SEVERITY_SHIFT)) - 1;
+
+    struct Slot {
+        std::atomic<uint64_t> sequence;     // odd while writing, (seq + 1) * 2 once committed
+        std::atomic<uint64_t> timestamp_ns;
+        std::atomic<uint64_t> value_bits;
+        std::atomic<uint64_t> packed_meta;  // type | state << 16 | severity << 24 | cumulative << 32
+    };
+
+    bool readSlot(uint64_t sequence, SafetyEventRecord& out) const;
+    // Severity total of the first `count` events, searching forward past
+    // slots that are still being written. Returns the count it settled on.
+    uint64_t prefixSeverity(uint64_t count, uint64_t end, uint64_t& prefix) const;
+    SeverityWindow windowFrom(uint64_t first, uint64_t end_word) const;
+
+    std::unique_ptr<Slot[]> slots;
+    size_t slot_mask;
+    alignas(64) std::atomic<uint64_t> head;
+};
+
+#endif // SAFETY_EVENT_LOG_H
@@ -1,35 +1,144 @@
 #include "safety_monitor.h"
-#include <iostream>
+#include "async_logger.h"
 #include <fstream>
 #include <algorithm>
 #include <cmath>
 #include <limits>
 
-SurgicalSafetyMonitor::SurgicalSafetyMonitor() : emergency_stop_engaged(false) {
-    initializeSafetyParameters();
-}
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
 
-void SurgicalSafetyMonitor::initializeSafetyParameters() {
-    // Initialize with Ethicon surgical robot specifications
-    joint_limits = {-180.0, 180.0, -90.0, 90.0, -120.0, 120.0, -150.0, 150.0};
-    force_limits = {MAX_FORCE_NEWTONS, MAX_FORCE_NEWTONS, MAX_FORCE_NEWTONS};
-    velocity_limits = {MAX_VELOCITY_MM_PER_SEC, MAX_VELOCITY_MM_PER_SEC, MAX_VELOCITY_MM_PER_SEC};
+const LogSite MONITOR_INITIALIZED{LogLevel::Info, "SafetyMonitor", "Safety Monitor Initialized with IEC 62304 Compliance"};
+const LogSite EMERGENCY_STOP{LogLevel::Critical, "SafetyMonitor", "EMERGENCY STOP: {}"};
+const LogSite FORCE_REDUCTION{LogLevel::Warning, "SafetyMonitor", "Force reduction: {}N exceeds {}N limit"};
+const LogSite HARDWARE_STOP{LogLevel::Critical, "SafetyMonitor", "Sending STOP command to surgical robot hardware..."};
+
+// Marks every sample whose channel value lies outside [lower[c], upper[c]].
+// Clamps with min/max and compares against the input, two samples per SSE2
+// register; NaN never survives the clamp, so it is reported as a violation.
+void markLimitViolations(const SampleBlock& block, const double* lower, const double* upper,
+                         uint32_t* violation_masks) {
+    std::fill(violation_masks, violation_masks + block.sample_count, 0u);
     
-    std::cout << "Safety Monitor Initialized with IEC 62304 Compliance" << std::endl;
+    for(size_t c = 0; c < block.channel_count; ++c) {
+        const double* values = block.data + c * block.stride;
+        const uint32_t bit = 1u << c;
+        size_t s = 0;
+        
+#if defined(__SSE2__)
+        const __m128d lo = _mm_set1_pd(lower[c]);
+        const __m128d hi = _mm_set1_pd(upper[c]);
+        for(; s + 2 <= block.sample_count; s += 2) {
+            __m128d x = _mm_loadu_pd(values + s);
+            __m128d clamped = _mm_max_pd(_mm_min_pd(x, hi), lo);
+            int outside = _mm_movemask_pd(_mm_cmpneq_pd(x, clamped));
+            violation_masks[s] |= (outside & 1) ? bit : 0u;
+            violation_masks[s + 1] |= (outside & 2) ? bit : 0u;
+        }
+#endif
+        for(; s < block.sample_count; ++s) {
+            double x = values[s];
+            bool inside = x >= lower[c] && x <= upper[c];
+            violation_masks[s] |= inside ? 0u : bit;
+        }
+    }
+}
+
+BatchValidationResult summarizeViolations(const uint32_t* violation_masks, size_t sample_count) {
+    BatchValidationResult result{0, sample_count};
+    for(size_t s = 0; s < sample_count; ++s) {
+        if(violation_masks[s] != 0) {
+            if(result.violation_count == 0) result.first_violation_index = s;
+            ++result.violation_count;
+        }
+    }
+    return result;
+}
+
+BatchValidationResult rejectWholeBlock(uint32_t* violation_masks, size_t sample_count) {
+    std::fill(violation_masks, violation_masks + sample_count, ~0u);
+    return {sample_count, 0, true};
+}
+
+// Index of the lowest violating channel in a mask
+size_t firstChannel(uint32_t mask) {
+    size_t channel = 0;
+    while(!(mask & 1u)) {
+        mask >>= 1;
+        ++channel;
+    }
+    return channel;
+}
+
+} // namespace
+
+SurgicalSafetyMonitor::SurgicalSafetyMonitor(const RobotParameters& parameters)
+    : emergency_stop_engaged(false),
+      fixed_parameters(parameters),
+      parameter_store(nullptr),
+      safety_event_log(MAX_SAFETY_EVENTS),
+      wall_clock_origin(std::chrono::system_clock::now()),
+      steady_clock_origin_ns(SafetyEventLog::nowNanoseconds()) {
+    logMessage(MONITOR_INITIALIZED);
+}
+
+bool SurgicalSafetyMonitor::attachParameterStore(ParameterStore& store) {
+    std::lock_guard<std::mutex> lock(safety_mutex);
+    if(!parameter_reader.attach(store)) return false;
+    parameter_store = &store;
+    return true;
+}
+
+void SurgicalSafetyMonitor::detachParameterStore() {
+    std::lock_guard<std::mutex> lock(safety_mutex);
+    parameter_reader.detach();
+    parameter_store = nullptr;
+}
+
+std::vector<double> SurgicalSafetyMonitor::getCurrentLimits() const {
+    std::lock_guard<std::mutex> lock(safety_mutex);
+    const RobotParameters& limits = currentParameters();
+    return std::vector<double>(limits.max_force_newtons, limits.max_force_newtons + limits.force_channel_count);
+}
+
+size_t SurgicalSafetyMonitor::getJointChannelCount() const {
+    std::lock_guard<std::mutex> lock(safety_mutex);
+    return currentParameters().joint_count;
+}
+
+size_t SurgicalSafetyMonitor::getForceChannelCount() const {
+    std::lock_guard<std::mutex> lock(safety_mutex);
+    return currentParameters().force_channel_count;
+}
+
+uint64_t SurgicalSafetyMonitor::getParametersVersion() const {
+    std::lock_guard<std::mutex> lock(safety_mutex);
+    return currentParameters().version;
+}
+
+const RobotParameters& SurgicalSafetyMonitor::currentParameters() const {
+    if(!parameter_reader.isAttached()) return fixed_parameters;
+    // No block from an earlier check is still in use: they all ran under safety_mutex
+    parameter_reader.quiescent();
+    return parameter_reader.get();
 }
 
 bool SurgicalSafetyMonitor::validateJointPosition(const std::vector<double>& positions) {
     std::lock_guard<std::mutex> lock(safety_mutex);
+    const RobotParameters& limits = currentParameters();
     
-    if(positions.size() * 2 != joint_limits.size()) {
-        logSafetyEvent("INVALID_JOINT_DATA", static_cast<double>(positions.size()));
+    if(positions.size() != limits.joint_count) {
+        logSafetyEvent(SafetyEventType::InvalidJointData, static_cast<double>(positions.size()));
         return false;
     }
     
     for(size_t i = 0; i < positions.size(); ++i) {
-        if(positions[i] < joint_limits[i*2] || positions[i] > joint_limits[i*2+1]) {
-            triggerEmergencyStop("JOINT_LIMIT_EXCEEDED");
-            logSafetyEvent("JOINT_SAFETY_VIOLATION", positions[i]);
+        if(positions[i] < limits.joint_min_degrees[i] || positions[i] > limits.joint_max_degrees[i]) {
+            engageEmergencyStop("JOINT_LIMIT_EXCEEDED");
+            logSafetyEvent(SafetyEventType::JointSafetyViolation, positions[i]);
             return false;
         }
     }
@@ -38,26 +147,34 @@ bool SurgicalSafetyMonitor::validateJointPosition(const std::vector<double>& pos
 
 bool SurgicalSafetyMonitor::validateForceReadings(const std::vector<double>& forces) {
     std::lock_guard<std::mutex> lock(safety_mutex);
+    const RobotParameters& limits = currentParameters();
+    
+    if(forces.size() > limits.force_channel_count) return false;
     
     for(size_t i = 0; i < forces.size(); ++i) {
-        if(forces[i] > force_limits[i]) {
-            triggerForceReduction(forces[i], force_limits[i]);
-            logSafetyEvent("EXCESSIVE_FORCE", forces[i]);
+        if(forces[i] > limits.max_force_newtons[i]) {
+            triggerForceReduction(forces[i], limits.max_force_newtons[i]);
+            logSafetyEvent(SafetyEventType::ExcessiveForce, forces[i]);
             return false;
         }
         
         // Check for rapid force changes (potential tissue damage)
-        if(i > 0 && std::abs(forces[i] - forces[i-1]) > 5.0) {
-            logSafetyEvent("RAPID_FORCE_CHANGE", std::abs(forces[i] - forces[i-1]));
+        if(i > 0 && std::abs(forces[i] - forces[i-1]) > limits.rapid_force_change_newtons) {
+            logSafetyEvent(SafetyEventType::RapidForceChange, std::abs(forces[i] - forces[i-1]));
         }
     }
     return true;
 }
 
 bool SurgicalSafetyMonitor::validateVelocity(const std::vector<double>& velocities) {
+    ParameterPin pin(parameter_store, fixed_parameters);
+    const RobotParameters& limits = pin.get();
+    
+    if(velocities.size() > RobotParameters::VELOCITY_CHANNELS) return false;
+    
     for(size_t i = 0; i < velocities.size(); ++i) {
-        if(std::abs(velocities[i]) > velocity_limits[i]) {
-            logSafetyEvent("EXCESSIVE_VELOCITY", velocities[i]);
+        if(std::abs(velocities[i]) > limits.max_velocity_mm_per_sec[i]) {
+            logSafetyEvent(SafetyEventType::ExcessiveVelocity, velocities[i]);
             return false;
         }
     }
@@ -66,98 +183,211 @@ bool SurgicalSafetyMonitor::validateVelocity(const std::vector<double>& velociti
 
 bool SurgicalSafetyMonitor::checkCollisionRisk(const std::vector<double>& positions,
                                              const std::vector<std::vector<double>>& obstacles) {
-    // Simplified collision detection - in practice would use 3D geometry
+    // Simplified collision detection - in practice would use 3D geometry.
+    // Compared on squared distance; the root is only taken for the log entry.
+    ParameterPin pin(parameter_store, fixed_parameters);
+    const double min_safe = pin.get().min_safe_distance_mm;
+    const double min_safe_sq = min_safe * min_safe;
     for(const auto& obstacle : obstacles) {
         if(obstacle.size() != positions.size()) continue;
         
         double distance_sq = 0.0;
         for(size_t i = 0; i < positions.size(); ++i) {
-            distance_sq += std::pow(positions[i] - obstacle[i], 2);
+            double delta = positions[i] - obstacle[i];
+            distance_sq += delta * delta;
         }
         
-        double distance = std::sqrt(distance_sq);
-        if(distance < MIN_SAFE_DISTANCE_MM) {
-            logSafetyEvent("COLLISION_IMMINENT", distance);
+        if(distance_sq < min_safe_sq) {
+            logSafetyEvent(SafetyEventType::CollisionImminent, std::sqrt(distance_sq));
             return true;
         }
     }
     return false;
 }
 
+bool SurgicalSafetyMonitor::checkCollisionRisk(const Eigen::Vector3d& position, const ObstacleCloudSoA& obstacles) {
+    float distance_sq = obstacles.minSquaredDistance(position);
+    ParameterPin pin(parameter_store, fixed_parameters);
+    const double min_safe = pin.get().min_safe_distance_mm;
+    if(distance_sq < min_safe * min_safe) {
+        logSafetyEvent(SafetyEventType::CollisionImminent, std::sqrt(static_cast<double>(distance_sq)));
+        return true;
+    }
+    return false;
+}
+
+BatchValidationResult SurgicalSafetyMonitor::validateJointPositionBatch(const SampleBlock& positions,
+                                                                      uint32_t* violation_masks) {
+    std::lock_guard<std::mutex> lock(safety_mutex);
+    const RobotParameters& limits = currentParameters();
+    
+    if(positions.sample_count == 0 || positions.channel_count != limits.joint_count) {
+        logSafetyEvent(SafetyEventType::InvalidJointData, static_cast<double>(positions.channel_count));
+        return rejectWholeBlock(violation_masks, positions.sample_count);
+    }
+    
+    markLimitViolations(positions, limits.joint_min_degrees, limits.joint_max_degrees, violation_masks);
+    BatchValidationResult result = summarizeViolations(violation_masks, positions.sample_count);
+    
+    if(!result.isValid()) {
+        size_t sample = result.first_violation_index;
+        size_t channel = firstChannel(violation_masks[sample]);
+        engageEmergencyStop("JOINT_LIMIT_EXCEEDED");
+        logSafetyEvent(SafetyEventType::JointSafetyViolation,
+                       positions.data[channel * positions.stride + sample]);
+    }
+    return result;
+}
+
+BatchValidationResult SurgicalSafetyMonitor::validateForceReadingsBatch(const SampleBlock& forces,
+                                                                      uint32_t* violation_masks) {
+    std::lock_guard<std::mutex> lock(safety_mutex);
+    const RobotParameters& limits = currentParameters();
+    
+    if(forces.sample_count == 0 || forces.channel_count == 0 || forces.channel_count > limits.force_channel_count) {
+        logSafetyEvent(SafetyEventType::InvalidJointData, static_cast<double>(forces.channel_count));
+        return rejectWholeBlock(violation_masks, forces.sample_count);
+    }
+    
+    double lower[RobotParameters::MAX_FORCE_CHANNELS];
+    for(size_t c = 0; c < forces.channel_count; ++c) {
+        lower[c] = -std::numeric_limits<double>::infinity();
+    }
+    
+    markLimitViolations(forces, lower, limits.max_force_newtons, violation_masks);
+    BatchValidationResult result = summarizeViolations(violation_masks, forces.sample_count);
+    
+    if(!result.isValid()) {
+        size_t sample = result.first_violation_index;
+        size_t channel = firstChannel(violation_masks[sample]);
+        double force = forces.data[channel * forces.stride + sample];
+        triggerForceReduction(force, limits.max_force_newtons[channel]);
+        logSafetyEvent(SafetyEventType::ExcessiveForce, force);
+    }
+    return result;
+}
+
+BatchValidationResult SurgicalSafetyMonitor::validateVelocityBatch(const SampleBlock& velocities,
+                                                                 uint32_t* violation_masks) {
+    std::lock_guard<std::mutex> lock(safety_mutex);
+    const RobotParameters& limits = currentParameters();
+    
+    if(velocities.sample_count == 0 || velocities.channel_count == 0 ||
+       velocities.channel_count > RobotParameters::VELOCITY_CHANNELS) {
+        logSafetyEvent(SafetyEventType::InvalidJointData, static_cast<double>(velocities.channel_count));
+        return rejectWholeBlock(violation_masks, velocities.sample_count);
+    }
+    
+    double lower[RobotParameters::VELOCITY_CHANNELS];
+    for(size_t c = 0; c < velocities.channel_count; ++c) {
+        lower[c] = -limits.max_velocity_mm_per_sec[c];
+    }
+    
+    markLimitViolations(velocities, lower, limits.max_velocity_mm_per_sec, violation_masks);
+    BatchValidationResult result = summarizeViolations(violation_masks, velocities.sample_count);
+    
+    if(!result.isValid()) {
+        size_t sample = result.first_violation_index;
+        size_t channel = firstChannel(violation_masks[sample]);
+        logSafetyEvent(SafetyEventType::ExcessiveVelocity,
+                       velocities.data[channel * velocities.stride + sample]);
+    }
+    return result;
+}
+
 void SurgicalSafetyMonitor::triggerEmergencyStop(const std::string& reason) {
     std::lock_guard<std::mutex> lock(safety_mutex);
+    engageEmergencyStop(reason);
+}
+
+void SurgicalSafetyMonitor::engageEmergencyStop(const std::string& reason) {
     emergency_stop_engaged = true;
     
-    logSafetyEvent("EMERGENCY_STOP_TRIGGERED", 0.0);
-    std::cout << "EMERGENCY STOP: " << reason << std::endl;
+    logSafetyEvent(SafetyEventType::EmergencyStopTriggered, 0.0);
+    logMessage(EMERGENCY_STOP, reason);
     
     sendStopCommandToHardware();
 }
 
 void SurgicalSafetyMonitor::triggerForceReduction(double current_force, double max_force) {
-    logSafetyEvent("FORCE_REDUCTION_APPLIED", current_force);
-    std::cout << "Force reduction: " << current_force << "N exceeds " << max_force << "N limit" << std::endl;
+    logSafetyEvent(SafetyEventType::ForceReductionApplied, current_force);
+    logMessage(FORCE_REDUCTION, current_force, max_force);
 }
 
 void SurgicalSafetyMonitor::resumeNormalOperation() {
     std::lock_guard<std::mutex> lock(safety_mutex);
     emergency_stop_engaged = false;
-    logSafetyEvent("NORMAL_OPERATION_RESUMED", 0.0);
+    logSafetyEvent(SafetyEventType::NormalOperationResumed, 0.0);
 }
 
 void SurgicalSafetyMonitor::logSafetyEvent(const std::string& event_type, double value) {
-    SafetyEvent event;
-    event.timestamp = std::chrono::system_clock::now();
-    event.event_type = event_type;
-    event.value = value;
-    event.robot_state = getCurrentRobotState();
-    event.severity_level = (event_type.find("EMERGENCY") != std::string::npos) ? 5 : 3;
-    
-    safety_event_queue.push(event);
-    
-    // Maintain queue size - fix signed/unsigned comparison
-    if(safety_event_queue.size() > static_cast<size_t>(MAX_SAFETY_EVENTS)) {
-        safety_event_queue.pop();
-    }
+    appendSafetyEvent(SafetyEventTypeRegistry::instance().intern(event_type), value);
+}
+
+void SurgicalSafetyMonitor::logSafetyEvent(SafetyEventType event_type, double value) {
+    appendSafetyEvent(static_cast<SafetyEventTypeId>(event_type), value);
+}
+
+void SurgicalSafetyMonitor::appendSafetyEvent(SafetyEventTypeId event_type, double value) {
+    // Lock-free and allocation-free; safe to call with or without safety_mutex held
+    safety_event_log.append(event_type, value, getCurrentRobotState(),
+                            SafetyEventTypeRegistry::instance().severity(event_type));
 }
 
 std::vector<SafetyEvent> SurgicalSafetyMonitor::getRecentSafetyEvents(int count) {
-    std::lock_guard<std::mutex> lock(safety_mutex);
-    std::vector<SafetyEvent> recent_events;
+    if(count <= 0) return {};
+    
+    std::vector<SafetyEventRecord> records(static_cast<size_t>(count));
+    records.resize(safety_event_log.snapshot(records.data(), records.size()));
     
-    // Create temporary queue to access elements
-    std::queue<SafetyEvent> temp_queue = safety_event_queue;
-    int events_to_get = std::min(count, static_cast<int>(temp_queue.size()));
+    const auto& registry = SafetyEventTypeRegistry::instance();
+    std::vector<SafetyEvent> recent_events;
+    recent_events.reserve(records.size());
     
-    for(int i = 0; i < events_to_get; ++i) {
-        recent_events.push_back(temp_queue.front());
-        temp_queue.pop();
+    for(const auto& record : records) {
+        SafetyEvent event;
+        event.timestamp = wall_clock_origin + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(record.timestamp_ns - steady_clock_origin_ns));
+        event.event_type = registry.name(record.event_type);
+        event.value = record.value;
+        event.robot_state = robotStateName(record.robot_state);
+        event.severity_level = record.severity_level;
+        recent_events.push_back(event);
     }
     
     return recent_events;
 }
 
 double SurgicalSafetyMonitor::calculateOverallSafetyScore() const {
-    // Calculate safety score based on recent events
-    // Create a temporary non-const copy for getRecentSafetyEvents call
-    SurgicalSafetyMonitor* non_const_this = const_cast<SurgicalSafetyMonitor*>(this);
-    auto recent_events = non_const_this->getRecentSafetyEvents(100);
-    
-    if(recent_events.empty()) return 100.0;
-    
-    double penalty_score = 0.0;
-    for(const auto& event : recent_events) {
-        penalty_score += event.severity_level * 0.5;
-    }
+    // Calculate safety score based on the last 100 events
+    return calculateSafetyScoreForLastEvents(100);
+}
+
+double SurgicalSafetyMonitor::calculateSafetyScoreForLastEvents(size_t event_count) const {
+    // O(1): difference of two running severity totals kept by the event log
+    return scoreFromWindow(safety_event_log.severityOfLastEvents(event_count));
+}
+
+double SurgicalSafetyMonitor::calculateSafetyScoreForLastSeconds(double seconds) const {
+    uint64_t now_ns = SafetyEventLog::nowNanoseconds();
+    uint64_t window_ns = static_cast<uint64_t>(std::max(0.0, seconds) * 1e9);
+    uint64_t since_ns = window_ns < now_ns ? now_ns - window_ns : 0;
+    return scoreFromWindow(safety_event_log.severitySince(since_ns));
+}
+
+double SurgicalSafetyMonitor::scoreFromWindow(const SeverityWindow& window) {
+    if(window.event_count == 0) return 100.0;
     
+    double penalty_score = window.severity_sum * 0.5;
     return std::max(0.0, 100.0 - penalty_score);
 }
 
 void SurgicalSafetyMonitor::sendStopCommandToHardware() {
     // In real implementation, this would interface with robot hardware
-    std::cout << "Sending STOP command to surgical robot hardware..." << std::endl;
+    logMessage(HARDWARE_STOP);
 }
 
-std::string SurgicalSafetyMonitor::getCurrentRobotState() const {
-    return emergency_stop_engaged ? "EMERGENCY_STOP" : "OPERATIONAL";
+RobotState SurgicalSafetyMonitor::getCurrentRobotState() const {
+    return emergency_stop_engaged.load(std::memory_order_relaxed) ? RobotState::EmergencyStop
+                                                                  : RobotState::Operational;
 }
@@ -5,7 +5,11 @@
 #include <string>
 #include <chrono>
 #include <mutex>
-#include <queue>
+#include <atomic>
+#include <eigen3/Eigen/Dense>
+#include "safety_event_log.h"
+#include "obstacle_cloud.h"
+#include "parameter_store.h"
 
 struct SafetyEvent {
     std::chrono::system_clock::time_point timestamp;
@@ -15,31 +19,76 @@ struct SafetyEvent {
     int severity_level; // 1-5, 5 being most critical
 };
 
+// Structure-of-arrays block of buffered sensor samples: channel c of
+// sample s lives at data[c * stride + s].
+struct SampleBlock {
+    const double* data;
+    size_t channel_count;
+    size_t sample_count;
+    size_t stride;
+};
+
+struct BatchValidationResult {
+    size_t violation_count;         // samples with at least one channel out of limits
+    size_t first_violation_index;   // sample_count when the block is clean
+    bool invalid_input = false;     // empty block or channel count the limits do not cover
+    
+    bool isValid() const { return !invalid_input && violation_count == 0; }
+};
+
+// Limits come from a RobotParameters block: a fixed one given at
+// construction, or the current block of an attached ParameterStore. With a
+// store the monitor is a ParameterReader whose quiescent points are the
+// starts of its checks, which safety_mutex already serializes, so a newly
+// published block applies from the next check on. validateVelocity() and
+// checkCollisionRisk() only read limits and log, so they skip safety_mutex
+// and pin the current block for the duration of the call instead.
 class SurgicalSafetyMonitor {
 private:
-    std::mutex safety_mutex;
-    bool emergency_stop_engaged;
-    std::vector<double> joint_limits;
-    std::vector<double> force_limits;
-    std::vector<double> velocity_limits;
-    std::queue<SafetyEvent> safety_event_queue;
+    mutable std::mutex safety_mutex;
+    std::atomic<bool> emergency_stop_engaged;
+    RobotParameters fixed_parameters;
+    mutable ParameterReader parameter_reader;
+    ParameterStore* parameter_store;    // for the lock-free checks, nullptr when fixed
+    SafetyEventLog safety_event_log;
+    
+    // Maps steady_clock event timestamps back to wall-clock time for reports
+    std::chrono::system_clock::time_point wall_clock_origin;
+    uint64_t steady_clock_origin_ns;
     
-    // IEC 62304 Critical Safety Parameters
-    const double MAX_FORCE_NEWTONS = 15.0;
-    const double MAX_VELOCITY_MM_PER_SEC = 50.0;
-    const double MIN_SAFE_DISTANCE_MM = 2.0;
-    const int MAX_SAFETY_EVENTS = 10000;
+    static constexpr int MAX_SAFETY_EVENTS = 10000;
     
 public:
-    SurgicalSafetyMonitor();
+    explicit SurgicalSafetyMonitor(const RobotParameters& parameters = defaultRobotParameters());
     ~SurgicalSafetyMonitor() = default;
     
+    // Follow the store's current block instead of the fixed one. Not while
+    // checks are running on another thread.
+    bool attachParameterStore(ParameterStore& store);
+    void detachParameterStore();
+    
     // Core safety validation methods
     bool validateJointPosition(const std::vector<double>& positions);
     bool validateForceReadings(const std::vector<double>& forces);
     bool validateVelocity(const std::vector<double>& velocities);
     bool checkCollisionRisk(const std::vector<double>& positions, 
                           const std::vector<std::vector<double>>& obstacles);
+    // 3D Cartesian variant over a prepared float SoA obstacle cloud; build
+    // the cloud once per obstacle update rather than per check
+    bool checkCollisionRisk(const Eigen::Vector3d& position, const ObstacleCloudSoA& obstacles);
+    
+    // Batch validation of a whole sensor burst under one lock. violation_masks
+    // must hold sample_count entries; bit c is set when channel c of that
+    // sample is out of limits (at most 32 channels). The safety reaction of
+    // the single-sample API is applied once, for the first violating sample.
+    // An empty block or one with the wrong channel count is invalid input:
+    // every sample is marked and InvalidJointData is logged.
+    BatchValidationResult validateJointPositionBatch(const SampleBlock& positions,
+                                                     uint32_t* violation_masks);
+    BatchValidationResult validateForceReadingsBatch(const SampleBlock& forces,
+                                                     uint32_t* violation_masks);
+    BatchValidationResult validateVelocityBatch(const SampleBlock& velocities,
+                                                uint32_t* violation_masks);
     
     // Emergency procedures
     void triggerEmergencyStop(const std::string& reason);
@@ -48,17 +97,27 @@ public:
     
     // Monitoring and logging
     void logSafetyEvent(const std::string& event_type, double value = 0.0);
+    void logSafetyEvent(SafetyEventType event_type, double value = 0.0);
     std::vector<SafetyEvent> getRecentSafetyEvents(int count = 10);
     double calculateOverallSafetyScore() const;
+    double calculateSafetyScoreForLastEvents(size_t event_count) const;
+    double calculateSafetyScoreForLastSeconds(double seconds) const;
     
     // Getters
-    bool isEmergencyStopEngaged() const { return emergency_stop_engaged; }
-    std::vector<double> getCurrentLimits() const { return force_limits; }
+    bool isEmergencyStopEngaged() const { return emergency_stop_engaged.load(std::memory_order_acquire); }
+    std::vector<double> getCurrentLimits() const;
+    size_t getJointChannelCount() const;
+    size_t getForceChannelCount() const;
+    size_t getVelocityChannelCount() const { return RobotParameters::VELOCITY_CHANNELS; }
+    uint64_t getParametersVersion() const;
     
 private:
+    void engageEmergencyStop(const std::string& reason); // caller holds safety_mutex
     void sendStopCommandToHardware();
-    void initializeSafetyParameters();
-    std::string getCurrentRobotState() const;
+    const RobotParameters& currentParameters() const; // caller holds safety_mutex
+    void appendSafetyEvent(SafetyEventTypeId event_type, double value);
+    RobotState getCurrentRobotState() const;
+    static double scoreFromWindow(const SeverityWindow& window);
 };
 
 #endif // SAFETY_MONITOR_H
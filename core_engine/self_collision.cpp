@@ -0,0 +1,119 @@
+#include "self_collision.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+double segmentSegmentDistance(const Eigen::Vector3d& p1, const Eigen::Vector3d& q1,
+                              const Eigen::Vector3d& p2, const Eigen::Vector3d& q2) {
+    // Closest points of two segments (Ericson, Real-Time Collision Detection 5.1.9)
+    const double epsilon = 1e-12;
+    Eigen::Vector3d d1 = q1 - p1;
+    Eigen::Vector3d d2 = q2 - p2;
+    Eigen::Vector3d r = p1 - p2;
+    double a = d1.squaredNorm();
+    double e = d2.squaredNorm();
+    double f = d2.dot(r);
+    double s, t;
+    
+    if (a <= epsilon && e <= epsilon) {
+        return r.norm();
+    }
+    if (a <= epsilon) {
+        s = 0.0;
+        t = std::clamp(f / e, 0.0, 1.0);
+    } else {
+        double c = d1.dot(r);
+        if (e <= epsilon) {
+            t = 0.0;
+            s = std::clamp(-c / a, 0.0, 1.0);
+        } else {
+            double b = d1.dot(d2);
+            double denominator = a * e - b * b;
+            s = denominator > epsilon ? std::clamp((b * f - c * e) / denominator, 0.0, 1.0) : 0.0;
+            t = (b * s + f) / e;
+            if (t < 0.0) {
+                t = 0.0;
+                s = std::clamp(-c / a, 0.0, 1.0);
+            } else if (t > 1.0) {
+                t = 1.0;
+                s = std::clamp((b - c) / a, 0.0, 1.0);
+            }
+        }
+    }
+    
+    return ((p1 + d1 * s) - (p2 + d2 * t)).norm();
+}
+
+SelfCollisionChecker::SelfCollisionChecker(size_t body_count) : narrowphase_tests(0) {
+    resize(body_count);
+}
+
+void SelfCollisionChecker::resize(size_t body_count) {
+    bodies.assign(body_count, Capsule{Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero(), 0.0});
+    bounds.resize(body_count);
+    sweep_order.resize(body_count);
+    std::iota(sweep_order.begin(), sweep_order.end(), 0u);
+    allowed_pairs.assign(body_count * body_count, 0);
+    for (size_t i = 0; i < body_count; ++i) {
+        allowed_pairs[i * body_count + i] = 1;
+    }
+}
+
+void SelfCollisionChecker::setCollisionAllowed(size_t a, size_t b, bool allowed) {
+    allowed_pairs[a * bodies.size() + b] = allowed ? 1 : 0;
+    allowed_pairs[b * bodies.size() + a] = allowed ? 1 : 0;
+}
+
+SelfCollisionResult SelfCollisionChecker::check(double safety_margin) {
+    SelfCollisionResult result{false, -1, -1, std::numeric_limits<double>::infinity()};
+    const size_t count = bodies.size();
+    if (count < 2) return result;
+    
+    // Inflate each box by half the margin so overlapping boxes bound every
+    // pair whose surfaces are closer than the margin
+    for (size_t i = 0; i < count; ++i) {
+        const Capsule& body = bodies[i];
+        Eigen::Vector3d extent = Eigen::Vector3d::Constant(body.radius + 0.5 * safety_margin);
+        bounds[i].min = body.start.cwiseMin(body.end) - extent;
+        bounds[i].max = body.start.cwiseMax(body.end) + extent;
+    }
+    
+    // Insertion sort: nearly sorted from the previous call
+    for (size_t i = 1; i < count; ++i) {
+        uint32_t body = sweep_order[i];
+        double key = bounds[body].min[0];
+        size_t j = i;
+        while (j > 0 && bounds[sweep_order[j - 1]].min[0] > key) {
+            sweep_order[j] = sweep_order[j - 1];
+            --j;
+        }
+        sweep_order[j] = body;
+    }
+    
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t a = sweep_order[i];
+        for (size_t j = i + 1; j < count; ++j) {
+            const uint32_t b = sweep_order[j];
+            if (bounds[b].min[0] > bounds[a].max[0]) break;     // no later body overlaps a on x
+            
+            if (bounds[b].min[1] > bounds[a].max[1] || bounds[a].min[1] > bounds[b].max[1] ||
+                bounds[b].min[2] > bounds[a].max[2] || bounds[a].min[2] > bounds[b].max[2]) {
+                continue;
+            }
+            if (allowed_pairs[a * count + b]) continue;
+            
+            ++narrowphase_tests;
+            double distance = segmentSegmentDistance(bodies[a].start, bodies[a].end,
+                                                     bodies[b].start, bodies[b].end)
+                              - bodies[a].radius - bodies[b].radius;
+            if (distance < result.distance) {
+                result.distance = distance;
+                result.body_a = static_cast<int>(std::min(a, b));
+                result.body_b = static_cast<int>(std::max(a, b));
+            }
+        }
+    }
+    
+    result.collision = result.distance < safety_margin;
+    return result;
+}
@@ -0,0 +1,78 @@
+#ifndef SELF_COLLISION_H
+#define SELF_COLLISION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+
+// Swept sphere around a segment; models a robot link, instrument shaft or trocar
+struct Capsule {
+    Eigen::Vector3d start;
+    Eigen::Vector3d end;
+    double radius;
+};
+
+struct SelfCollisionResult {
+    bool collision;
+    int body_a;                     // -1 when the broadphase pruned every pair
+    int body_b;
+    double distance;                // surface distance of the closest pair (< 0 = penetration)
+};
+
+// Closest distance between segments [p1, q1] and [p2, q2]
+double segmentSegmentDistance(const Eigen::Vector3d& p1, const Eigen::Vector3d& q1,
+                              const Eigen::Vector3d& p2, const Eigen::Vector3d& q2);
+
+// Broadphase + narrowphase collision check between a set of capsules.
+// Bodies are pruned by sweep-and-prune over their margin-inflated AABBs on
+// the x axis; the sorted order is kept between calls, so with small motion
+// the insertion sort that maintains it is close to linear. Pairs marked in
+// the allowed-collision matrix (e.g. adjacent links) are never tested.
+// check() does no allocation once the body count is fixed, and no I/O.
+class SelfCollisionChecker {
+public:
+    explicit SelfCollisionChecker(size_t body_count = 0);
+
+    // Resizing clears the allowed-collision matrix
+    void resize(size_t body_count);
+    size_t size() const { return bodies.size(); }
+
+    void setBody(size_t index, const Capsule& capsule) { bodies[index] = capsule; }
+    const Capsule& getBody(size_t index) const { return bodies[index]; }
+
+    void setCollisionAllowed(size_t a, size_t b, bool allowed = true);
+    bool isCollisionAllowed(size_t a, size_t b) const { return allowed_pairs[a * bodies.size() + b] != 0; }
+
+    // Closest pair whose surfaces are within safety_margin; collision is set
+    // when that distance is below the margin. Pairs farther apart than the
+    // margin are pruned without measuring them.
+    SelfCollisionResult check(double safety_margin);
+
+    uint64_t getNarrowphaseTests() const { return narrowphase_tests; }
+
+private:
+    struct Bounds {
+        Eigen::Vector3d min;
+        Eigen::Vector3d max;
+    };
+
+    std::vector<Capsule> bodies;
+    std::vector<Bounds> bounds;
+    std::vector<uint32_t> sweep_order;      // body indices sorted by bounds.min.x
+    std::vector<uint8_t> allowed_pairs;     // symmetric body_count x body_count matrix
+    uint64_t narrowphase_tests;
+};
+
+// Writes one capsule per link between consecutive joint positions (e.g. the
+// frame origins from Kinematics::jointPositions) into bodies
+// [first_body, first_body + positions.size() - 1) of checker
+template <typename PositionContainer>
+void updateLinkCapsules(SelfCollisionChecker& checker, const PositionContainer& joint_positions,
+                        double radius, size_t first_body = 0) {
+    for (size_t i = 0; i + 1 < joint_positions.size(); ++i) {
+        checker.setBody(first_body + i, Capsule{joint_positions[i], joint_positions[i + 1], radius});
+    }
+}
+
+#endif // SELF_COLLISION_H
@@ -0,0 +1,82 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+// Single-writer, multi-reader publication of a small trivially copyable
+// value. The writer never waits: it bumps the sequence to odd, copies the
+// value in and bumps it to even again. Readers copy the value out and keep
+// it only if the sequence was even and unchanged across the copy, retrying
+// otherwise, so they never block or slow down the writer and never return
+// a torn value.
+//
+// The value is stored as relaxed atomic words so the concurrent copy is not
+// a data race; the fences order it against the sequence counter.
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock value must be trivially copyable");
+
+public:
+    SeqLock() : sequence(0) {
+        for (auto& word : words) word.store(0, std::memory_order_relaxed);
+    }
+
+    // Writer side; only one thread may call store()
+    void store(const T& value) {
+        uint64_t buffer[WORD_COUNT] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        uint64_t start = sequence.load(std::memory_order_relaxed);
+        sequence.store(start + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORD_COUNT; ++i) words[i].store(buffer[i], std::memory_order_relaxed);
+        sequence.store(start + 2, std::memory_order_release);
+    }
+
+    // Reader side. Returns false when a store() overlapped the copy.
+    bool tryLoad(T& value) const {
+        uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) return false;
+
+        uint64_t buffer[WORD_COUNT];
+        for (size_t i = 0; i < WORD_COUNT; ++i) buffer[i] = words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != before) return false;
+
+        std::memcpy(&value, buffer, sizeof(T));
+        return true;
+    }
+
+    // Retries until a consistent copy is read. A store() takes well under a
+    // microsecond, so this spins briefly and only yields under contention.
+    T load() const {
+        T value;
+        unsigned attempts = 0;
+        while (!tryLoad(value)) {
+            if (++attempts < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#endif
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        return value;
+    }
+
+    // Number of completed store() calls
+    uint64_t version() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> words[WORD_COUNT];
+};
+
+#endif // SEQLOCK_H
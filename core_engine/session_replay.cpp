@@ -0,0 +1,287 @@
+#include "session_replay.h"
+#include "async_logger.h"
+#include "flight_recorder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <thread>
+
+namespace {
+
+const LogSite CHUNK_UNREADABLE{LogLevel::Error, "SessionReplay", "Cannot read chunk '{}', session {} replayed partially"};
+const LogSite REPLAY_FINISHED{LogLevel::Info, "SessionReplay", "Replayed {} sessions, {} samples in {}s on {} threads"};
+
+// Kinematics works in metres, the collision detector in millimetres
+constexpr double MILLIMETRES_PER_METRE = 1000.0;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+std::vector<ReplaySession> findReplaySessions(const std::string& directory) {
+    // Chunk indices grow across sessions, so first appearance orders them
+    std::vector<ReplaySession> sessions;
+    std::map<uint64_t, size_t> session_slots;
+    for (const FlightChunkInfo& chunk : listFlightChunks(directory)) {
+        auto slot = session_slots.find(chunk.session_id);
+        if (slot == session_slots.end()) {
+            slot = session_slots.emplace(chunk.session_id, sessions.size()).first;
+            sessions.push_back(ReplaySession{chunk.session_id, {}, 0});
+        }
+        ReplaySession& session = sessions[slot->second];
+        session.chunk_paths.push_back(chunk.path);
+        session.record_count += chunk.record_count;
+    }
+    return sessions;
+}
+
+SessionReplayer::SessionReplayer(const ReplayOptions& options, uint64_t session_id)
+    : options(options), monitor(options.parameters), kinematics(options.parameters.dh_parameters), result{} {
+    this->options.block_samples = std::max<size_t>(this->options.block_samples, 1);
+    result.session_id = session_id;
+    result.complete = true;
+    result.min_obstacle_distance = std::numeric_limits<double>::infinity();
+
+    if (!options.obstacles.empty()) detector.setObstacles(options.obstacles);
+    detector.setSafetyMargins(options.min_safe_distance > 0.0 ? options.min_safe_distance : options.parameters.min_safe_distance_mm,
+                              options.warning_distance > 0.0 ? options.warning_distance : options.parameters.warning_distance_mm);
+    if (options.link_radius > 0.0) detector.setLinkRadius(options.link_radius);
+
+    const size_t block = this->options.block_samples;
+    positions.resize(RobotStateSnapshot::MAX_JOINTS * block);
+    velocities.resize(RobotStateSnapshot::MAX_JOINTS * block);
+    forces.resize(RobotStateSnapshot::MAX_FORCE_CHANNELS * block);
+    violation_masks.resize(block);
+    for (auto& axis : tips) axis.resize(block);
+    link_points.reserve(Solver::dof() + 1);
+    pending.reserve(2 * block);
+}
+
+void SessionReplayer::process(const RobotStateSnapshot* samples, size_t count) {
+    pending.insert(pending.end(), samples, samples + count);
+    processRuns(false);
+}
+
+SessionReplayResult SessionReplayer::finish() {
+    processRuns(true);
+    result.final_safety_score = monitor.calculateOverallSafetyScore();
+    return result;
+}
+
+void SessionReplayer::processRuns(bool flush) {
+    // A block is a run of samples with the same channel counts, at most
+    // block_samples long. Where a block ends depends only on the samples,
+    // never on how they were fed in.
+    size_t begin = 0;
+    while (begin < pending.size()) {
+        const RobotStateSnapshot& first = pending[begin];
+        size_t limit = std::min(pending.size(), begin + options.block_samples);
+        size_t end = begin + 1;
+        while (end < limit && pending[end].joint_count == first.joint_count &&
+               pending[end].force_count == first.force_count) {
+            ++end;
+        }
+        if (!flush && end == pending.size() && end - begin < options.block_samples) break;
+        processBlock(&pending[begin], end - begin);
+        begin = end;
+    }
+
+    pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(begin));
+}
+
+void SessionReplayer::processBlock(const RobotStateSnapshot* samples, size_t count) {
+    const RobotStateSnapshot& first = samples[0];
+    if (monitor.isEmergencyStopEngaged() && !first.emergency_stop) monitor.resumeNormalOperation();
+    const bool stopped_before = monitor.isEmergencyStopEngaged();
+
+    const size_t joints = std::min<size_t>(first.joint_count, RobotStateSnapshot::MAX_JOINTS);
+    const size_t force_channels = std::min<size_t>(first.force_count, RobotStateSnapshot::MAX_FORCE_CHANNELS);
+    for (size_t c = 0; c < joints; ++c) {
+        for (size_t s = 0; s < count; ++s) {
+            positions[c * count + s] = samples[s].joint_positions[c];
+            velocities[c * count + s] = samples[s].joint_velocities[c];
+        }
+    }
+    for (size_t c = 0; c < force_channels; ++c) {
+        for (size_t s = 0; s < count; ++s) forces[c * count + s] = samples[s].force_readings[c];
+    }
+
+    if (joints > 0) {
+        BatchValidationResult checked = monitor.validateJointPositionBatch(
+            SampleBlock{positions.data(), joints, count, count}, violation_masks.data());
+        countViolations(checked, samples,
+                        joints == monitor.getJointChannelCount() ? result.joint_limit_violations : result.invalid_joint_data);
+    }
+    // Channels the monitor has no limits for are not checked
+    size_t checked_forces = std::min(force_channels, monitor.getForceChannelCount());
+    if (checked_forces > 0) {
+        countViolations(monitor.validateForceReadingsBatch(SampleBlock{forces.data(), checked_forces, count, count},
+                                                           violation_masks.data()),
+                        samples, result.force_violations);
+    }
+    size_t checked_velocities = std::min(joints, monitor.getVelocityChannelCount());
+    if (checked_velocities > 0) {
+        countViolations(monitor.validateVelocityBatch(SampleBlock{velocities.data(), checked_velocities, count, count},
+                                                      violation_masks.data()),
+                        samples, result.velocity_violations);
+    }
+
+    if (joints == static_cast<size_t>(Solver::dof())) {
+        Solver::ConfigurationBlock configurations;
+        for (int j = 0; j < Solver::dof(); ++j) configurations.joints[j] = positions.data() + j * count;
+        configurations.count = count;
+        kinematics.forwardKinematicsBatch(configurations, Solver::PositionBlock{tips[0].data(), tips[1].data(), tips[2].data()},
+                                          0, count);
+        checkGeometry(samples, count);
+    } else {
+        result.kinematics_failures += count;
+        noteViolation(first.cycle);
+    }
+
+    if (!stopped_before && monitor.isEmergencyStopEngaged()) ++result.emergency_stops;
+    result.samples += count;
+}
+
+void SessionReplayer::checkGeometry(const RobotStateSnapshot* samples, size_t count) {
+    std::array<Solver::Vector3, Solver::dof() + 1> frame_origins{};
+    for (size_t s = 0; s < count; ++s) {
+        Eigen::Vector3d tip(tips[0][s], tips[1][s], tips[2][s]);
+        if (!tip.allFinite()) {
+            ++result.kinematics_failures;
+            noteViolation(samples[s].cycle);
+            continue;
+        }
+
+        if (!options.obstacles.empty()) {
+            double distance = detector.calculateMinimumDistance(tip * MILLIMETRES_PER_METRE);
+            result.min_obstacle_distance = std::min(result.min_obstacle_distance, distance);
+            if (distance < detector.getMinSafeDistance()) {
+                ++result.collisions;
+                noteViolation(samples[s].cycle);
+            } else if (distance < detector.getWarningDistance()) {
+                ++result.collision_warnings;
+            }
+        }
+
+        if (options.check_self_collision) {
+            Solver::JointVector angles;
+            std::copy(samples[s].joint_positions, samples[s].joint_positions + Solver::dof(), angles.begin());
+            if (kinematics.jointPositions(angles, frame_origins) != KinematicsStatus::Ok) {
+                ++result.kinematics_failures;
+                noteViolation(samples[s].cycle);
+                continue;
+            }
+            // The same links the live check sees; the detector handles
+            // coincident origins itself
+            link_points.clear();
+            for (const Solver::Vector3& origin : frame_origins) link_points.push_back(origin * MILLIMETRES_PER_METRE);
+            if (detector.checkSelfCollision(link_points)) {
+                ++result.self_collisions;
+                noteViolation(samples[s].cycle);
+            }
+        }
+    }
+}
+
+void SessionReplayer::countViolations(const BatchValidationResult& checked, const RobotStateSnapshot* samples,
+                                      uint64_t& counter) {
+    if (checked.isValid()) return;
+    counter += checked.violation_count;
+    noteViolation(samples[checked.first_violation_index].cycle);
+}
+
+void SessionReplayer::noteViolation(uint64_t cycle) {
+    if (result.first_violation_cycle == 0 || cycle < result.first_violation_cycle) result.first_violation_cycle = cycle;
+}
+
+SessionReplayResult replaySession(const ReplaySession& session, const ReplayOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    SessionReplayer replayer(options, session.session_id);
+    bool complete = true;
+    std::vector<RobotStateSnapshot> records;
+    for (const std::string& path : session.chunk_paths) {
+        records.clear();
+        if (!readFlightChunk(path, records)) {
+            logMessage(CHUNK_UNREADABLE, path, session.session_id);
+            complete = false;
+            continue;
+        }
+        replayer.process(records.data(), records.size());
+    }
+    SessionReplayResult result = replayer.finish();
+    result.complete = complete;
+    result.seconds = secondsSince(start);
+    return result;
+}
+
+ReplayReport replaySessions(const std::vector<ReplaySession>& sessions, const ReplayOptions& options) {
+    auto start = std::chrono::steady_clock::now();
+    ReplayReport report{};
+    report.sessions.resize(sessions.size());
+
+    unsigned threads = options.thread_count ? options.thread_count : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(sessions.size(), 1)));
+    report.threads = threads;
+
+    // Longest sessions first so one long session does not start last
+    std::vector<size_t> order(sessions.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sessions](size_t a, size_t b) {
+        return sessions[a].record_count > sessions[b].record_count;
+    });
+
+    // Each result goes to its session's slot, so the report does not depend on scheduling
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < order.size(); i = next.fetch_add(1)) {
+            report.sessions[order[i]] = replaySession(sessions[order[i]], options);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) workers.emplace_back(worker);
+    worker();
+    for (auto& thread : workers) thread.join();
+
+    for (const SessionReplayResult& result : report.sessions) report.total_samples += result.samples;
+    report.wall_seconds = secondsSince(start);
+    logMessage(REPLAY_FINISHED, sessions.size(), report.total_samples, report.wall_seconds, threads);
+    return report;
+}
+
+std::string formatReplayReport(const ReplayReport& report) {
+    std::string text;
+    char line[320];
+    std::snprintf(line, sizeof(line), "%-20s %10s %8s %8s %8s %8s %8s %8s %8s %6s %12s %7s %12s\n",
+                  "session", "samples", "joint", "invalid", "force", "velocity", "collide", "self", "kinfail",
+                  "estop", "first_cycle", "score", "samples/s");
+    text += line;
+    for (const SessionReplayResult& result : report.sessions) {
+        std::snprintf(line, sizeof(line), "%-20llu %10llu %8llu %8llu %8llu %8llu %8llu %8llu %8llu %6llu %12llu %7.1f %12.0f%s\n",
+                      static_cast<unsigned long long>(result.session_id),
+                      static_cast<unsigned long long>(result.samples),
+                      static_cast<unsigned long long>(result.joint_limit_violations),
+                      static_cast<unsigned long long>(result.invalid_joint_data),
+                      static_cast<unsigned long long>(result.force_violations),
+                      static_cast<unsigned long long>(result.velocity_violations),
+                      static_cast<unsigned long long>(result.collisions),
+                      static_cast<unsigned long long>(result.self_collisions),
+                      static_cast<unsigned long long>(result.kinematics_failures),
+                      static_cast<unsigned long long>(result.emergency_stops),
+                      static_cast<unsigned long long>(result.first_violation_cycle),
+                      result.final_safety_score, result.samplesPerSecond(),
+                      result.complete ? "" : "  (incomplete)");
+        text += line;
+    }
+    std::snprintf(line, sizeof(line), "total: %zu sessions, %llu samples in %.3f s on %u threads, %.0f samples/s\n",
+                  report.sessions.size(), static_cast<unsigned long long>(report.total_samples),
+                  report.wall_seconds, report.threads, report.samplesPerSecond());
+    text += line;
+    return text;
+}
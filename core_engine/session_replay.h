@@ -0,0 +1,127 @@
+#ifndef SESSION_REPLAY_H
+#define SESSION_REPLAY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <eigen3/Eigen/Dense>
+#include "collision_detector.h"
+#include "kinematics.h"
+#include "robot_parameters.h"
+#include "robot_state_snapshot.h"
+#include "safety_monitor.h"
+
+// The chunks of one recording session, in recording order
+struct ReplaySession {
+    uint64_t session_id;
+    std::vector<std::string> chunk_paths;
+    uint64_t record_count;
+};
+
+// Groups the chunks of a flight recorder directory by session, oldest first
+std::vector<ReplaySession> findReplaySessions(const std::string& directory);
+
+struct ReplayOptions {
+    unsigned thread_count = 0;          // 0: one per hardware thread
+    size_t block_samples = 256;         // samples validated per batch call
+    std::vector<Eigen::Vector3d> obstacles;    // checked against the instrument tip; empty skips the check
+    bool check_self_collision = true;
+    // 0 takes the distances from parameters, or keeps the CollisionDetector default link radius
+    double min_safe_distance = 0.0;
+    double warning_distance = 0.0;
+    double link_radius = 0.0;
+    RobotParameters parameters = defaultRobotParameters();     // limits and DH table checked against
+};
+
+// Counts are of samples, except emergency_stops (times the monitor engaged it)
+struct SessionReplayResult {
+    uint64_t session_id;
+    bool complete;                      // false: a chunk could not be read, counts cover what was
+    uint64_t samples;
+    uint64_t joint_limit_violations;
+    uint64_t invalid_joint_data;        // joint count the monitor has no limits for
+    uint64_t force_violations;
+    uint64_t velocity_violations;
+    uint64_t kinematics_failures;       // non-finite joint angles, or not 6 joints
+    uint64_t collision_warnings;        // tip within the warning distance, not yet the safe distance
+    uint64_t collisions;                // tip within the minimum safe distance
+    uint64_t self_collisions;
+    uint64_t emergency_stops;
+    uint64_t first_violation_cycle;     // 0 when the session is clean
+    double min_obstacle_distance;
+    double final_safety_score;
+    double seconds;
+
+    uint64_t violatingSamples() const {
+        return joint_limit_violations + invalid_joint_data + force_violations + velocity_violations +
+               kinematics_failures + collisions + self_collisions;
+    }
+    double samplesPerSecond() const { return seconds > 0.0 ? samples / seconds : 0.0; }
+};
+
+struct ReplayReport {
+    std::vector<SessionReplayResult> sessions;      // in the order given, whatever thread ran them
+    uint64_t total_samples;
+    unsigned threads;
+    double wall_seconds;
+
+    double samplesPerSecond() const { return wall_seconds > 0.0 ? total_samples / wall_seconds : 0.0; }
+};
+
+// Runs one session's samples through its own SurgicalSafetyMonitor,
+// CollisionDetector and Kinematics<6>. Samples are taken in blocks and
+// validated with the monitor's batch calls on structure-of-arrays copies;
+// forward kinematics runs over the whole block with the SIMD batch kernel.
+//
+// Results depend only on the samples fed in: the monitor's reaction is
+// applied once per block, as its batch calls do, and an engaged emergency
+// stop is released at the start of a block whose first recorded sample
+// shows the operator had resumed. Feed samples from any log format through
+// process().
+class SessionReplayer {
+public:
+    explicit SessionReplayer(const ReplayOptions& options = ReplayOptions(), uint64_t session_id = 0);
+
+    void process(const RobotStateSnapshot* samples, size_t count);
+    // Final safety score filled in; call once all samples are in
+    SessionReplayResult finish();
+
+private:
+    using Solver = Kinematics<6, double>;
+
+    void processRuns(bool flush);
+    void processBlock(const RobotStateSnapshot* samples, size_t count);
+    void checkGeometry(const RobotStateSnapshot* samples, size_t count);
+    void countViolations(const BatchValidationResult& result, const RobotStateSnapshot* samples,
+                         uint64_t& counter);
+    void noteViolation(uint64_t cycle);
+
+    ReplayOptions options;
+    SurgicalSafetyMonitor monitor;
+    CollisionDetector detector;
+    Solver kinematics;
+    SessionReplayResult result;
+
+    std::vector<RobotStateSnapshot> pending;     // fed in, not yet part of a closed block
+
+    // Per-block scratch, channel-major
+    std::vector<double> positions;
+    std::vector<double> forces;
+    std::vector<double> velocities;
+    std::vector<uint32_t> violation_masks;
+    std::array<std::vector<double>, 3> tips;
+    std::vector<Eigen::Vector3d> link_points;
+};
+
+// Replays one recorded session on the calling thread
+SessionReplayResult replaySession(const ReplaySession& session, const ReplayOptions& options = ReplayOptions());
+
+// Replays sessions in parallel, largest first, one session per worker at a time
+ReplayReport replaySessions(const std::vector<ReplaySession>& sessions, const ReplayOptions& options = ReplayOptions());
+
+// Per-session violation summary and throughput, one line per session
+std::string formatReplayReport(const ReplayReport& report);
+
+#endif // SESSION_REPLAY_H
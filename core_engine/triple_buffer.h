@@ -0,0 +1,51 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Wait-free single-producer single-consumer handoff of the latest value.
+// The producer fills writeBuffer() and publish()es it; the consumer calls
+// update() and reads readBuffer(). Neither side ever waits: a value the
+// consumer has not picked up yet is replaced by the next publish(), so the
+// consumer always sees the freshest complete value.
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), back(0), front(2) {}
+
+    // Producer side
+    T& writeBuffer() { return slots[back].value; }
+    // Returns false when this overwrote a value the consumer never saw
+    bool publish() {
+        uint8_t previous = middle.exchange(static_cast<uint8_t>(back | FRESH), std::memory_order_acq_rel);
+        back = previous & INDEX_MASK;
+        return (previous & FRESH) == 0;
+    }
+
+    // Consumer side. Returns true when a newer value became readable.
+    bool update() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+        uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & INDEX_MASK;
+        return true;
+    }
+    const T& readBuffer() const { return slots[front].value; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    // One cache line per slot so producer and consumer never share one
+    struct alignas(64) Slot {
+        T value{};
+    };
+
+    std::array<Slot, 3> slots;
+    alignas(64) std::atomic<uint8_t> middle;    // index | FRESH
+    alignas(64) uint8_t back;                   // producer-owned
+    alignas(64) uint8_t front;                  // consumer-owned
+};
+
+#endif // TRIPLE_BUFFER_H
@@ -1,60 +1,254 @@
 #include "command_subscriber.h"
-#include <iostream>
+#include "async_logger.h"
 #include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
 #include <thread>
+#include <unistd.h>
+
+namespace {
+
+const LogSite SUBSCRIBER_INITIALIZED{LogLevel::Info, "CommandSubscriber", "DDS Command Subscriber Initialized (Simulation Mode)"};
+const LogSite COMMAND_RECEIVED{LogLevel::Info, "CommandSubscriber", "📥 DDS Command Received: {} - {} (Value: {})"};
+const LogSite PROCESSING_EMERGENCY_STOP{LogLevel::Critical, "CommandSubscriber", "🚨 Processing EMERGENCY STOP command"};
+const LogSite PROCESSING_RESUME{LogLevel::Info, "CommandSubscriber", "🔄 Processing RESUME OPERATION command"};
+const LogSite PROCESSING_FORCE_LIMIT{LogLevel::Info, "CommandSubscriber", "⚙️  Processing force limit adjustment: {}N"};
+const LogSite PROCESSING_STATUS_CHECK{LogLevel::Info, "CommandSubscriber", "📊 Processing status check command"};
+const LogSite UNKNOWN_COMMAND{LogLevel::Warning, "CommandSubscriber", "❓ Unknown command type: {}"};
+const LogSite SUBSCRIBER_SHUTDOWN{LogLevel::Info, "CommandSubscriber", "DDS Command Subscriber Shutdown"};
+const LogSite EVENTFD_UNAVAILABLE{LogLevel::Error, "CommandSubscriber", "eventfd failed ({}), emergency stops run on the submitting thread"};
+const LogSite EMERGENCY_FIFO_UNAVAILABLE{LogLevel::Warning, "CommandSubscriber", "SCHED_FIFO priority {} unavailable for the emergency stop thread ({})"};
+const LogSite EMERGENCY_STOP_SLOW{LogLevel::Warning, "CommandSubscriber", "Emergency stop handled {}us after receipt"};
+const LogSite TRANSPORT_FOLLOWED{LogLevel::Info, "CommandSubscriber", "Following command topic '{}'"};
+
+uint64_t steadyNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+CommandSubscriber::CommandSubscriber(const CommandSubscriberOptions& options)
+    : shutdown_requested(false), emergency_lane_closing(false), emergency_event_fd(-1), handlers(nullptr),
+      command_latency(), emergency_latency(EMERGENCY_DEADLINE_NS), handled_count(0) {
+    logMessage(SUBSCRIBER_INITIALIZED);
+    installDefaultHandlers();
+    emergency_pending.reserve(16);
+
+    int event_fd = eventfd(0, EFD_CLOEXEC);
+    emergency_event_fd.store(event_fd, std::memory_order_release);
+    if (event_fd < 0) {
+        logMessage(EVENTFD_UNAVAILABLE, std::strerror(errno));
+    } else {
+        emergency_thread = std::thread(&CommandSubscriber::processEmergencyStops, this, options.emergency_fifo_priority);
+    }
 
-CommandSubscriber::CommandSubscriber() : shutdown_requested(false) {
-    std::cout << "DDS Command Subscriber Initialized (Simulation Mode)" << std::endl;
-    
     // Start command processing thread
     command_thread = std::thread(&CommandSubscriber::processCommands, this);
+
+    if (!options.transport.empty() && transport_reader.open(options.transport, 0)) {
+        logMessage(TRANSPORT_FOLLOWED, options.transport);
+        transport_thread = std::thread(&CommandSubscriber::followTransport, this);
+    }
 }
 
 CommandSubscriber::~CommandSubscriber() {
     shutdown();
 }
 
+void CommandSubscriber::installDefaultHandlers() {
+    auto table = std::make_unique<HandlerTable>();
+    auto install = [&table](CommandType type, CommandHandler handler) {
+        (*table)[static_cast<size_t>(type)] = std::move(handler);
+    };
+    install(CommandType::Unknown, [](const ControlCommand& command) { logMessage(UNKNOWN_COMMAND, command.command_type); });
+    install(CommandType::EmergencyStop, [](const ControlCommand&) { logMessage(PROCESSING_EMERGENCY_STOP); });
+    install(CommandType::ResumeOperation, [](const ControlCommand&) { logMessage(PROCESSING_RESUME); });
+    install(CommandType::ForceLimitAdjust, [](const ControlCommand& command) {
+        logMessage(PROCESSING_FORCE_LIMIT, command.value);
+    });
+    install(CommandType::StatusCheck, [](const ControlCommand&) { logMessage(PROCESSING_STATUS_CHECK); });
+    std::lock_guard<std::mutex> lock(handler_mutex);
+    publishHandlers(std::move(table));
+}
+
+void CommandSubscriber::setCommandHandler(CommandType type, CommandHandler handler) {
+    size_t index = static_cast<size_t>(type);
+    if (index >= COMMAND_TYPE_COUNT || !handler) return;
+    std::lock_guard<std::mutex> lock(handler_mutex);
+    auto table = std::make_unique<HandlerTable>(*handlers.load(std::memory_order_relaxed));
+    (*table)[index] = std::move(handler);
+    publishHandlers(std::move(table));
+}
+
+void CommandSubscriber::publishHandlers(std::unique_ptr<const HandlerTable> table) {
+    // Caller holds handler_mutex. The old table stays owned by
+    // handler_tables, so a reader that loaded it may keep using it.
+    handlers.store(table.get(), std::memory_order_release);
+    handler_tables.push_back(std::move(table));
+}
+
+void CommandSubscriber::submitCommand(ControlCommand command) {
+    if (command.received_ns == 0) command.received_ns = steadyNanoseconds();
+    if (command.type == CommandType::Unknown) command.type = parseCommandType(command.command_type);
+
+    if (command.type == CommandType::EmergencyStop) {
+        // Priority lane: never queued behind other commands. Once shutdown()
+        // has closed the lane the stop runs here instead of being dropped.
+        if (emergency_event_fd.load(std::memory_order_acquire) >= 0) {
+            std::lock_guard<std::mutex> lock(emergency_mutex);
+            if (!emergency_lane_closing.load(std::memory_order_relaxed)) {
+                emergency_pending.push_back(std::move(command));
+                // Under the lock: shutdown() closes the fd only after closing the lane
+                uint64_t one = 1;
+                ssize_t result = write(emergency_event_fd.load(std::memory_order_relaxed), &one, sizeof(one));
+                (void)result;
+                return;
+            }
+        }
+        handleControlCommand(command);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        command_queue.push_back(std::move(command));
+    }
+    queue_ready.notify_one();
+}
+
+void CommandSubscriber::submitCommand(const ControlCommandSample& sample) {
+    ControlCommand command;
+    command.timestamp = static_cast<long>(sample.timestamp);
+    command.type = sample.type;
+    command.command_type = commandTypeName(sample.type);
+    command.reason.assign(sample.reason, strnlen(sample.reason, sizeof(sample.reason)));
+    command.value = sample.value;
+    command.received_ns = sample.source_timestamp_ns;
+    submitCommand(std::move(command));
+}
+
 void CommandSubscriber::processCommands() {
-    int counter = 0;
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (true) {
+        if (!queue_ready.wait_for(lock, std::chrono::milliseconds(100), [this]() {
+                return shutdown_requested || !command_queue.empty();
+            })) {
+            continue;
+        }
+        if (shutdown_requested) break;
+
+        ControlCommand command = std::move(command_queue.front());
+        command_queue.pop_front();
+        lock.unlock();
+        handleControlCommand(command);
+        lock.lock();
+    }
+}
+
+void CommandSubscriber::processEmergencyStops(int fifo_priority) {
+    if (fifo_priority > 0) {
+        sched_param param{};
+        param.sched_priority = fifo_priority;
+        int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (result != 0) logMessage(EMERGENCY_FIFO_UNAVAILABLE, fifo_priority, std::strerror(result));
+    }
+
+    std::vector<ControlCommand> batch;
+    batch.reserve(16);
+    while (true) {
+        uint64_t count = 0;
+        ssize_t result = read(emergency_event_fd.load(std::memory_order_relaxed), &count, sizeof(count));
+        if (result < 0 && errno == EINTR) continue;
+
+        // Read before draining: once the lane is closing nothing can be
+        // queued after this drain, so it is the last one needed
+        bool closing = emergency_lane_closing.load(std::memory_order_acquire);
+        {
+            std::lock_guard<std::mutex> lock(emergency_mutex);
+            batch.swap(emergency_pending);
+        }
+        for (const ControlCommand& command : batch) handleControlCommand(command);
+        batch.clear();
+        if (closing) break;
+    }
+}
+
+void CommandSubscriber::followTransport() {
+    ControlCommandSample sample;
     while (!shutdown_requested) {
-        // Simulate receiving commands periodically
-        if (counter++ % 100 == 0) {
-            ControlCommand simulated_command;
-            simulated_command.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch()).count();
-            simulated_command.command_type = "STATUS_CHECK";
-            simulated_command.reason = "Periodic system check";
-            simulated_command.value = 1.0;
-            
-            handleControlCommand(simulated_command);
+        if (transport_reader.take(sample)) {
+            submitCommand(sample);
+        } else {
+            // Bounded so shutdown is noticed without a wakeup from the writer
+            transport_reader.waitForSample(std::chrono::milliseconds(100));
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 }
 
 void CommandSubscriber::handleControlCommand(const ControlCommand& command) {
-    std::cout << "📥 DDS Command Received: " << command.command_type 
-              << " - " << command.reason << " (Value: " << command.value << ")" << std::endl;
-    
-    // Handle different command types
-    if (command.command_type == "EMERGENCY_STOP") {
-        std::cout << "🚨 Processing EMERGENCY STOP command" << std::endl;
-    } else if (command.command_type == "RESUME_OPERATION") {
-        std::cout << "🔄 Processing RESUME OPERATION command" << std::endl;
-    } else if (command.command_type == "FORCE_LIMIT_ADJUST") {
-        std::cout << "⚙️  Processing force limit adjustment: " << command.value << "N" << std::endl;
-    } else if (command.command_type == "STATUS_CHECK") {
-        std::cout << "📊 Processing status check command" << std::endl;
+    size_t index = static_cast<size_t>(command.type);
+    if (index >= COMMAND_TYPE_COUNT) index = static_cast<size_t>(CommandType::Unknown);
+    const CommandHandler& handler = (*handlers.load(std::memory_order_acquire))[index];
+
+    if (command.type == CommandType::EmergencyStop) {
+        // Act first, log afterwards
+        handler(command);
+        uint64_t latency_ns = steadyNanoseconds() - command.received_ns;
+        emergency_latency.record(latency_ns);
+        if (latency_ns > EMERGENCY_DEADLINE_NS) logMessage(EMERGENCY_STOP_SLOW, latency_ns / 1000);
+        logMessage(COMMAND_RECEIVED, command.command_type, command.reason, command.value);
     } else {
-        std::cout << "❓ Unknown command type: " << command.command_type << std::endl;
+        logMessage(COMMAND_RECEIVED, command.command_type, command.reason, command.value);
+        handler(command);
+        command_latency.record(steadyNanoseconds() - command.received_ns);
     }
+    handled_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string CommandSubscriber::formatMetrics() const {
+    std::string text;
+    appendPrometheusHistograms(text, "command_to_action_latency", "lane",
+                               {{"emergency_stop", emergency_latency.snapshot()},
+                                {"command", command_latency.snapshot()}});
+    return text;
 }
 
 void CommandSubscriber::shutdown() {
     shutdown_requested = true;
+    // The transport thread first: it may still hand over an emergency stop,
+    // which the emergency thread must find when it is woken below
+    if (transport_thread.joinable()) {
+        transport_thread.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+    }
+    queue_ready.notify_all();
+    int event_fd = emergency_event_fd.load(std::memory_order_acquire);
+    {
+        // Every stop pushed before this is in the emergency thread's last drain
+        std::lock_guard<std::mutex> lock(emergency_mutex);
+        emergency_lane_closing.store(true, std::memory_order_release);
+    }
+    if (event_fd >= 0) {
+        uint64_t one = 1;
+        ssize_t result = write(event_fd, &one, sizeof(one));
+        (void)result;
+    }
+
     if (command_thread.joinable()) {
         command_thread.join();
     }
-    std::cout << "DDS Command Subscriber Shutdown" << std::endl;
+    if (emergency_thread.joinable()) {
+        emergency_thread.join();
+    }
+    if (event_fd >= 0) {
+        emergency_event_fd.store(-1, std::memory_order_release);
+        close(event_fd);
+    }
+    logMessage(SUBSCRIBER_SHUTDOWN);
 }
@@ -3,7 +3,18 @@
 
 #include <thread>
 #include <atomic>
-#include <string>  // Add missing include
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "data_publisher.h"
+#include "latency_histogram.h"
+#include "shm_transport.h"
 
 // Simplified control command structure
 struct ControlCommand {
@@ -11,20 +22,98 @@ struct ControlCommand {
     std::string command_type;
     std::string reason;
     double value;
+    CommandType type = CommandType::Unknown;    // resolved from command_type on submission
+    uint64_t received_ns = 0;                   // steady_clock when the command entered the system
 };
 
+// Fixed-layout ControlCommand as carried by the shared-memory transport
+struct ControlCommandSample {
+    int64_t timestamp;                  // milliseconds since epoch
+    uint64_t source_timestamp_ns;       // steady_clock at publication, comparable across processes
+    CommandType type;
+    double value;
+    char reason[128];
+};
+
+struct CommandSubscriberOptions {
+    int emergency_fifo_priority = 0;    // SCHED_FIFO for the e-stop thread, 0 keeps the default policy
+    std::string transport;              // shared-memory command topic to follow, empty: submitCommand() only
+};
+
+// Receives control commands and runs their handlers on two lanes.
+//
+// EMERGENCY_STOP never waits behind other commands: it is handed to a
+// dedicated thread, woken through an eventfd, that does nothing else.
+// Everything else goes through a FIFO queue served by the command thread,
+// which blocks on a condition variable while the queue is empty.
+//
+// Dispatch is by CommandType: the name is resolved once when a command is
+// submitted and handlers live in a table indexed by the enum. Each lane
+// records command-to-action latency, from received_ns to the handler's
+// return.
 class CommandSubscriber {
+public:
+    using CommandHandler = std::function<void(const ControlCommand&)>;
+
 private:
+    static constexpr size_t COMMAND_TYPE_COUNT = static_cast<size_t>(CommandType::StatusCheck) + 1;
+    static constexpr uint64_t EMERGENCY_DEADLINE_NS = 1000000;     // counted as an overrun when slower
+
     std::thread command_thread;
+    std::thread emergency_thread;
+    std::thread transport_thread;
     std::atomic<bool> shutdown_requested;
-    
+    std::atomic<bool> emergency_lane_closing;   // set under emergency_mutex; later e-stops run inline
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_ready;
+    std::deque<ControlCommand> command_queue;
+
+    std::mutex emergency_mutex;
+    std::vector<ControlCommand> emergency_pending;
+    std::atomic<int> emergency_event_fd;    // -1: e-stops run on the submitting thread
+
+    using HandlerTable = std::array<CommandHandler, COMMAND_TYPE_COUNT>;
+
+    // Dispatch reads the current table with one acquire load. A handler
+    // change publishes a modified copy; replaced tables are kept until
+    // destruction, so a dispatch still running an old handler is safe.
+    std::atomic<const HandlerTable*> handlers;
+    std::mutex handler_mutex;                                   // serializes setCommandHandler()
+    std::vector<std::unique_ptr<const HandlerTable>> handler_tables;    // every table published
+
+    ShmReader<ControlCommandSample> transport_reader;
+    LatencyHistogram command_latency;
+    LatencyHistogram emergency_latency;
+    std::atomic<uint64_t> handled_count;
+
     void processCommands();
+    void processEmergencyStops(int fifo_priority);
+    void followTransport();
     void handleControlCommand(const ControlCommand& command);
-    
+    void installDefaultHandlers();
+    void publishHandlers(std::unique_ptr<const HandlerTable> table);
+
 public:
-    CommandSubscriber();
+    explicit CommandSubscriber(const CommandSubscriberOptions& options = CommandSubscriberOptions());
     ~CommandSubscriber();
     void shutdown();
+
+    // Entry point for the transport (or tests). Thread-safe; never blocks
+    // on a running handler.
+    void submitCommand(ControlCommand command);
+    void submitCommand(const ControlCommandSample& sample);
+
+    // Replaces the handler for one command type. Meant for setup and rare
+    // reconfiguration: every call keeps a table until destruction.
+    void setCommandHandler(CommandType type, CommandHandler handler);
+
+    LatencySnapshot getCommandLatency() const { return command_latency.snapshot(); }
+    LatencySnapshot getEmergencyStopLatency() const { return emergency_latency.snapshot(); }
+    uint64_t getHandledCount() const { return handled_count.load(std::memory_order_relaxed); }
+    bool isFollowingTransport() const { return transport_reader.isOpen(); }
+    // Prometheus text format: per-lane command-to-action latency
+    std::string formatMetrics() const;
 };
 
 #endif // COMMAND_SUBSCRIBER_H
@@ -1,19 +1,189 @@
 #include "data_publisher.h"
-#include <iostream>
+#include "async_logger.h"
+#include "sample_fields.h"
+#include "wire_format.h"
+#include <algorithm>
 #include <chrono>
 
-RoboticsDataPublisher::RoboticsDataPublisher() {
-    std::cout << "DDS Data Publisher Initialized (Simulation Mode)" << std::endl;
+namespace {
+
+const LogSite PUBLISHER_INITIALIZED{LogLevel::Info, "DataPublisher", "DDS Data Publisher Initialized (Simulation Mode)"};
+const LogSite SAFETY_DATA_PUBLISHED{LogLevel::Info, "DataPublisher", "📡 DDS Publishing Safety Data - Timestamp: {}, Safety Score: {}"};
+const LogSite EMERGENCY_STOP_PUBLISHED{LogLevel::Critical, "DataPublisher", "🚨 DDS EMERGENCY STOP - Reason: {}, Timestamp: {}"};
+const LogSite SAFETY_ALERT_PUBLISHED{LogLevel::Warning, "DataPublisher", "⚠️  DDS Safety Alert - {}: {} [Component: {}]"};
+const LogSite QOS_APPLIED{LogLevel::Info, "DataPublisher", "QoS profile '{}': history depth {}, transient local {}, deadline {}ms"};
+const LogSite SHM_TRANSPORT_ENABLED{LogLevel::Info, "DataPublisher", "Shared-memory transport '{}' enabled, depth {}"};
+
+int64_t wallClockMilliseconds() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint64_t steadyNanoseconds() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+SafetyMetrics makeSafetyMetrics(const RobotStateSnapshot& state) {
+    size_t joints = std::min<size_t>(state.joint_count, RobotStateSnapshot::MAX_JOINTS);
+    size_t forces = std::min<size_t>(state.force_count, RobotStateSnapshot::MAX_FORCE_CHANNELS);
+    
+    SafetyMetrics metrics;
+    metrics.joint_positions.assign(state.joint_positions, state.joint_positions + joints);
+    metrics.joint_velocities.assign(state.joint_velocities, state.joint_velocities + joints);
+    metrics.force_readings.assign(state.force_readings, state.force_readings + forces);
+    metrics.safety_status = robotStateName(state.robot_state);
+    metrics.collision_risk = state.collision_risk;
+    metrics.emergency_stop = state.emergency_stop;
+    metrics.procedure_phase = procedurePhaseName(state.procedure_phase);
+    metrics.procedure_duration = state.procedure_duration;
+    metrics.safety_score = state.safety_score;
+    return metrics;
+}
+
+const char* safetyStatusName(SafetyStatus status) {
+    switch (status) {
+        case SafetyStatus::Normal: return "NORMAL";
+        case SafetyStatus::Warning: return "WARNING";
+        case SafetyStatus::Critical: return "CRITICAL";
+        case SafetyStatus::EmergencyStop: return "EMERGENCY_STOP";
+        default: return "UNKNOWN";
+    }
+}
+
+bool parseSafetyStatus(const std::string& name, SafetyStatus& status) {
+    if (name == "NORMAL" || name == robotStateName(RobotState::Operational)) {
+        status = SafetyStatus::Normal;
+    } else if (name == "WARNING") {
+        status = SafetyStatus::Warning;
+    } else if (name == "CRITICAL") {
+        status = SafetyStatus::Critical;
+    } else if (name == "EMERGENCY_STOP") {
+        status = SafetyStatus::EmergencyStop;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseProcedurePhase(const std::string& name, ProcedurePhase& phase) {
+    for (uint8_t value = 0; value <= static_cast<uint8_t>(ProcedurePhase::Completed); ++value) {
+        if (name == procedurePhaseName(static_cast<ProcedurePhase>(value))) {
+            phase = static_cast<ProcedurePhase>(value);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* alertSeverityName(AlertSeverity severity) {
+    switch (severity) {
+        case AlertSeverity::Info: return "INFO";
+        case AlertSeverity::Warning: return "WARNING";
+        case AlertSeverity::Critical: return "CRITICAL";
+        case AlertSeverity::Emergency: return "EMERGENCY";
+        default: return "UNKNOWN";
+    }
+}
+
+bool parseAlertSeverity(const std::string& name, AlertSeverity& severity) {
+    for (uint8_t value = 0; value <= static_cast<uint8_t>(AlertSeverity::Emergency); ++value) {
+        if (name == alertSeverityName(static_cast<AlertSeverity>(value))) {
+            severity = static_cast<AlertSeverity>(value);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* commandTypeName(CommandType type) {
+    switch (type) {
+        case CommandType::EmergencyStop: return "EMERGENCY_STOP";
+        case CommandType::ResumeOperation: return "RESUME_OPERATION";
+        case CommandType::ForceLimitAdjust: return "FORCE_LIMIT_ADJUST";
+        case CommandType::StatusCheck: return "STATUS_CHECK";
+        default: return "UNKNOWN";
+    }
+}
+
+CommandType parseCommandType(const std::string& name) {
+    // The command names have distinct lengths, so the length is a perfect
+    // hash and a single compare confirms the match
+    CommandType candidate;
+    switch (name.size()) {
+        case 14: candidate = CommandType::EmergencyStop; break;
+        case 16: candidate = CommandType::ResumeOperation; break;
+        case 18: candidate = CommandType::ForceLimitAdjust; break;
+        case 12: candidate = CommandType::StatusCheck; break;
+        default: return CommandType::Unknown;
+    }
+    return name == commandTypeName(candidate) ? candidate : CommandType::Unknown;
+}
+
+void toSample(const RoboticsData& data, RoboticsDataSample& sample) {
+    sample.timestamp = data.timestamp;
+    copyChannelsAndState(data, sample);
+    sample.emergency_stop_engaged = data.emergency_stop_engaged;
+    sample.collision_risk = data.collision_risk;
+    sample.procedure_duration = data.procedure_duration;
+}
+
+void toSample(const SafetyMetrics& metrics, RoboticsDataSample& sample) {
+    copyChannelsAndState(metrics, sample);
+    sample.emergency_stop_engaged = metrics.emergency_stop;
+    sample.collision_risk = metrics.collision_risk;
+    sample.procedure_duration = metrics.procedure_duration;
+}
+
+RoboticsData fromSample(const RoboticsDataSample& sample) {
+    size_t joints = std::min<size_t>(sample.joint_count, RoboticsDataSample::MAX_JOINTS);
+    size_t forces = std::min<size_t>(sample.force_count, RoboticsDataSample::MAX_FORCE_CHANNELS);
+    
+    RoboticsData data;
+    data.timestamp = static_cast<long>(sample.timestamp);
+    data.joint_positions.assign(sample.joint_positions, sample.joint_positions + joints);
+    data.joint_velocities.assign(sample.joint_velocities, sample.joint_velocities + joints);
+    data.force_readings.assign(sample.force_readings, sample.force_readings + forces);
+    data.safety_status = safetyStatusName(sample.safety_status);
+    data.collision_risk = sample.collision_risk;
+    data.emergency_stop_engaged = sample.emergency_stop_engaged;
+    data.procedure_phase = procedurePhaseName(sample.procedure_phase);
+    data.procedure_duration = sample.procedure_duration;
+    return data;
+}
+
+RoboticsDataPublisher::RoboticsDataPublisher()
+    : robotics_topic(std::make_unique<DataTopic<RoboticsDataSample>>(qos)),
+      alert_topic(std::make_unique<DataTopic<SafetyAlertFrame>>(qos)),
+      staging_sample{} {
+    logMessage(PUBLISHER_INITIALIZED);
+}
+
+RoboticsDataPublisher::~RoboticsDataPublisher() = default;
+
+bool RoboticsDataPublisher::applyQosProfile(const std::string& xml_path, const std::string& profile_name) {
+    QosProfile profile = qos;
+    if (!loadQosProfile(xml_path, profile_name, profile)) return false;
+    qos = profile;
+    robotics_topic = std::make_unique<DataTopic<RoboticsDataSample>>(qos);
+    alert_topic = std::make_unique<DataTopic<SafetyAlertFrame>>(qos);
+    logMessage(QOS_APPLIED, profile_name, qos.history_depth, qos.transient_local,
+               std::chrono::duration_cast<std::chrono::milliseconds>(qos.deadline).count());
+    return true;
 }
 
 void RoboticsDataPublisher::publishSafetyData(const SafetyMetrics& metrics) {
     // Simulate DDS publication
-    auto now = std::chrono::system_clock::now();
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()).count();
+    auto timestamp = wallClockMilliseconds();
+    
+    logMessage(SAFETY_DATA_PUBLISHED, timestamp, metrics.safety_score);
     
-    std::cout << "📡 DDS Publishing Safety Data - Timestamp: " << timestamp 
-              << ", Safety Score: " << metrics.safety_score << std::endl;
+    RoboticsDataSample& sample = loanSample();
+    toSample(metrics, sample);
+    sample.timestamp = timestamp;
+    publishLoanedSample();
 }
 
 void RoboticsDataPublisher::publishEmergencyStop(const std::string& reason) {
@@ -21,11 +191,37 @@ void RoboticsDataPublisher::publishEmergencyStop(const std::string& reason) {
     auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()).count();
     
-    std::cout << "🚨 DDS EMERGENCY STOP - Reason: " << reason 
-              << ", Timestamp: " << timestamp << std::endl;
+    logMessage(EMERGENCY_STOP_PUBLISHED, reason, timestamp);
 }
 
 void RoboticsDataPublisher::publishSafetyAlert(const SafetyAlert& alert) {
-    std::cout << "⚠️  DDS Safety Alert - " << alert.severity << ": " << alert.message 
-              << " [Component: " << alert.component << "]" << std::endl;
+    logMessage(SAFETY_ALERT_PUBLISHED, alert.severity, alert.message, alert.component);
+    
+    SafetyAlertFrame frame;
+    toFrame(alert, frame);
+    alert_topic->publish(frame);
+}
+
+bool RoboticsDataPublisher::enableSharedMemoryTransport(const ShmTransportOptions& options) {
+    auto writer = std::make_unique<ShmWriter<RoboticsDataSample>>();
+    if (!writer->create(options)) return false;
+    shm_writer = std::move(writer);
+    logMessage(SHM_TRANSPORT_ENABLED, options.name, options.depth);
+    return true;
+}
+
+RoboticsDataSample& RoboticsDataPublisher::loanSample() {
+    return shm_writer ? shm_writer->loan() : staging_sample;
+}
+
+void RoboticsDataPublisher::publishLoanedSample() {
+    RoboticsDataSample& sample = loanSample();
+    sample.source_timestamp_ns = steadyNanoseconds();
+    robotics_topic->publish(sample);
+    if (shm_writer) shm_writer->commit();
+}
+
+void RoboticsDataPublisher::publishRoboticsData(const RoboticsData& data) {
+    toSample(data, loanSample());
+    publishLoanedSample();
 }
@@ -1,8 +1,14 @@
 #ifndef DATA_PUBLISHER_H
 #define DATA_PUBLISHER_H
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
+#include "history_cache.h"
+#include "qos_profile.h"
+#include "robot_state_snapshot.h"
+#include "shm_transport.h"
 
 // Simplified DDS types for demonstration
 // In real implementation, these would be generated by RTI Connext
@@ -47,12 +53,106 @@ struct SafetyMetrics {
     double safety_score;
 };
 
+// Builds the published metrics from a controller state snapshot
+SafetyMetrics makeSafetyMetrics(const RobotStateSnapshot& state);
+
+enum class SafetyStatus : uint8_t {
+    Normal = 0,
+    Warning,
+    Critical,
+    EmergencyStop
+};
+
+const char* safetyStatusName(SafetyStatus status);
+// Accepts the names above and the robot state names; false if unknown
+bool parseSafetyStatus(const std::string& name, SafetyStatus& status);
+bool parseProcedurePhase(const std::string& name, ProcedurePhase& phase);
+
+enum class AlertSeverity : uint8_t {
+    Info = 0,
+    Warning,
+    Critical,
+    Emergency
+};
+
+const char* alertSeverityName(AlertSeverity severity);
+bool parseAlertSeverity(const std::string& name, AlertSeverity& severity);
+
+enum class CommandType : uint8_t {
+    Unknown = 0,
+    EmergencyStop,
+    ResumeOperation,
+    ForceLimitAdjust,
+    StatusCheck
+};
+
+const char* commandTypeName(CommandType type);
+// Unknown names map to CommandType::Unknown
+CommandType parseCommandType(const std::string& name);
+
+// Fixed-layout RoboticsData as carried by the shared-memory transport
+struct RoboticsDataSample {
+    static constexpr size_t MAX_JOINTS = 8;
+    static constexpr size_t MAX_FORCE_CHANNELS = 8;
+
+    int64_t timestamp;                  // milliseconds since epoch, as RoboticsData
+    uint64_t source_timestamp_ns;       // steady_clock at publication, comparable across processes
+    uint8_t joint_count;
+    uint8_t force_count;
+    SafetyStatus safety_status;
+    ProcedurePhase procedure_phase;
+    bool emergency_stop_engaged;
+    double joint_positions[MAX_JOINTS];
+    double joint_velocities[MAX_JOINTS];
+    double force_readings[MAX_FORCE_CHANNELS];
+    double collision_risk;
+    double procedure_duration;
+};
+
+// Vectors longer than the fixed arrays are truncated; unknown status and
+// phase strings map to Warning and Initialization
+void toSample(const RoboticsData& data, RoboticsDataSample& sample);
+// Same mapping; SafetyMetrics carry no timestamp, so the caller sets it
+void toSample(const SafetyMetrics& metrics, RoboticsDataSample& sample);
+RoboticsData fromSample(const RoboticsDataSample& sample);
+
+struct SafetyAlertFrame;
+
 class RoboticsDataPublisher {
+private:
+    QosProfile qos;
+    std::unique_ptr<DataTopic<RoboticsDataSample>> robotics_topic;
+    std::unique_ptr<DataTopic<SafetyAlertFrame>> alert_topic;
+    std::unique_ptr<ShmWriter<RoboticsDataSample>> shm_writer;
+    RoboticsDataSample staging_sample;      // loaned when there is no shared-memory ring
+
 public:
     RoboticsDataPublisher();
+    ~RoboticsDataPublisher();
     void publishSafetyData(const SafetyMetrics& metrics);
     void publishEmergencyStop(const std::string& reason);
     void publishSafetyAlert(const SafetyAlert& alert);
+    
+    // Re-creates the topics with the history depth, durability and deadline
+    // of a profile in a DDS QoS XML file (config/dds_config.xml). Only
+    // before readers attach; their history is discarded.
+    bool applyQosProfile(const std::string& xml_path, const std::string& profile_name = "RealTimeDataQoS");
+    const QosProfile& getQosProfile() const { return qos; }
+    
+    // In-process readers. Kept history is replayed to late joiners.
+    DataTopic<RoboticsDataSample>& roboticsDataTopic() { return *robotics_topic; }
+    DataTopic<SafetyAlertFrame>& safetyAlertTopic() { return *alert_topic; }
+    
+    // Publishes RoboticsData samples to local subscribers through a shared
+    // memory ring. Returns false when the segment cannot be created.
+    bool enableSharedMemoryTransport(const ShmTransportOptions& options);
+    bool hasSharedMemoryTransport() const { return shm_writer != nullptr; }
+    
+    // Zero-copy publication: fill the loaned sample in place, then publish
+    // it. With the shared-memory transport the sample lives in the ring.
+    RoboticsDataSample& loanSample();
+    void publishLoanedSample();
+    void publishRoboticsData(const RoboticsData& data);
 };
 
 #endif // DATA_PUBLISHER_H
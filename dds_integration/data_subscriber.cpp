@@ -0,0 +1,23 @@
+#include "data_subscriber.h"
+#include "async_logger.h"
+
+namespace {
+
+const LogSite SUBSCRIBER_CONNECTED{LogLevel::Info, "DataSubscriber", "Connected to shared-memory topic '{}', replaying {} samples"};
+
+} // namespace
+
+RoboticsDataSubscriber::RoboticsDataSubscriber() = default;
+
+bool RoboticsDataSubscriber::connect(const std::string& name, size_t history) {
+    if (!reader.open(name, history)) return false;
+    logMessage(SUBSCRIBER_CONNECTED, name, reader.available());
+    return true;
+}
+
+bool RoboticsDataSubscriber::takeData(RoboticsData& data) {
+    RoboticsDataSample sample;
+    if (!reader.take(sample)) return false;
+    data = fromSample(sample);
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef DATA_SUBSCRIBER_H
+#define DATA_SUBSCRIBER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "data_publisher.h"
+#include "shm_transport.h"
+
+// Reads RoboticsData samples from a publisher's shared-memory transport,
+// in this or another process. Each subscriber has its own cursor; a slow
+// subscriber loses its oldest samples, never delays the publisher.
+class RoboticsDataSubscriber {
+private:
+    ShmReader<RoboticsDataSample> reader;
+
+public:
+    RoboticsDataSubscriber();
+    
+    // Up to `history` samples already published are delivered first
+    // (TRANSIENT_LOCAL late-joiner replay). False while no publisher has
+    // created the topic.
+    bool connect(const std::string& name, size_t history = 1000);
+    bool isConnected() const { return reader.isOpen(); }
+    
+    bool takeSample(RoboticsDataSample& sample) { return reader.take(sample); }
+    bool takeData(RoboticsData& data);
+    bool waitForData(std::chrono::microseconds timeout) { return reader.waitForSample(timeout); }
+    
+    uint64_t getLostSampleCount() const { return reader.getLostCount(); }
+};
+
+#endif // DATA_SUBSCRIBER_H
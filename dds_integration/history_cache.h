@@ -0,0 +1,247 @@
+#ifndef HISTORY_CACHE_H
+#define HISTORY_CACHE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "qos_profile.h"
+
+// KEEP_LAST history: the newest `depth` samples in a preallocated ring.
+// Samples are numbered from 1 in publication order; insert() overwrites
+// the oldest one in constant time. Not synchronized, DataTopic locks it.
+template<typename T>
+class HistoryCache {
+public:
+    explicit HistoryCache(size_t depth) : slots(std::max<size_t>(depth, 1)), next_sequence(1) {}
+
+    uint64_t insert(const T& sample) {
+        slots[(next_sequence - 1) % slots.size()] = sample;
+        return next_sequence++;
+    }
+
+    // Sequence of the newest sample, 0 while empty
+    uint64_t lastSequence() const { return next_sequence - 1; }
+    // Sequence of the oldest sample still kept
+    uint64_t firstSequence() const { return next_sequence > slots.size() ? next_sequence - slots.size() : 1; }
+    size_t size() const { return static_cast<size_t>(next_sequence - firstSequence()); }
+    size_t depth() const { return slots.size(); }
+
+    // Appends the kept samples newer than `after`, oldest first
+    size_t copySince(uint64_t after, std::vector<T>& out) const {
+        uint64_t first = std::max(after + 1, firstSequence());
+        for (uint64_t sequence = first; sequence < next_sequence; ++sequence) {
+            out.push_back(slots[(sequence - 1) % slots.size()]);
+        }
+        return static_cast<size_t>(next_sequence > first ? next_sequence - first : 0);
+    }
+
+private:
+    std::vector<T> slots;
+    uint64_t next_sequence;
+};
+
+struct TopicStats {
+    uint64_t published;
+    uint64_t deadline_misses;           // deadline periods that passed without a sample
+    uint64_t batches_delivered;
+    uint64_t samples_delivered;
+    uint64_t samples_lost;              // overwritten before a reader got them
+    size_t history_size;
+};
+
+// In-process topic with the writer QoS of a profile: a KEEP_LAST history
+// cache, TRANSIENT_LOCAL replay of that history to readers that attach
+// later, and offered-deadline tracking.
+//
+// publish() only inserts into the cache and, if the delivery thread is not
+// already due to run, wakes it. The delivery thread hands each reader
+// everything it has not seen yet in one listener call, so samples
+// published while readers were busy are coalesced into a single batch
+// instead of one wakeup each. Listeners run on the delivery thread; a
+// reader that falls more than the history depth behind loses the oldest
+// samples.
+template<typename T>
+class DataTopic {
+public:
+    using Listener = std::function<void(const T* samples, size_t count)>;
+
+    explicit DataTopic(const QosProfile& qos = QosProfile())
+        : qos(qos), cache(qos.history_depth), pending(false), stopping(false), delivering(false),
+          published(0), closed_deadline_misses(0), last_publish_ns(0),
+          batches_delivered(0), samples_delivered(0), samples_lost(0) {
+        batch.reserve(cache.depth());
+    }
+
+    ~DataTopic() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (delivery_thread.joinable()) delivery_thread.join();
+    }
+
+    DataTopic(const DataTopic&) = delete;
+    DataTopic& operator=(const DataTopic&) = delete;
+
+    void publish(const T& sample) {
+        int64_t now = nowNanoseconds();
+        bool notify = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cache.insert(sample);
+            ++published;
+            if (qos.deadline.count() > 0 && last_publish_ns != 0) {
+                closed_deadline_misses += static_cast<uint64_t>((now - last_publish_ns) / qos.deadline.count());
+            }
+            last_publish_ns = now;
+            if (!readers.empty() && !pending) {
+                pending = true;
+                notify = true;
+            }
+        }
+        if (notify) wake.notify_one();
+    }
+
+    // Returns the reader id. With TRANSIENT_LOCAL the listener first gets
+    // the whole kept history in one batch.
+    int attachReader(Listener listener) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto reader = std::make_shared<Reader>();
+        reader->id = static_cast<int>(next_reader_id++);
+        reader->listener = std::move(listener);
+        reader->cursor = qos.transient_local ? cache.firstSequence() - 1 : cache.lastSequence();
+        readers.push_back(reader);
+        if (!delivery_thread.joinable()) delivery_thread = std::thread(&DataTopic::deliveryLoop, this);
+        if (reader->cursor < cache.lastSequence()) {
+            pending = true;
+            wake.notify_one();
+        }
+        return reader->id;
+    }
+
+    // The listener is not called after this returns, unless from itself
+    void detachReader(int reader_id) {
+        std::unique_lock<std::mutex> lock(mutex);
+        readers.erase(std::remove_if(readers.begin(), readers.end(),
+                                     [reader_id](const std::shared_ptr<Reader>& reader) { return reader->id == reader_id; }),
+                      readers.end());
+        if (std::this_thread::get_id() == delivery_thread.get_id()) return;
+        while (delivering) idle.wait_for(lock, std::chrono::milliseconds(10));
+    }
+
+    // Blocks until every attached reader has been handed every sample
+    // published before the call, or the timeout passes
+    bool waitForDelivery(std::chrono::milliseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!caughtUp()) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            idle.wait_for(lock, std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    TopicStats getStats() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint64_t misses = closed_deadline_misses;
+        if (qos.deadline.count() > 0 && last_publish_ns != 0) {
+            misses += static_cast<uint64_t>((nowNanoseconds() - last_publish_ns) / qos.deadline.count());
+        }
+        return TopicStats{published, misses, batches_delivered, samples_delivered, samples_lost, cache.size()};
+    }
+
+    // True once a full deadline period has passed since the last sample
+    bool isDeadlineMissed() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return qos.deadline.count() > 0 && last_publish_ns != 0 &&
+               nowNanoseconds() - last_publish_ns > qos.deadline.count();
+    }
+
+    const QosProfile& getQos() const { return qos; }
+
+private:
+    struct Reader {
+        int id;
+        Listener listener;
+        uint64_t cursor;                // newest sequence handed over
+    };
+
+    static int64_t nowNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool caughtUp() const {
+        if (pending || delivering) return false;
+        for (const auto& reader : readers) {
+            if (reader->cursor < cache.lastSequence()) return false;
+        }
+        return true;
+    }
+
+    void deliveryLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            if (!pending) {
+                wake.wait_for(lock, std::chrono::milliseconds(100));
+                continue;
+            }
+            pending = false;
+            delivering = true;
+
+            // Snapshot so attach/detach from a listener cannot invalidate the loop
+            std::vector<std::shared_ptr<Reader>> current = readers;
+            for (const auto& reader : current) {
+                if (reader->cursor >= cache.lastSequence()) continue;
+                uint64_t first = cache.firstSequence();
+                if (reader->cursor + 1 < first) {
+                    samples_lost += first - 1 - reader->cursor;
+                    reader->cursor = first - 1;
+                }
+                batch.clear();
+                size_t count = cache.copySince(reader->cursor, batch);
+                reader->cursor = cache.lastSequence();
+                ++batches_delivered;
+                samples_delivered += count;
+
+                lock.unlock();
+                reader->listener(batch.data(), batch.size());
+                lock.lock();
+            }
+
+            delivering = false;
+            idle.notify_all();
+        }
+    }
+
+    const QosProfile qos;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    HistoryCache<T> cache;
+    std::vector<std::shared_ptr<Reader>> readers;
+    std::vector<T> batch;               // delivery thread only
+    std::thread delivery_thread;
+    uint64_t next_reader_id = 0;
+    bool pending;                       // samples (or a new reader) waiting for delivery
+    bool stopping;
+    bool delivering;
+
+    uint64_t published;
+    uint64_t closed_deadline_misses;    // from gaps that have ended
+    int64_t last_publish_ns;
+    uint64_t batches_delivered;
+    uint64_t samples_delivered;
+    uint64_t samples_lost;
+};
+
+#endif // HISTORY_CACHE_H
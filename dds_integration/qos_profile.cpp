@@ -0,0 +1,132 @@
+#include "qos_profile.h"
+#include "async_logger.h"
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const LogSite QOS_FILE_UNREADABLE{LogLevel::Error, "QosProfile", "Cannot read QoS file '{}'"};
+const LogSite QOS_PROFILE_MISSING{LogLevel::Error, "QosProfile", "QoS profile '{}' not found"};
+const LogSite QOS_VALUE_INVALID{LogLevel::Error, "QosProfile", "QoS profile '{}': invalid {}"};
+const LogSite QOS_KEEP_ALL{LogLevel::Warning, "QosProfile", "QoS profile '{}': KEEP_ALL history not supported, keeping depth {}"};
+
+std::string stripComments(const std::string& xml) {
+    std::string out;
+    out.reserve(xml.size());
+    size_t position = 0;
+    while (position < xml.size()) {
+        size_t start = xml.find("<!--", position);
+        if (start == std::string::npos) {
+            out.append(xml, position, std::string::npos);
+            break;
+        }
+        out.append(xml, position, start - position);
+        size_t end = xml.find("-->", start + 4);
+        if (end == std::string::npos) break;
+        position = end + 3;
+    }
+    return out;
+}
+
+std::string trim(const std::string& text) {
+    size_t first = 0;
+    while (first < text.size() && std::isspace(static_cast<unsigned char>(text[first]))) ++first;
+    size_t last = text.size();
+    while (last > first && std::isspace(static_cast<unsigned char>(text[last - 1]))) --last;
+    return text.substr(first, last - first);
+}
+
+// Inner text of the first <tag>...</tag> in xml, tags with attributes included
+bool element(const std::string& xml, const std::string& tag, std::string& inner) {
+    size_t open = xml.find("<" + tag);
+    while (open != std::string::npos) {
+        char next = open + tag.size() + 1 < xml.size() ? xml[open + tag.size() + 1] : '\0';
+        if (next == '>' || std::isspace(static_cast<unsigned char>(next))) break;
+        open = xml.find("<" + tag, open + 1);
+    }
+    if (open == std::string::npos) return false;
+    size_t body = xml.find('>', open);
+    size_t close = xml.find("</" + tag + ">", body);
+    if (body == std::string::npos || close == std::string::npos) return false;
+    inner = xml.substr(body + 1, close - body - 1);
+    return true;
+}
+
+bool parseUnsigned(const std::string& text, unsigned long long& value) {
+    std::string digits = trim(text);
+    if (digits.empty()) return false;
+    char* end = nullptr;
+    value = std::strtoull(digits.c_str(), &end, 10);
+    return end && *end == '\0';
+}
+
+} // namespace
+
+bool parseQosProfile(const std::string& document, const std::string& profile_name, QosProfile& profile) {
+    std::string xml = stripComments(document);
+    std::string marker = "<qos_profile name=\"" + profile_name + "\"";
+    size_t start = xml.find(marker);
+    if (start == std::string::npos) {
+        logMessage(QOS_PROFILE_MISSING, profile_name);
+        return false;
+    }
+    size_t end = xml.find("</qos_profile>", start);
+    std::string profile_xml = xml.substr(start, end == std::string::npos ? std::string::npos : end - start);
+
+    std::string writer;
+    if (!element(profile_xml, "datawriter_qos", writer)) return true;
+
+    QosProfile parsed = profile;
+    std::string section, value;
+    if (element(writer, "history", section)) {
+        std::string kind;
+        if (element(section, "kind", kind) && trim(kind) == "KEEP_ALL_HISTORY_QOS") {
+            logMessage(QOS_KEEP_ALL, profile_name, parsed.history_depth);
+        } else if (element(section, "depth", value)) {
+            unsigned long long depth = 0;
+            if (!parseUnsigned(value, depth) || depth == 0) {
+                logMessage(QOS_VALUE_INVALID, profile_name, "history depth");
+                return false;
+            }
+            parsed.history_depth = static_cast<size_t>(depth);
+        }
+    }
+    if (element(writer, "durability", section) && element(section, "kind", value)) {
+        std::string kind = trim(value);
+        parsed.transient_local = kind == "TRANSIENT_LOCAL_DURABILITY_QOS" || kind == "TRANSIENT_DURABILITY_QOS" ||
+                                 kind == "PERSISTENT_DURABILITY_QOS";
+    }
+    std::string period;
+    if (element(writer, "deadline", section) && element(section, "period", period)) {
+        std::string seconds_text, nanoseconds_text;
+        bool has_seconds = element(period, "sec", seconds_text);
+        bool has_nanoseconds = element(period, "nanosec", nanoseconds_text);
+        if (trim(seconds_text) == "DURATION_INFINITE_SEC") {
+            parsed.deadline = std::chrono::nanoseconds(0);
+        } else {
+            unsigned long long seconds = 0, nanoseconds = 0;
+            if ((has_seconds && !parseUnsigned(seconds_text, seconds)) ||
+                (has_nanoseconds && !parseUnsigned(nanoseconds_text, nanoseconds))) {
+                logMessage(QOS_VALUE_INVALID, profile_name, "deadline period");
+                return false;
+            }
+            parsed.deadline = std::chrono::seconds(seconds) + std::chrono::nanoseconds(nanoseconds);
+        }
+    }
+
+    profile = parsed;
+    return true;
+}
+
+bool loadQosProfile(const std::string& path, const std::string& profile_name, QosProfile& profile) {
+    std::ifstream file(path);
+    if (!file) {
+        logMessage(QOS_FILE_UNREADABLE, path);
+        return false;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return parseQosProfile(contents.str(), profile_name, profile);
+}
@@ -0,0 +1,23 @@
+#ifndef QOS_PROFILE_H
+#define QOS_PROFILE_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+// The subset of a DDS writer QoS profile the in-process topics implement.
+// Defaults match the RealTimeDataQoS profile in config/dds_config.xml.
+struct QosProfile {
+    size_t history_depth = 1000;                        // KEEP_LAST depth
+    bool transient_local = true;                        // replay kept history to late-joining readers
+    std::chrono::nanoseconds deadline{100000000};       // max gap between samples, 0: none
+};
+
+// Reads the <datawriter_qos> of the named <qos_profile> from RTI-style QoS
+// XML: history kind/depth, durability kind and deadline period. Settings
+// absent from the profile keep their current value in `profile`. Returns
+// false when the profile is missing or a value is malformed.
+bool parseQosProfile(const std::string& xml, const std::string& profile_name, QosProfile& profile);
+bool loadQosProfile(const std::string& path, const std::string& profile_name, QosProfile& profile);
+
+#endif // QOS_PROFILE_H
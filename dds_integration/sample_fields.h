@@ -0,0 +1,36 @@
+#ifndef SAMPLE_FIELDS_H
+#define SAMPLE_FIELDS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "data_publisher.h"
+
+// Internal to dds_integration: the field conversions shared by the
+// publisher's fixed-size samples and the wire frames.
+
+// Copies up to N channels, zeroes the rest and returns the count kept
+template<size_t N>
+inline uint8_t copyChannels(const std::vector<double>& source, double (&target)[N]) {
+    size_t count = std::min(source.size(), N);
+    std::copy(source.begin(), source.begin() + count, target);
+    std::fill(target + count, target + N, 0.0);
+    return static_cast<uint8_t>(count);
+}
+
+// Fills the channel arrays and counts, the safety status and the procedure
+// phase of a sample or frame from a string-typed message. Unknown status
+// and phase names map to Warning and Initialization.
+template<typename Message, typename Target>
+void copyChannelsAndState(const Message& message, Target& target) {
+    target.joint_count = copyChannels(message.joint_positions, target.joint_positions);
+    copyChannels(message.joint_velocities, target.joint_velocities);
+    target.force_count = copyChannels(message.force_readings, target.force_readings);
+    if (!parseSafetyStatus(message.safety_status, target.safety_status)) target.safety_status = SafetyStatus::Warning;
+    if (!parseProcedurePhase(message.procedure_phase, target.procedure_phase)) {
+        target.procedure_phase = ProcedurePhase::Initialization;
+    }
+}
+
+#endif // SAMPLE_FIELDS_H
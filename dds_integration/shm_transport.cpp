@@ -0,0 +1,99 @@
+#include "shm_transport.h"
+#include "async_logger.h"
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+const LogSite SHM_CREATE_FAILED{LogLevel::Error, "ShmTransport", "Cannot create shared memory '{}': {}"};
+const LogSite SHM_OPEN_FAILED{LogLevel::Warning, "ShmTransport", "Cannot open shared memory '{}': {}"};
+
+} // namespace
+
+bool ShmSegment::create(const std::string& name, size_t bytes) {
+    close();
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        logMessage(SHM_CREATE_FAILED, name, std::strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        logMessage(SHM_CREATE_FAILED, name, std::strerror(errno));
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        logMessage(SHM_CREATE_FAILED, name, std::strerror(errno));
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    address = mapped;
+    length = bytes;
+    owner = true;
+    object_name = name;
+    return true;
+}
+
+bool ShmSegment::open(const std::string& name) {
+    close();
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        logMessage(SHM_OPEN_FAILED, name, std::strerror(errno));
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    // Readers also write the waiter count, so the mapping is read-write
+    void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        logMessage(SHM_OPEN_FAILED, name, std::strerror(errno));
+        return false;
+    }
+
+    address = mapped;
+    length = static_cast<size_t>(info.st_size);
+    owner = false;
+    object_name = name;
+    return true;
+}
+
+void ShmSegment::close() {
+    if (address) munmap(address, length);
+    if (owner) shm_unlink(object_name.c_str());
+    address = nullptr;
+    length = 0;
+    owner = false;
+    object_name.clear();
+}
+
+bool shmFutexWait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::microseconds timeout) {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit integer");
+    timespec relative;
+    relative.tv_sec = static_cast<time_t>(timeout.count() / 1000000);
+    relative.tv_nsec = static_cast<long>(timeout.count() % 1000000) * 1000;
+    // Not FUTEX_PRIVATE: waiter and waker live in different processes
+    long result = syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+    return result == 0;
+}
+
+void shmFutexWakeAll(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
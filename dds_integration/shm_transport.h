@@ -0,0 +1,237 @@
+#ifndef SHM_TRANSPORT_H
+#define SHM_TRANSPORT_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+
+// Local stand-in for a DDS topic: a POSIX shared-memory ring of fixed-layout
+// samples with one writer process and any number of reader processes.
+//
+// History is KEEP_LAST: the ring holds the newest `depth` samples and the
+// writer never waits for readers, it overwrites the oldest slot. Every
+// reader keeps its own cursor, so readers do not interfere with each
+// other; a reader that falls more than `depth` samples behind skips ahead
+// and counts the overwritten samples as lost. A reader joining late can
+// replay the samples still in the ring (TRANSIENT_LOCAL durability).
+//
+// Each slot carries a sequence word used like a seqlock: odd while the
+// writer fills the slot in place, 2 * (index + 1) once it is committed.
+// Readers copy a slot out and keep the copy only if the word matched the
+// index they wanted before and after the copy.
+
+struct ShmTransportOptions {
+    std::string name;                   // shm object name, "/something"
+    size_t depth = 1000;                // KEEP_LAST history depth
+};
+
+// A mapped shared-memory object. The creator unlinks the name when it
+// closes the segment; mappings held by other processes stay valid.
+class ShmSegment {
+public:
+    ShmSegment() : address(nullptr), length(0), owner(false) {}
+    ~ShmSegment() { close(); }
+
+    ShmSegment(const ShmSegment&) = delete;
+    ShmSegment& operator=(const ShmSegment&) = delete;
+
+    // Replaces any stale object of the same name with a zeroed one
+    bool create(const std::string& name, size_t bytes);
+    bool open(const std::string& name);
+    void close();
+
+    void* data() const { return address; }
+    size_t size() const { return length; }
+
+private:
+    void* address;
+    size_t length;
+    bool owner;
+    std::string object_name;
+};
+
+// Cross-process wait on a shared 32-bit word (Linux futex)
+bool shmFutexWait(std::atomic<uint32_t>& word, uint32_t expected, std::chrono::microseconds timeout);
+void shmFutexWakeAll(std::atomic<uint32_t>& word);
+
+struct ShmRingHeader {
+    static constexpr uint64_t MAGIC = 0x53524253484d5231ull;    // "SRBSHMR1"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slot_size;
+    uint64_t capacity;
+    alignas(64) std::atomic<uint64_t> write_count;  // committed samples
+    alignas(64) std::atomic<uint32_t> notify;       // futex word, bumped on every commit
+    std::atomic<uint32_t> waiters;                  // readers blocked in waitForSample()
+};
+
+template<typename T>
+struct alignas(64) ShmSlot {
+    std::atomic<uint64_t> sequence;
+    T value;
+};
+
+template<typename T>
+class ShmWriter {
+    static_assert(std::is_trivially_copyable<T>::value, "Shared-memory samples must be trivially copyable");
+
+public:
+    ShmWriter() : header(nullptr), slots(nullptr), next_index(0), loaned(false) {}
+
+    bool create(const ShmTransportOptions& options) {
+        if (options.depth == 0) return false;
+        if (!segment.create(options.name, sizeof(ShmRingHeader) + options.depth * sizeof(ShmSlot<T>))) return false;
+
+        header = new (segment.data()) ShmRingHeader;
+        header->magic = ShmRingHeader::MAGIC;
+        header->version = ShmRingHeader::VERSION;
+        header->slot_size = sizeof(ShmSlot<T>);
+        header->capacity = options.depth;
+        header->write_count.store(0, std::memory_order_relaxed);
+        header->notify.store(0, std::memory_order_relaxed);
+        header->waiters.store(0, std::memory_order_relaxed);
+        slots = reinterpret_cast<ShmSlot<T>*>(static_cast<char*>(segment.data()) + sizeof(ShmRingHeader));
+        for (size_t i = 0; i < options.depth; ++i) new (&slots[i]) ShmSlot<T>{{0}, T{}};
+        next_index = 0;
+        loaned = false;
+        return true;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+
+    // Slot for the next sample, written in place in shared memory. Readers
+    // ignore it until commit(); loaning again without a commit reuses it.
+    T& loan() {
+        ShmSlot<T>& slot = slots[next_index % header->capacity];
+        if (!loaned) {
+            slot.sequence.store(2 * next_index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            loaned = true;
+        }
+        return slot.value;
+    }
+
+    void commit() {
+        if (!loaned) return;
+        slots[next_index % header->capacity].sequence.store(2 * (next_index + 1), std::memory_order_release);
+        ++next_index;
+        loaned = false;
+        header->write_count.store(next_index, std::memory_order_release);
+
+        // Pairs with the waiter count / notify check in waitForSample()
+        header->notify.fetch_add(1, std::memory_order_seq_cst);
+        if (header->waiters.load(std::memory_order_seq_cst) != 0) shmFutexWakeAll(header->notify);
+    }
+
+    void write(const T& sample) {
+        loan() = sample;
+        commit();
+    }
+
+    uint64_t getWrittenCount() const { return next_index; }
+
+private:
+    ShmSegment segment;
+    ShmRingHeader* header;
+    ShmSlot<T>* slots;
+    uint64_t next_index;
+    bool loaned;
+};
+
+template<typename T>
+class ShmReader {
+    static_assert(std::is_trivially_copyable<T>::value, "Shared-memory samples must be trivially copyable");
+
+public:
+    ShmReader() : header(nullptr), slots(nullptr), cursor(0), lost(0) {}
+
+    // Maps an existing ring. Up to `history` of the newest samples already
+    // in it are delivered first; 0 starts with the next sample written.
+    bool open(const std::string& name, size_t history = 0) {
+        header = nullptr;
+        if (!segment.open(name) || segment.size() < sizeof(ShmRingHeader)) return false;
+
+        ShmRingHeader* mapped = static_cast<ShmRingHeader*>(segment.data());
+        if (mapped->magic != ShmRingHeader::MAGIC || mapped->version != ShmRingHeader::VERSION ||
+            mapped->slot_size != sizeof(ShmSlot<T>) ||
+            segment.size() < sizeof(ShmRingHeader) + mapped->capacity * sizeof(ShmSlot<T>)) {
+            segment.close();
+            return false;
+        }
+
+        header = mapped;
+        slots = reinterpret_cast<ShmSlot<T>*>(static_cast<char*>(segment.data()) + sizeof(ShmRingHeader));
+        uint64_t written = header->write_count.load(std::memory_order_acquire);
+        uint64_t replay = std::min<uint64_t>(std::min<uint64_t>(history, header->capacity), written);
+        cursor = written - replay;
+        lost = 0;
+        return true;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+
+    // Copies the next unread sample; false when the reader is caught up
+    bool take(T& sample) {
+        for (;;) {
+            uint64_t written = header->write_count.load(std::memory_order_acquire);
+            if (cursor >= written) return false;
+            if (written - cursor > header->capacity) {
+                lost += written - header->capacity - cursor;
+                cursor = written - header->capacity;
+            }
+
+            const ShmSlot<T>& slot = slots[cursor % header->capacity];
+            uint64_t expected = 2 * (cursor + 1);
+            if (slot.sequence.load(std::memory_order_acquire) == expected) {
+                std::memcpy(static_cast<void*>(&sample), &slot.value, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == expected) {
+                    ++cursor;
+                    return true;
+                }
+            }
+            // The writer lapped us on this slot
+            ++lost;
+            ++cursor;
+        }
+    }
+
+    // Blocks until an unread sample is available or the timeout passes
+    bool waitForSample(std::chrono::microseconds timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;) {
+            uint32_t observed = header->notify.load(std::memory_order_seq_cst);
+            if (available() != 0) return true;
+
+            auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) return false;
+
+            header->waiters.fetch_add(1, std::memory_order_seq_cst);
+            if (header->notify.load(std::memory_order_seq_cst) == observed) {
+                shmFutexWait(header->notify, observed, remaining);
+            }
+            header->waiters.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    uint64_t available() const { return header->write_count.load(std::memory_order_acquire) - cursor; }
+    uint64_t getLostCount() const { return lost; }
+
+private:
+    ShmSegment segment;
+    ShmRingHeader* header;
+    const ShmSlot<T>* slots;
+    uint64_t cursor;                    // index of the next sample to take
+    uint64_t lost;
+};
+
+#endif // SHM_TRANSPORT_H
@@ -0,0 +1,434 @@
+#include "wire_format.h"
+#include "sample_fields.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Schema version 1 body sizes
+constexpr size_t ROBOTICS_DATA_BODY = 8 + 8 + 8 + 3 * 8 * RoboticsDataSample::MAX_JOINTS + 8 + 8;
+constexpr size_t SAFETY_METRICS_BODY = 8 + 3 * 8 * SafetyMetricsFrame::MAX_JOINTS + 8 + 8 + 8;
+constexpr size_t SAFETY_ALERT_BODY = 8 + 8 + sizeof(SafetyAlertFrame::alert_id) + sizeof(SafetyAlertFrame::component)
+                                   + sizeof(SafetyAlertFrame::message) + sizeof(SafetyAlertFrame::recommended_action);
+constexpr size_t EMERGENCY_COMMAND_BODY = 8 + 8 + sizeof(EmergencyCommandFrame::reason);
+
+// Host byte order matches the wire on little-endian targets, so fields are
+// copied as is there and assembled byte by byte everywhere else
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+constexpr bool HOST_IS_LITTLE_ENDIAN = true;
+#else
+constexpr bool HOST_IS_LITTLE_ENDIAN = false;
+#endif
+
+static_assert(RoboticsDataSample::MAX_FORCE_CHANNELS == RoboticsDataSample::MAX_JOINTS,
+              "body size assumes equal joint and force channel counts");
+
+size_t bodySize(WireMessageType type) {
+    switch (type) {
+        case WireMessageType::RoboticsData: return ROBOTICS_DATA_BODY;
+        case WireMessageType::SafetyMetrics: return SAFETY_METRICS_BODY;
+        case WireMessageType::SafetyAlert: return SAFETY_ALERT_BODY;
+        case WireMessageType::EmergencyCommand: return EMERGENCY_COMMAND_BODY;
+        default: return 0;
+    }
+}
+
+// Little-endian cursor over an output buffer the caller has sized
+struct WireWriter {
+    uint8_t* position;
+
+    void u8(uint8_t value) { *position++ = value; }
+    void u16(uint16_t value) {
+        for (int i = 0; i < 2; ++i) *position++ = static_cast<uint8_t>(value >> (8 * i));
+    }
+    void u64(uint64_t value) {
+        if (HOST_IS_LITTLE_ENDIAN) {
+            std::memcpy(position, &value, 8);
+            position += 8;
+            return;
+        }
+        for (int i = 0; i < 8; ++i) *position++ = static_cast<uint8_t>(value >> (8 * i));
+    }
+    void f64(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        u64(bits);
+    }
+    void pad(size_t count) {
+        std::memset(position, 0, count);
+        position += count;
+    }
+    template<size_t N>
+    void channels(const double (&values)[N], size_t count) {
+        if (HOST_IS_LITTLE_ENDIAN) {
+            std::memcpy(position, values, count * sizeof(double));
+            std::memset(position + count * sizeof(double), 0, (N - count) * sizeof(double));
+            position += N * sizeof(double);
+            return;
+        }
+        for (size_t i = 0; i < N; ++i) f64(i < count ? values[i] : 0.0);
+    }
+    template<size_t N>
+    void text(const char (&value)[N]) {
+        size_t length = strnlen(value, N - 1);
+        std::memcpy(position, value, length);
+        std::memset(position + length, 0, N - length);
+        position += N;
+    }
+};
+
+struct WireReader {
+    const uint8_t* position;
+
+    uint8_t u8() { return *position++; }
+    uint16_t u16() {
+        uint16_t value = static_cast<uint16_t>(position[0] | (position[1] << 8));
+        position += 2;
+        return value;
+    }
+    uint64_t u64() {
+        uint64_t value = 0;
+        if (HOST_IS_LITTLE_ENDIAN) {
+            std::memcpy(&value, position, 8);
+            position += 8;
+            return value;
+        }
+        for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(position[i]) << (8 * i);
+        position += 8;
+        return value;
+    }
+    double f64() {
+        uint64_t bits = u64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    void skip(size_t count) { position += count; }
+    template<size_t N>
+    void channels(double (&values)[N]) {
+        if (HOST_IS_LITTLE_ENDIAN) {
+            std::memcpy(values, position, N * sizeof(double));
+            position += N * sizeof(double);
+            return;
+        }
+        for (size_t i = 0; i < N; ++i) values[i] = f64();
+    }
+    template<size_t N>
+    void text(char (&value)[N]) {
+        std::memcpy(value, position, N);
+        value[N - 1] = '\0';
+        position += N;
+    }
+};
+
+WireStatus beginEncode(WireMessageType type, uint8_t* buffer, size_t capacity, size_t& written, WireWriter& writer) {
+    written = 0;
+    size_t body = bodySize(type);
+    if (capacity < WIRE_HEADER_SIZE + body) return WireStatus::BufferTooSmall;
+    writer.position = buffer;
+    writer.u16(WIRE_MAGIC);
+    writer.u8(WIRE_SCHEMA_VERSION);
+    writer.u8(static_cast<uint8_t>(type));
+    writer.u16(static_cast<uint16_t>(body));
+    writer.u16(0);
+    written = WIRE_HEADER_SIZE + body;
+    return WireStatus::Ok;
+}
+
+WireStatus beginDecode(WireMessageType type, const uint8_t* buffer, size_t size, WireReader& reader) {
+    WireHeader header;
+    WireStatus status = decodeWireHeader(buffer, size, header);
+    if (status != WireStatus::Ok) return status;
+    if (header.message_type != type) return WireStatus::WrongType;
+    if (header.body_size < bodySize(type)) return WireStatus::Truncated;
+    reader.position = buffer + WIRE_HEADER_SIZE;
+    return WireStatus::Ok;
+}
+
+bool validCounts(uint8_t joint_count, uint8_t force_count) {
+    return joint_count <= RoboticsDataSample::MAX_JOINTS && force_count <= RoboticsDataSample::MAX_FORCE_CHANNELS;
+}
+
+bool validSafetyStatus(uint8_t code) { return code <= static_cast<uint8_t>(SafetyStatus::EmergencyStop); }
+bool validProcedurePhase(uint8_t code) { return code <= static_cast<uint8_t>(ProcedurePhase::Completed); }
+bool validAlertSeverity(uint8_t code) { return code <= static_cast<uint8_t>(AlertSeverity::Emergency); }
+bool validCommandType(uint8_t code) { return code <= static_cast<uint8_t>(CommandType::StatusCheck); }
+
+template<size_t N>
+void copyText(const std::string& source, char (&target)[N]) {
+    size_t length = std::min(source.size(), N - 1);
+    std::memcpy(target, source.data(), length);
+    std::memset(target + length, 0, N - length);
+}
+
+} // namespace
+
+const char* wireStatusName(WireStatus status) {
+    switch (status) {
+        case WireStatus::Ok: return "ok";
+        case WireStatus::BufferTooSmall: return "buffer too small";
+        case WireStatus::Truncated: return "truncated";
+        case WireStatus::BadMagic: return "bad magic";
+        case WireStatus::UnsupportedVersion: return "unsupported schema version";
+        case WireStatus::WrongType: return "wrong message type";
+        case WireStatus::InvalidValue: return "invalid value";
+        default: return "unknown";
+    }
+}
+
+size_t encodedSize(WireMessageType type) {
+    size_t body = bodySize(type);
+    return body == 0 ? 0 : WIRE_HEADER_SIZE + body;
+}
+
+WireStatus decodeWireHeader(const uint8_t* buffer, size_t size, WireHeader& header) {
+    if (size < WIRE_HEADER_SIZE) return WireStatus::Truncated;
+    WireReader reader{buffer};
+    if (reader.u16() != WIRE_MAGIC) return WireStatus::BadMagic;
+    uint8_t version = reader.u8();
+    if (version == 0 || version > WIRE_SCHEMA_VERSION) return WireStatus::UnsupportedVersion;
+    uint8_t type = reader.u8();
+    if (bodySize(static_cast<WireMessageType>(type)) == 0) return WireStatus::InvalidValue;
+    uint16_t body = reader.u16();
+    if (size < WIRE_HEADER_SIZE + body) return WireStatus::Truncated;
+
+    header.schema_version = version;
+    header.message_type = static_cast<WireMessageType>(type);
+    header.body_size = body;
+    return WireStatus::Ok;
+}
+
+WireStatus encodeRoboticsData(const RoboticsDataSample& sample, uint8_t* buffer, size_t capacity, size_t& written) {
+    WireWriter writer;
+    WireStatus status = beginEncode(WireMessageType::RoboticsData, buffer, capacity, written, writer);
+    if (status != WireStatus::Ok) return status;
+    if (!validCounts(sample.joint_count, sample.force_count)) {
+        written = 0;
+        return WireStatus::InvalidValue;
+    }
+
+    writer.u64(static_cast<uint64_t>(sample.timestamp));
+    writer.u64(sample.source_timestamp_ns);
+    writer.u8(sample.joint_count);
+    writer.u8(sample.force_count);
+    writer.u8(static_cast<uint8_t>(sample.safety_status));
+    writer.u8(static_cast<uint8_t>(sample.procedure_phase));
+    writer.u8(sample.emergency_stop_engaged ? 1 : 0);
+    writer.pad(3);
+    writer.channels(sample.joint_positions, sample.joint_count);
+    writer.channels(sample.joint_velocities, sample.joint_count);
+    writer.channels(sample.force_readings, sample.force_count);
+    writer.f64(sample.collision_risk);
+    writer.f64(sample.procedure_duration);
+    return WireStatus::Ok;
+}
+
+WireStatus decodeRoboticsData(const uint8_t* buffer, size_t size, RoboticsDataSample& sample) {
+    WireReader reader;
+    WireStatus status = beginDecode(WireMessageType::RoboticsData, buffer, size, reader);
+    if (status != WireStatus::Ok) return status;
+
+    RoboticsDataSample decoded;
+    decoded.timestamp = static_cast<int64_t>(reader.u64());
+    decoded.source_timestamp_ns = reader.u64();
+    decoded.joint_count = reader.u8();
+    decoded.force_count = reader.u8();
+    uint8_t safety_status = reader.u8();
+    uint8_t procedure_phase = reader.u8();
+    decoded.emergency_stop_engaged = reader.u8() != 0;
+    reader.skip(3);
+    if (!validCounts(decoded.joint_count, decoded.force_count) || !validSafetyStatus(safety_status) ||
+        !validProcedurePhase(procedure_phase)) {
+        return WireStatus::InvalidValue;
+    }
+    decoded.safety_status = static_cast<SafetyStatus>(safety_status);
+    decoded.procedure_phase = static_cast<ProcedurePhase>(procedure_phase);
+    reader.channels(decoded.joint_positions);
+    reader.channels(decoded.joint_velocities);
+    reader.channels(decoded.force_readings);
+    decoded.collision_risk = reader.f64();
+    decoded.procedure_duration = reader.f64();
+    sample = decoded;
+    return WireStatus::Ok;
+}
+
+WireStatus encodeSafetyMetrics(const SafetyMetricsFrame& frame, uint8_t* buffer, size_t capacity, size_t& written) {
+    WireWriter writer;
+    WireStatus status = beginEncode(WireMessageType::SafetyMetrics, buffer, capacity, written, writer);
+    if (status != WireStatus::Ok) return status;
+    if (!validCounts(frame.joint_count, frame.force_count)) {
+        written = 0;
+        return WireStatus::InvalidValue;
+    }
+
+    writer.u8(frame.joint_count);
+    writer.u8(frame.force_count);
+    writer.u8(static_cast<uint8_t>(frame.safety_status));
+    writer.u8(static_cast<uint8_t>(frame.procedure_phase));
+    writer.u8(frame.emergency_stop ? 1 : 0);
+    writer.pad(3);
+    writer.channels(frame.joint_positions, frame.joint_count);
+    writer.channels(frame.joint_velocities, frame.joint_count);
+    writer.channels(frame.force_readings, frame.force_count);
+    writer.f64(frame.collision_risk);
+    writer.f64(frame.procedure_duration);
+    writer.f64(frame.safety_score);
+    return WireStatus::Ok;
+}
+
+WireStatus decodeSafetyMetrics(const uint8_t* buffer, size_t size, SafetyMetricsFrame& frame) {
+    WireReader reader;
+    WireStatus status = beginDecode(WireMessageType::SafetyMetrics, buffer, size, reader);
+    if (status != WireStatus::Ok) return status;
+
+    SafetyMetricsFrame decoded;
+    decoded.joint_count = reader.u8();
+    decoded.force_count = reader.u8();
+    uint8_t safety_status = reader.u8();
+    uint8_t procedure_phase = reader.u8();
+    decoded.emergency_stop = reader.u8() != 0;
+    reader.skip(3);
+    if (!validCounts(decoded.joint_count, decoded.force_count) || !validSafetyStatus(safety_status) ||
+        !validProcedurePhase(procedure_phase)) {
+        return WireStatus::InvalidValue;
+    }
+    decoded.safety_status = static_cast<SafetyStatus>(safety_status);
+    decoded.procedure_phase = static_cast<ProcedurePhase>(procedure_phase);
+    reader.channels(decoded.joint_positions);
+    reader.channels(decoded.joint_velocities);
+    reader.channels(decoded.force_readings);
+    decoded.collision_risk = reader.f64();
+    decoded.procedure_duration = reader.f64();
+    decoded.safety_score = reader.f64();
+    frame = decoded;
+    return WireStatus::Ok;
+}
+
+WireStatus encodeSafetyAlert(const SafetyAlertFrame& frame, uint8_t* buffer, size_t capacity, size_t& written) {
+    WireWriter writer;
+    WireStatus status = beginEncode(WireMessageType::SafetyAlert, buffer, capacity, written, writer);
+    if (status != WireStatus::Ok) return status;
+
+    writer.u64(static_cast<uint64_t>(frame.timestamp));
+    writer.u8(static_cast<uint8_t>(frame.severity));
+    writer.pad(7);
+    writer.text(frame.alert_id);
+    writer.text(frame.component);
+    writer.text(frame.message);
+    writer.text(frame.recommended_action);
+    return WireStatus::Ok;
+}
+
+WireStatus decodeSafetyAlert(const uint8_t* buffer, size_t size, SafetyAlertFrame& frame) {
+    WireReader reader;
+    WireStatus status = beginDecode(WireMessageType::SafetyAlert, buffer, size, reader);
+    if (status != WireStatus::Ok) return status;
+
+    int64_t timestamp = static_cast<int64_t>(reader.u64());
+    uint8_t severity = reader.u8();
+    if (!validAlertSeverity(severity)) return WireStatus::InvalidValue;
+    reader.skip(7);
+    frame.timestamp = timestamp;
+    frame.severity = static_cast<AlertSeverity>(severity);
+    reader.text(frame.alert_id);
+    reader.text(frame.component);
+    reader.text(frame.message);
+    reader.text(frame.recommended_action);
+    return WireStatus::Ok;
+}
+
+WireStatus encodeEmergencyCommand(const EmergencyCommandFrame& frame, uint8_t* buffer, size_t capacity, size_t& written) {
+    WireWriter writer;
+    WireStatus status = beginEncode(WireMessageType::EmergencyCommand, buffer, capacity, written, writer);
+    if (status != WireStatus::Ok) return status;
+
+    writer.u64(static_cast<uint64_t>(frame.timestamp));
+    writer.u8(static_cast<uint8_t>(frame.command_type));
+    writer.u8(static_cast<uint8_t>(frame.severity));
+    writer.u8(frame.requires_acknowledgment ? 1 : 0);
+    writer.pad(5);
+    writer.text(frame.reason);
+    return WireStatus::Ok;
+}
+
+WireStatus decodeEmergencyCommand(const uint8_t* buffer, size_t size, EmergencyCommandFrame& frame) {
+    WireReader reader;
+    WireStatus status = beginDecode(WireMessageType::EmergencyCommand, buffer, size, reader);
+    if (status != WireStatus::Ok) return status;
+
+    int64_t timestamp = static_cast<int64_t>(reader.u64());
+    uint8_t command_type = reader.u8();
+    uint8_t severity = reader.u8();
+    bool requires_acknowledgment = reader.u8() != 0;
+    if (!validCommandType(command_type) || !validAlertSeverity(severity)) return WireStatus::InvalidValue;
+    reader.skip(5);
+    frame.timestamp = timestamp;
+    frame.command_type = static_cast<CommandType>(command_type);
+    frame.severity = static_cast<AlertSeverity>(severity);
+    frame.requires_acknowledgment = requires_acknowledgment;
+    reader.text(frame.reason);
+    return WireStatus::Ok;
+}
+
+void toFrame(const SafetyMetrics& metrics, SafetyMetricsFrame& frame) {
+    copyChannelsAndState(metrics, frame);
+    frame.emergency_stop = metrics.emergency_stop;
+    frame.collision_risk = metrics.collision_risk;
+    frame.procedure_duration = metrics.procedure_duration;
+    frame.safety_score = metrics.safety_score;
+}
+
+SafetyMetrics fromFrame(const SafetyMetricsFrame& frame) {
+    size_t joints = std::min<size_t>(frame.joint_count, SafetyMetricsFrame::MAX_JOINTS);
+    size_t forces = std::min<size_t>(frame.force_count, SafetyMetricsFrame::MAX_FORCE_CHANNELS);
+
+    SafetyMetrics metrics;
+    metrics.joint_positions.assign(frame.joint_positions, frame.joint_positions + joints);
+    metrics.joint_velocities.assign(frame.joint_velocities, frame.joint_velocities + joints);
+    metrics.force_readings.assign(frame.force_readings, frame.force_readings + forces);
+    metrics.safety_status = safetyStatusName(frame.safety_status);
+    metrics.collision_risk = frame.collision_risk;
+    metrics.emergency_stop = frame.emergency_stop;
+    metrics.procedure_phase = procedurePhaseName(frame.procedure_phase);
+    metrics.procedure_duration = frame.procedure_duration;
+    metrics.safety_score = frame.safety_score;
+    return metrics;
+}
+
+void toFrame(const SafetyAlert& alert, SafetyAlertFrame& frame) {
+    frame.timestamp = alert.timestamp;
+    if (!parseAlertSeverity(alert.severity, frame.severity)) frame.severity = AlertSeverity::Warning;
+    copyText(alert.alert_id, frame.alert_id);
+    copyText(alert.component, frame.component);
+    copyText(alert.message, frame.message);
+    copyText(alert.recommended_action, frame.recommended_action);
+}
+
+SafetyAlert fromFrame(const SafetyAlertFrame& frame) {
+    SafetyAlert alert;
+    alert.alert_id = frame.alert_id;
+    alert.timestamp = static_cast<long>(frame.timestamp);
+    alert.severity = alertSeverityName(frame.severity);
+    alert.message = frame.message;
+    alert.component = frame.component;
+    alert.recommended_action = frame.recommended_action;
+    return alert;
+}
+
+void toFrame(const EmergencyCommand& command, EmergencyCommandFrame& frame) {
+    frame.timestamp = command.timestamp;
+    frame.command_type = parseCommandType(command.command_type);
+    if (!parseAlertSeverity(command.severity, frame.severity)) frame.severity = AlertSeverity::Warning;
+    frame.requires_acknowledgment = command.requires_acknowledgment;
+    copyText(command.reason, frame.reason);
+}
+
+EmergencyCommand fromFrame(const EmergencyCommandFrame& frame) {
+    EmergencyCommand command;
+    command.timestamp = static_cast<long>(frame.timestamp);
+    command.command_type = commandTypeName(frame.command_type);
+    command.reason = frame.reason;
+    command.severity = alertSeverityName(frame.severity);
+    command.requires_acknowledgment = frame.requires_acknowledgment;
+    return command;
+}
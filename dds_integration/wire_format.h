@@ -0,0 +1,120 @@
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "data_publisher.h"
+
+// Versioned fixed-size binary encoding of the DDS data types, for the
+// network and for recorded data.
+//
+// Every message is an 8-byte header followed by a fixed-size body. All
+// integers and doubles (IEEE 754 bit patterns) are little-endian whatever
+// the host; status, phase, severity and command fields are one-byte enum
+// codes; joint and force channels are inline arrays of MAX_JOINTS /
+// MAX_FORCE_CHANNELS entries with a count; text is a NUL-padded fixed
+// field, truncated to fit.
+//
+//   offset 0  uint16  magic 0x5253 ("SR")
+//          2  uint8   schema version
+//          3  uint8   message type
+//          4  uint16  body size in bytes
+//          6  uint16  reserved, 0
+//
+// A decoder accepts any schema version up to its own and a body larger
+// than it knows (fields added by a later version are appended and
+// skipped), so recordings stay readable as the schema grows. Encoding and
+// decoding never allocate.
+
+constexpr uint16_t WIRE_MAGIC = 0x5253;
+constexpr uint8_t WIRE_SCHEMA_VERSION = 1;
+constexpr size_t WIRE_HEADER_SIZE = 8;
+
+enum class WireMessageType : uint8_t {
+    RoboticsData = 1,
+    SafetyMetrics,
+    SafetyAlert,
+    EmergencyCommand
+};
+
+enum class WireStatus : uint8_t {
+    Ok = 0,
+    BufferTooSmall,                     // encode: capacity below encodedSize()
+    Truncated,                          // decode: fewer bytes than the header promises
+    BadMagic,
+    UnsupportedVersion,
+    WrongType,
+    InvalidValue                        // enum code or channel count out of range
+};
+
+const char* wireStatusName(WireStatus status);
+
+struct WireHeader {
+    uint8_t schema_version;
+    WireMessageType message_type;
+    uint16_t body_size;
+};
+
+// Fixed-layout counterparts of SafetyMetrics, SafetyAlert and
+// EmergencyCommand; RoboticsData uses RoboticsDataSample.
+struct SafetyMetricsFrame {
+    static constexpr size_t MAX_JOINTS = RoboticsDataSample::MAX_JOINTS;
+    static constexpr size_t MAX_FORCE_CHANNELS = RoboticsDataSample::MAX_FORCE_CHANNELS;
+
+    uint8_t joint_count;
+    uint8_t force_count;
+    SafetyStatus safety_status;
+    ProcedurePhase procedure_phase;
+    bool emergency_stop;
+    double joint_positions[MAX_JOINTS];
+    double joint_velocities[MAX_JOINTS];
+    double force_readings[MAX_FORCE_CHANNELS];
+    double collision_risk;
+    double procedure_duration;
+    double safety_score;
+};
+
+struct SafetyAlertFrame {
+    int64_t timestamp;
+    AlertSeverity severity;
+    char alert_id[32];
+    char component[32];
+    char message[128];
+    char recommended_action[128];
+};
+
+struct EmergencyCommandFrame {
+    int64_t timestamp;
+    CommandType command_type;
+    AlertSeverity severity;
+    bool requires_acknowledgment;
+    char reason[128];
+};
+
+// Total encoded size (header included) of one message of this type
+size_t encodedSize(WireMessageType type);
+
+WireStatus decodeWireHeader(const uint8_t* buffer, size_t size, WireHeader& header);
+
+// encode*() write encodedSize() bytes and report them in `written`
+WireStatus encodeRoboticsData(const RoboticsDataSample& sample, uint8_t* buffer, size_t capacity, size_t& written);
+WireStatus encodeSafetyMetrics(const SafetyMetricsFrame& frame, uint8_t* buffer, size_t capacity, size_t& written);
+WireStatus encodeSafetyAlert(const SafetyAlertFrame& frame, uint8_t* buffer, size_t capacity, size_t& written);
+WireStatus encodeEmergencyCommand(const EmergencyCommandFrame& frame, uint8_t* buffer, size_t capacity, size_t& written);
+
+// decode*() leave the output untouched unless they return Ok
+WireStatus decodeRoboticsData(const uint8_t* buffer, size_t size, RoboticsDataSample& sample);
+WireStatus decodeSafetyMetrics(const uint8_t* buffer, size_t size, SafetyMetricsFrame& frame);
+WireStatus decodeSafetyAlert(const uint8_t* buffer, size_t size, SafetyAlertFrame& frame);
+WireStatus decodeEmergencyCommand(const uint8_t* buffer, size_t size, EmergencyCommandFrame& frame);
+
+// Conversions to and from the string/vector types. Unknown status, phase
+// and severity names map to Warning, Initialization and Warning.
+void toFrame(const SafetyMetrics& metrics, SafetyMetricsFrame& frame);
+SafetyMetrics fromFrame(const SafetyMetricsFrame& frame);
+void toFrame(const SafetyAlert& alert, SafetyAlertFrame& frame);
+SafetyAlert fromFrame(const SafetyAlertFrame& frame);
+void toFrame(const EmergencyCommand& command, EmergencyCommandFrame& frame);
+EmergencyCommand fromFrame(const EmergencyCommandFrame& frame);
+
+#endif // WIRE_FORMAT_H
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "../core_engine/async_logger.h"
+
+namespace {
+
+const LogSite DISTANCE_SITE{LogLevel::Warning, "Test", "Distance {}mm from {} (cycle {}, ok {})"};
+const LogSite DEBUG_SITE{LogLevel::Debug, "Test", "not shown"};
+const LogSite COUNTER_SITE{LogLevel::Info, "Test", "thread {} message {}"};
+
+std::string temporaryLogPath(const std::string& name) {
+    return ::testing::TempDir() + "async_logger_" + name + "_" + std::to_string(getpid()) + ".log";
+}
+
+std::vector<std::string> readLines(const std::string& path) {
+    std::vector<std::string> lines;
+    std::ifstream file(path);
+    for(std::string line; std::getline(file, line);) lines.push_back(line);
+    return lines;
+}
+
+} // namespace
+
+TEST(AsyncLoggerTest, FormatsArgumentsIntoFormatString) {
+    LogRecord record{};
+    record.timestamp_ns = 0;
+    record.site = &DISTANCE_SITE;
+    record.arg_count = 4;
+    record.types[0] = LogRecord::ArgType::Double;
+    record.values[0].d = 1.5;
+    record.types[1] = LogRecord::ArgType::Text;
+    std::snprintf(record.text, sizeof(record.text), "tip");
+    record.values[1].text = {0, 3};
+    record.types[2] = LogRecord::ArgType::Unsigned;
+    record.values[2].u = 42;
+    record.types[3] = LogRecord::ArgType::Bool;
+    record.values[3].b = true;
+    
+    EXPECT_EQ(AsyncLogger::formatRecord(record),
+              "1970-01-01T00:00:00.000000Z WARNING Test: Distance 1.5mm from tip (cycle 42, ok true)");
+}
+
+TEST(AsyncLoggerTest, WritesRecordsFromManyThreadsInOrder) {
+    std::string path = temporaryLogPath("threads");
+    std::remove(path.c_str());
+    {
+        AsyncLoggerOptions options;
+        options.path = path;
+        AsyncLogger logger(options);
+        
+        std::vector<std::thread> threads;
+        for(int t = 0; t < 4; ++t) {
+            threads.emplace_back([&logger, t]() {
+                for(int i = 0; i < 500; ++i) logger.log(COUNTER_SITE, t, i);
+            });
+        }
+        for(auto& thread : threads) thread.join();
+        
+        logger.log(DEBUG_SITE);
+        logger.log(DISTANCE_SITE, 3.25, std::string("instrument"), 7u, false);
+        logger.flush();
+        EXPECT_EQ(logger.getWrittenCount() + logger.getDroppedCount(), 2001u);
+    }
+    
+    std::vector<std::string> lines = readLines(path);
+    ASSERT_FALSE(lines.empty());
+    EXPECT_NE(lines.back().find("WARNING Test: Distance 3.25mm from instrument (cycle 7, ok false)"), std::string::npos);
+    for(size_t i = 1; i < lines.size(); ++i) EXPECT_LE(lines[i - 1].substr(0, 27), lines[i].substr(0, 27));
+    std::remove(path.c_str());
+}
+
+TEST(AsyncLoggerTest, FullBufferDropsAndCounts) {
+    std::string path = temporaryLogPath("drops");
+    std::remove(path.c_str());
+    AsyncLoggerOptions options;
+    options.path = path;
+    options.buffer_records = 16;
+    options.flush_interval = std::chrono::hours(1);   // nothing drains until flush()
+    AsyncLogger logger(options);
+    
+    for(int i = 0; i < 100; ++i) logger.log(COUNTER_SITE, 0, i);
+    EXPECT_EQ(logger.getDroppedCount(), 84u);
+    
+    logger.flush();
+    EXPECT_EQ(logger.getWrittenCount(), 16u);
+    logger.log(COUNTER_SITE, 0, 100);
+    logger.flush();
+    EXPECT_EQ(logger.getWrittenCount(), 17u);
+    std::remove(path.c_str());
+}
+
+TEST(AsyncLoggerTest, RotatesBySize) {
+    std::string path = temporaryLogPath("rotate");
+    for(const char* suffix : {"", ".1", ".2"}) std::remove((path + suffix).c_str());
+    {
+        AsyncLoggerOptions options;
+        options.path = path;
+        options.max_file_bytes = 2000;
+        options.max_files = 3;
+        AsyncLogger logger(options);
+        for(int i = 0; i < 200; ++i) {
+            logger.log(COUNTER_SITE, 1, i);
+            if(i % 10 == 0) logger.flush();
+        }
+    }
+    
+    std::vector<std::string> current = readLines(path);
+    std::vector<std::string> previous = readLines(path + ".1");
+    EXPECT_FALSE(readLines(path + ".2").empty());
+    EXPECT_TRUE(readLines(path + ".3").empty());
+    ASSERT_FALSE(current.empty());
+    EXPECT_NE(current.back().find("message 199"), std::string::npos);
+    EXPECT_LE(previous.size() * 40, 2100u);
+    for(const char* suffix : {"", ".1", ".2"}) std::remove((path + suffix).c_str());
+}
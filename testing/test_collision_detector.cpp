@@ -0,0 +1,302 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <random>
+#include "../core_engine/collision_detector.h"
+#include "../core_engine/kinematics.h"
+
+class CollisionDetectorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        detector = std::make_unique<CollisionDetector>();
+        
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> coordinate(-100.0, 100.0);
+        obstacles.resize(20000);
+        for(auto& obstacle : obstacles) {
+            obstacle = Eigen::Vector3d(coordinate(rng), coordinate(rng), coordinate(rng));
+        }
+        detector->setObstacles(obstacles);
+    }
+    
+    std::unique_ptr<CollisionDetector> detector;
+    std::vector<Eigen::Vector3d> obstacles;
+};
+
+TEST_F(CollisionDetectorTest, IndexedDistanceMatchesLinearScan) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coordinate(-120.0, 120.0);
+    
+    for(int i = 0; i < 200; ++i) {
+        Eigen::Vector3d point(coordinate(rng), coordinate(rng), coordinate(rng));
+        EXPECT_DOUBLE_EQ(detector->calculateMinimumDistance(point),
+                         detector->calculateMinimumDistance(point, obstacles));
+    }
+}
+
+TEST_F(CollisionDetectorTest, RadiusQueriesMatchLinearScan) {
+    Eigen::Vector3d point = obstacles[123] + Eigen::Vector3d(1.0, 0.5, 0.0);
+    
+    std::vector<size_t> expected;
+    for(size_t i = 0; i < obstacles.size(); ++i) {
+        if((obstacles[i] - point).norm() < detector->getWarningDistance()) expected.push_back(i);
+    }
+    
+    std::vector<size_t> found;
+    detector->findObstaclesWithinWarningDistance(point, found);
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, expected);
+    
+    EXPECT_TRUE(detector->violatesMinSafeDistance(point));
+    EXPECT_TRUE(detector->checkInstrumentCollision(point));
+    EXPECT_FALSE(detector->violatesMinSafeDistance(Eigen::Vector3d(500.0, 500.0, 500.0)));
+}
+
+TEST_F(CollisionDetectorTest, EmptyObstacleSet) {
+    detector->setObstacles({});
+    EXPECT_EQ(detector->calculateMinimumDistance(Eigen::Vector3d::Zero()), std::numeric_limits<double>::max());
+    EXPECT_FALSE(detector->checkInstrumentCollision(Eigen::Vector3d::Zero()));
+}
+
+TEST_F(CollisionDetectorTest, DistanceTrackerAgreesWithExactQueries) {
+    DistanceTracker tracker = detector->createDistanceTracker();
+    
+    // Random walk with micrometre-scale steps (units are mm), passing
+    // through open space and near obstacles
+    std::mt19937 rng(3);
+    std::normal_distribution<double> step(0.0, 0.005);
+    Eigen::Vector3d tip = obstacles[42] + Eigen::Vector3d(8.0, 0.0, 0.0);
+    Eigen::Vector3d drift = (obstacles[42] - tip).normalized() * 0.002;
+    
+    for(int cycle = 0; cycle < 5000; ++cycle) {
+        tip += drift + Eigen::Vector3d(step(rng), step(rng), step(rng));
+        double exact = detector->calculateMinimumDistance(tip);
+        TrackedDistance tracked = tracker.update(tip);
+        
+        if(tracked.exact) {
+            EXPECT_DOUBLE_EQ(tracked.distance, exact);
+        } else {
+            EXPECT_LE(tracked.distance, exact + 1e-9);
+            EXPECT_GT(tracked.distance, detector->getWarningDistance());
+        }
+    }
+    
+    const DistanceTrackerStats& stats = tracker.getStats();
+    EXPECT_EQ(stats.updates, 5000u);
+    EXPECT_EQ(stats.full_queries, 1u);
+    EXPECT_GT(stats.skipped, 0u);
+    EXPECT_EQ(stats.skipped + stats.local_queries + stats.full_queries, stats.updates);
+}
+
+TEST_F(CollisionDetectorTest, DistanceTrackerResetsWhenObstaclesChange) {
+    DistanceTracker tracker = detector->createDistanceTracker();
+    tracker.update(Eigen::Vector3d::Zero());
+    
+    detector->setObstacles({Eigen::Vector3d(1.0, 0.0, 0.0)});
+    TrackedDistance tracked = tracker.update(Eigen::Vector3d::Zero());
+    EXPECT_TRUE(tracked.exact);
+    EXPECT_DOUBLE_EQ(tracked.distance, 1.0);
+    EXPECT_EQ(tracker.getStats().full_queries, 2u);
+}
+
+TEST_F(CollisionDetectorTest, DistanceTrackerFollowsSafetyMargins) {
+    detector->setObstacles({Eigen::Vector3d(10.0, 0.0, 0.0)});
+    DistanceTracker tracker = detector->createDistanceTracker();
+    tracker.update(Eigen::Vector3d::Zero());
+    EXPECT_FALSE(tracker.update(Eigen::Vector3d(0.1, 0.0, 0.0)).exact);     // 9.9 mm, beyond the 5 mm warning
+    
+    detector->setSafetyMargins(2.0, 12.0);
+    TrackedDistance tracked = tracker.update(Eigen::Vector3d(0.2, 0.0, 0.0));
+    EXPECT_TRUE(tracked.exact);
+    EXPECT_DOUBLE_EQ(tracked.distance, 9.8);
+}
+
+TEST(SelfCollisionTest, SegmentDistanceCases) {
+    Eigen::Vector3d o = Eigen::Vector3d::Zero();
+    Eigen::Vector3d x(1.0, 0.0, 0.0);
+    // Crossing segments offset in z
+    EXPECT_NEAR(segmentSegmentDistance(o, x, Eigen::Vector3d(0.5, -1.0, 2.0), Eigen::Vector3d(0.5, 1.0, 2.0)), 2.0, 1e-12);
+    // Parallel segments
+    EXPECT_NEAR(segmentSegmentDistance(o, x, Eigen::Vector3d(0.0, 3.0, 0.0), Eigen::Vector3d(1.0, 3.0, 0.0)), 3.0, 1e-12);
+    // Collinear, end to end
+    EXPECT_NEAR(segmentSegmentDistance(o, x, Eigen::Vector3d(3.0, 0.0, 0.0), Eigen::Vector3d(4.0, 0.0, 0.0)), 2.0, 1e-12);
+    // Degenerate segment (point)
+    EXPECT_NEAR(segmentSegmentDistance(o, x, Eigen::Vector3d(0.5, 4.0, 0.0), Eigen::Vector3d(0.5, 4.0, 0.0)), 4.0, 1e-12);
+}
+
+TEST(SelfCollisionTest, FoldedArmReportsClosestLinkPair) {
+    CollisionDetector detector;
+    // Links 0 and 2 run anti-parallel 3mm apart: capsules of radius 1mm leave 1mm < 2mm margin
+    std::vector<Eigen::Vector3d> joints = {
+        Eigen::Vector3d(0, 0, 0), Eigen::Vector3d(50, 0, 0),
+        Eigen::Vector3d(50, 3, 0), Eigen::Vector3d(0, 3, 0)
+    };
+    EXPECT_TRUE(detector.checkSelfCollision(joints));
+    const SelfCollisionResult& result = detector.getLastSelfCollision();
+    EXPECT_EQ(result.body_a, 0);
+    EXPECT_EQ(result.body_b, 2);
+    EXPECT_NEAR(result.distance, 1.0, 1e-12);
+    
+    joints[2] = Eigen::Vector3d(50, 30, 0);
+    joints[3] = Eigen::Vector3d(50, 60, 0);
+    EXPECT_FALSE(detector.checkSelfCollision(joints));
+}
+
+TEST(SelfCollisionTest, CoincidentFrameOriginsAreNotACollision) {
+    // Joint 4 of the Ethicon arm has a = d = 0, so two of the origins
+    // Kinematics::jointPositions returns always coincide
+    Kinematics<6> kinematics(ETHICON_ARM_DH_PARAMETERS);
+    CollisionDetector detector;
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> angle(-1.0, 1.0);
+    for(int pose = 0; pose < 50; ++pose) {
+        Kinematics<6>::JointVector angles;
+        for(auto& value : angles) value = angle(rng);
+        std::array<Kinematics<6>::Vector3, 7> origins;
+        ASSERT_EQ(kinematics.jointPositions(angles, origins), KinematicsStatus::Ok);
+        std::vector<Eigen::Vector3d> joints;
+        for(const auto& origin : origins) joints.push_back(origin * 1000.0);
+        
+        EXPECT_FALSE(detector.checkSelfCollision(joints)) << "pose " << pose << ": links "
+            << detector.getLastSelfCollision().body_a << ", " << detector.getLastSelfCollision().body_b;
+    }
+    
+    // The links on either side of the zero-length one still collide with the rest
+    std::vector<Eigen::Vector3d> folded = {
+        Eigen::Vector3d(0, 0, 0), Eigen::Vector3d(50, 0, 0), Eigen::Vector3d(50, 0, 0),
+        Eigen::Vector3d(50, 3, 0), Eigen::Vector3d(0, 3, 0)
+    };
+    EXPECT_TRUE(detector.checkSelfCollision(folded));
+    EXPECT_EQ(detector.getLastSelfCollision().body_a, 0);
+    EXPECT_EQ(detector.getLastSelfCollision().body_b, 3);
+}
+
+TEST(SelfCollisionTest, AllowedCollisionMatrixSkipsPairs) {
+    SelfCollisionChecker checker(3);
+    checker.setBody(0, Capsule{Eigen::Vector3d(0, 0, 0), Eigen::Vector3d(10, 0, 0), 1.0});
+    checker.setBody(1, Capsule{Eigen::Vector3d(0, 1, 0), Eigen::Vector3d(10, 1, 0), 1.0});
+    checker.setBody(2, Capsule{Eigen::Vector3d(100, 0, 0), Eigen::Vector3d(110, 0, 0), 1.0});
+    
+    EXPECT_TRUE(checker.check(0.5).collision);
+    EXPECT_EQ(checker.getNarrowphaseTests(), 1u);   // body 2 pruned by the broadphase
+    
+    checker.setCollisionAllowed(0, 1);
+    SelfCollisionResult result = checker.check(0.5);
+    EXPECT_FALSE(result.collision);
+    EXPECT_EQ(result.body_a, -1);
+}
+
+TEST(ObstacleCloudTest, EveryKernelMatchesDoubleScan) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> coordinate(-100.0, 100.0);
+    
+    // Sizes around the SIMD widths exercise the +inf padding
+    for(size_t count : {1u, 7u, 8u, 9u, 17u, 1000u}) {
+        std::vector<Eigen::Vector3d> obstacles(count);
+        for(auto& obstacle : obstacles) obstacle = Eigen::Vector3d(coordinate(rng), coordinate(rng), coordinate(rng));
+        ObstacleCloudSoA cloud(obstacles);
+        
+        for(int i = 0; i < 50; ++i) {
+            Eigen::Vector3d point(coordinate(rng), coordinate(rng), coordinate(rng));
+            double expected_sq = std::numeric_limits<double>::max();
+            for(const auto& obstacle : obstacles) expected_sq = std::min(expected_sq, (point - obstacle).squaredNorm());
+            
+            for(DistanceKernel kernel : {DistanceKernel::Scalar, DistanceKernel::SSE, DistanceKernel::AVX2}) {
+                EXPECT_NEAR(cloud.minSquaredDistance(point, kernel), expected_sq, 1e-4 * (1.0 + expected_sq))
+                    << distanceKernelName(kernel) << " with " << count << " obstacles";
+            }
+        }
+    }
+}
+
+TEST(ObstacleCloudTest, SmallStoredSetUsesScanAndAgreesWithIndex) {
+    CollisionDetector detector;
+    std::vector<Eigen::Vector3d> obstacles = {
+        Eigen::Vector3d(10, 0, 0), Eigen::Vector3d(0, 20, 0), Eigen::Vector3d(0, 0, -1.5)
+    };
+    detector.setObstacles(obstacles);
+    
+    Eigen::Vector3d origin = Eigen::Vector3d::Zero();
+    EXPECT_NEAR(detector.calculateMinimumDistance(origin), 1.5, 1e-6);
+    EXPECT_NEAR(detector.calculateMinimumDistance(origin),
+                detector.getObstacleIndex().nearestDistance(origin), 1e-6);
+    EXPECT_TRUE(detector.checkInstrumentCollision(origin));
+    
+    ObstacleCloudSoA empty;
+    EXPECT_EQ(empty.minDistance(origin), std::numeric_limits<double>::max());
+}
+
+TEST(ObstacleCloudTest, PassedObstaclesMatchPrebuiltCloud) {
+    std::vector<Eigen::Vector3d> obstacles = {Eigen::Vector3d(10, 0, 0), Eigen::Vector3d(0, 4, 0)};
+    ObstacleCloudSoA cloud;
+    cloud.assign(obstacles);
+    Eigen::Vector3d origin = Eigen::Vector3d::Zero();
+    
+    const CollisionDetector detector;
+    EXPECT_NEAR(detector.calculateMinimumDistance(origin, obstacles), 4.0, 1e-6);
+    EXPECT_NEAR(detector.calculateMinimumDistance(origin, cloud), 4.0, 1e-6);
+    EXPECT_EQ(detector.calculateMinimumDistance(origin, std::vector<Eigen::Vector3d>()), std::numeric_limits<double>::max());
+    EXPECT_EQ(detector.calculateMinimumDistance(origin, ObstacleCloudSoA()), std::numeric_limits<double>::max());
+}
+
+TEST(DistanceFieldTest, InterpolationStaysWithinErrorBound) {
+    std::mt19937 rng(5);
+    std::normal_distribution<double> gaussian(0.0, 1.0);
+    std::vector<Eigen::Vector3d> shell(5000);
+    for(auto& point : shell) point = Eigen::Vector3d(gaussian(rng), gaussian(rng), gaussian(rng)).normalized() * 30.0;
+    
+    DistanceField field;
+    field.build(shell, DistanceFieldOptions{1.0, 10.0});
+    ObstacleIndex index;
+    index.build(shell);
+    
+    // The hollow middle of the shell is beyond the band and needs no bricks
+    EXPECT_TRUE(field.lookup(Eigen::Vector3d::Zero()).beyond_band);
+    std::uniform_real_distribution<double> coordinate(-38.0, 38.0);
+    for(int i = 0; i < 2000; ++i) {
+        Eigen::Vector3d point(coordinate(rng), coordinate(rng), coordinate(rng));
+        double exact = index.nearestDistance(point);
+        FieldDistance sample = field.lookup(point);
+        if(exact < field.getBand() - field.errorBound()) {
+            ASSERT_FALSE(sample.beyond_band);
+            EXPECT_NEAR(sample.distance, exact, field.errorBound());
+        } else {
+            // Truncated to the band, never below the true distance by more than the bound
+            EXPECT_GE(sample.distance, std::min(exact, field.getBand()) - field.errorBound());
+        }
+    }
+    const size_t dense_bricks = 10 * 10 * 10;  // 80 mm cube in 8 mm bricks
+    EXPECT_LT(field.getAllocatedBrickCount(), dense_bricks);
+}
+
+TEST(DistanceFieldTest, QueryIsExactNearSafetyLimit) {
+    std::vector<Eigen::Vector3d> obstacles;
+    for(int x = -20; x <= 20; ++x)
+        for(int y = -20; y <= 20; ++y) obstacles.emplace_back(x, y, 0.0);
+    
+    DistanceField field;
+    field.build(obstacles);
+    
+    FieldDistance far = field.query(Eigen::Vector3d(0.3, 0.2, 12.0), 2.0);
+    EXPECT_FALSE(far.exact);
+    EXPECT_NEAR(far.distance, 12.0, field.errorBound());
+    EXPECT_GT(far.gradient.z(), 0.5);
+    
+    FieldDistance near = field.query(Eigen::Vector3d(0.0, 0.0, 1.5), 2.0);
+    EXPECT_TRUE(near.exact);
+    EXPECT_DOUBLE_EQ(near.distance, 1.5);
+    EXPECT_NEAR(near.gradient.z(), 1.0, 1e-12);
+}
+
+TEST(DistanceFieldTest, AsyncBuildSwapsFieldIn) {
+    CollisionDetector detector;
+    EXPECT_FALSE(detector.hasStaticAnatomy());
+    EXPECT_TRUE(detector.queryStaticAnatomy(Eigen::Vector3d::Zero()).beyond_band);
+    
+    detector.setStaticAnatomyAsync({Eigen::Vector3d(0, 0, 10), Eigen::Vector3d(0, 0, -10)});
+    ASSERT_TRUE(detector.waitForStaticAnatomy());
+    FieldDistance result = detector.queryStaticAnatomy(Eigen::Vector3d(0, 0, 9));
+    EXPECT_TRUE(result.exact);
+    EXPECT_NEAR(result.distance, 1.0, 1e-12);
+}
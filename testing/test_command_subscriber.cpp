@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "../dds_integration/command_subscriber.h"
+
+namespace {
+
+ControlCommand makeCommand(const std::string& type, double value = 0.0) {
+    ControlCommand command;
+    command.timestamp = 0;
+    command.command_type = type;
+    command.reason = "test";
+    command.value = value;
+    return command;
+}
+
+// Polls a condition for up to two seconds
+template<typename Condition>
+bool eventually(Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while(!condition()) {
+        if(std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(CommandSubscriberTest, ParsesCommandNames) {
+    EXPECT_EQ(parseCommandType("EMERGENCY_STOP"), CommandType::EmergencyStop);
+    EXPECT_EQ(parseCommandType("RESUME_OPERATION"), CommandType::ResumeOperation);
+    EXPECT_EQ(parseCommandType("FORCE_LIMIT_ADJUST"), CommandType::ForceLimitAdjust);
+    EXPECT_EQ(parseCommandType("STATUS_CHECK"), CommandType::StatusCheck);
+    // Same length as a known name, different text
+    EXPECT_EQ(parseCommandType("EMERGENCY_STOQ"), CommandType::Unknown);
+    EXPECT_EQ(parseCommandType(""), CommandType::Unknown);
+}
+
+TEST(CommandSubscriberTest, DispatchesByCommandType) {
+    CommandSubscriber subscriber;
+    std::atomic<int> force_adjustments{0};
+    std::atomic<double> last_value{0.0};
+    std::atomic<int> unknown{0};
+    subscriber.setCommandHandler(CommandType::ForceLimitAdjust, [&](const ControlCommand& command) {
+        last_value = command.value;
+        force_adjustments++;
+    });
+    subscriber.setCommandHandler(CommandType::Unknown, [&](const ControlCommand&) { unknown++; });
+    
+    subscriber.submitCommand(makeCommand("FORCE_LIMIT_ADJUST", 12.5));
+    subscriber.submitCommand(makeCommand("SELF_DESTRUCT"));
+    ASSERT_TRUE(eventually([&]() { return subscriber.getHandledCount() == 2; }));
+    EXPECT_EQ(force_adjustments.load(), 1);
+    EXPECT_DOUBLE_EQ(last_value.load(), 12.5);
+    EXPECT_EQ(unknown.load(), 1);
+    EXPECT_EQ(subscriber.getCommandLatency().count, 2u);
+}
+
+TEST(CommandSubscriberTest, ReplacesHandlersWhileDispatching) {
+    CommandSubscriber subscriber;
+    std::atomic<int> first{0};
+    std::atomic<int> second{0};
+    subscriber.setCommandHandler(CommandType::StatusCheck, [&](const ControlCommand&) { first++; });
+    
+    std::thread submitter([&]() {
+        for(int i = 0; i < 200; ++i) subscriber.submitCommand(makeCommand("STATUS_CHECK"));
+    });
+    for(int i = 0; i < 50; ++i) {
+        subscriber.setCommandHandler(CommandType::StatusCheck, [&](const ControlCommand&) { second++; });
+    }
+    submitter.join();
+    ASSERT_TRUE(eventually([&]() { return subscriber.getHandledCount() == 200; }));
+    EXPECT_EQ(first.load() + second.load(), 200);
+    
+    // Commands after the last replacement reach the final handler
+    subscriber.submitCommand(makeCommand("STATUS_CHECK"));
+    ASSERT_TRUE(eventually([&]() { return subscriber.getHandledCount() == 201; }));
+    EXPECT_EQ(first.load() + second.load(), 201);
+    EXPECT_GE(second.load(), 1);
+}
+
+TEST(CommandSubscriberTest, EmergencyStopBypassesBusyQueue) {
+    CommandSubscriber subscriber;
+    std::atomic<bool> released{false};
+    std::atomic<bool> stopped{false};
+    subscriber.setCommandHandler(CommandType::StatusCheck, [&](const ControlCommand&) {
+        while(!released) std::this_thread::sleep_for(std::chrono::microseconds(100));
+    });
+    subscriber.setCommandHandler(CommandType::EmergencyStop, [&](const ControlCommand&) { stopped = true; });
+    
+    // The normal lane is stuck on the first status check with more queued
+    for(int i = 0; i < 5; ++i) subscriber.submitCommand(makeCommand("STATUS_CHECK"));
+    subscriber.submitCommand(makeCommand("EMERGENCY_STOP"));
+    bool handled = eventually([&]() { return stopped.load(); });
+    released = true;
+    
+    EXPECT_TRUE(handled);
+    EXPECT_EQ(subscriber.getEmergencyStopLatency().count, 1u);
+    ASSERT_TRUE(eventually([&]() { return subscriber.getHandledCount() == 6; }));
+}
+
+TEST(CommandSubscriberTest, RecordsEmergencyStopLatency) {
+    CommandSubscriber subscriber;
+    subscriber.setCommandHandler(CommandType::EmergencyStop, [](const ControlCommand&) {});
+    for(int i = 0; i < 100; ++i) {
+        subscriber.submitCommand(makeCommand("EMERGENCY_STOP"));
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    ASSERT_TRUE(eventually([&]() { return subscriber.getHandledCount() == 100; }));
+    
+    LatencySnapshot latency = subscriber.getEmergencyStopLatency();
+    EXPECT_EQ(latency.count, 100u);
+    // Loose bound: shared CI machines without real-time scheduling
+    EXPECT_LT(latency.percentile(0.5), 5000000.0);
+    std::string metrics = subscriber.formatMetrics();
+    EXPECT_NE(metrics.find("lane=\"emergency_stop\""), std::string::npos);
+}
+
+TEST(CommandSubscriberTest, ShutdownHandlesPendingEmergencyStops) {
+    CommandSubscriber subscriber;
+    std::atomic<int> stops{0};
+    subscriber.setCommandHandler(CommandType::EmergencyStop, [&](const ControlCommand&) { stops++; });
+    
+    std::thread submitter([&]() {
+        for(int i = 0; i < 100; ++i) {
+            ControlCommand command{};
+            command.command_type = "EMERGENCY_STOP";
+            subscriber.submitCommand(command);
+        }
+    });
+    submitter.join();
+    subscriber.shutdown();
+    EXPECT_EQ(stops.load(), 100);
+}
+
+TEST(CommandSubscriberTest, EmergencyStopsRacingShutdownAreHandled) {
+    for(int round = 0; round < 20; ++round) {
+        CommandSubscriber subscriber;
+        std::atomic<int> stops{0};
+        std::atomic<bool> go{false};
+        subscriber.setCommandHandler(CommandType::EmergencyStop, [&](const ControlCommand&) { stops++; });
+        
+        std::vector<std::thread> submitters;
+        for(int t = 0; t < 3; ++t) {
+            submitters.emplace_back([&]() {
+                while(!go.load()) std::this_thread::yield();
+                for(int i = 0; i < 200; ++i) subscriber.submitCommand(makeCommand("EMERGENCY_STOP"));
+            });
+        }
+        go = true;
+        subscriber.shutdown();
+        for(auto& submitter : submitters) submitter.join();
+        EXPECT_EQ(stops.load(), 600) << "round " << round;
+    }
+}
+
+TEST(CommandSubscriberTest, FollowsSharedMemoryCommandTopic) {
+    std::string topic = "/srs_test_commands_" + std::to_string(getpid());
+    ShmWriter<ControlCommandSample> writer;
+    ASSERT_TRUE(writer.create({topic, 64}));
+    
+    CommandSubscriberOptions options;
+    options.transport = topic;
+    CommandSubscriber subscriber(options);
+    ASSERT_TRUE(subscriber.isFollowingTransport());
+    std::atomic<bool> stopped{false};
+    std::string reason;
+    subscriber.setCommandHandler(CommandType::EmergencyStop, [&](const ControlCommand& command) {
+        reason = command.reason;
+        stopped = true;
+    });
+    
+    ControlCommandSample& sample = writer.loan();
+    sample.timestamp = 1;
+    sample.source_timestamp_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    sample.type = CommandType::EmergencyStop;
+    sample.value = 0.0;
+    std::strncpy(sample.reason, "pedal released", sizeof(sample.reason));
+    writer.commit();
+    
+    ASSERT_TRUE(eventually([&]() { return stopped.load(); }));
+    EXPECT_EQ(reason, "pedal released");
+}
@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../core_engine/flight_recorder.h"
+#include "../core_engine/real_time_controller.h"
+
+namespace {
+
+// Fresh directory per test, removed afterwards
+class FlightRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::string pattern = ::testing::TempDir() + "flight_recorder_XXXXXX";
+        ASSERT_NE(mkdtemp(&pattern[0]), nullptr);
+        directory = pattern;
+    }
+    
+    void TearDown() override {
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+    }
+    
+    FlightRecorderOptions options(size_t records_per_chunk) const {
+        FlightRecorderOptions result;
+        result.directory = directory;
+        result.records_per_chunk = records_per_chunk;
+        result.flush_interval = std::chrono::milliseconds(1);
+        return result;
+    }
+    
+    std::vector<RobotStateSnapshot> readAll() const {
+        std::vector<RobotStateSnapshot> records;
+        for(const FlightChunkInfo& chunk : listFlightChunks(directory)) {
+            EXPECT_TRUE(readFlightChunk(chunk.path, records)) << chunk.path;
+        }
+        return records;
+    }
+    
+    std::string directory;
+};
+
+RobotStateSnapshot makeRecord(uint64_t cycle) {
+    RobotStateSnapshot record{};
+    record.cycle = cycle;
+    record.timestamp_ns = 1000000000ull + cycle * 1000000ull;
+    record.joint_count = 6;
+    record.force_count = 3;
+    record.procedure_phase = ProcedurePhase::Dissection;
+    record.emergency_stop = cycle % 50 == 49;
+    record.robot_state = record.emergency_stop ? RobotState::EmergencyStop : RobotState::Operational;
+    for(int joint = 0; joint < 6; ++joint) {
+        record.joint_positions[joint] = 0.1 * joint + 0.0001 * static_cast<double>(cycle);
+        record.joint_velocities[joint] = joint % 2 ? 0.0 : -0.25;
+    }
+    for(int channel = 0; channel < 3; ++channel) record.force_readings[channel] = 2.0 + std::sin(0.01 * cycle + channel);
+    record.collision_risk = 0.05;
+    record.procedure_duration = 0.001 * static_cast<double>(cycle);
+    record.safety_score = 97.5;
+    return record;
+}
+
+void expectSameRecord(const RobotStateSnapshot& actual, const RobotStateSnapshot& expected) {
+    EXPECT_EQ(actual.cycle, expected.cycle);
+    EXPECT_EQ(actual.timestamp_ns, expected.timestamp_ns);
+    EXPECT_EQ(actual.joint_count, expected.joint_count);
+    EXPECT_EQ(actual.force_count, expected.force_count);
+    EXPECT_EQ(actual.robot_state, expected.robot_state);
+    EXPECT_EQ(actual.procedure_phase, expected.procedure_phase);
+    EXPECT_EQ(actual.emergency_stop, expected.emergency_stop);
+    for(size_t i = 0; i < RobotStateSnapshot::MAX_JOINTS; ++i) {
+        EXPECT_EQ(actual.joint_positions[i], expected.joint_positions[i]);
+        EXPECT_EQ(actual.joint_velocities[i], expected.joint_velocities[i]);
+    }
+    for(size_t i = 0; i < RobotStateSnapshot::MAX_FORCE_CHANNELS; ++i) {
+        EXPECT_EQ(actual.force_readings[i], expected.force_readings[i]);
+    }
+    EXPECT_EQ(actual.collision_risk, expected.collision_risk);
+    EXPECT_EQ(actual.procedure_duration, expected.procedure_duration);
+    EXPECT_EQ(actual.safety_score, expected.safety_score);
+}
+
+// Appends like a control loop, giving the background thread time to map the next chunk
+void appendPaced(FlightRecorder& recorder, uint64_t first, uint64_t count) {
+    for(uint64_t cycle = first; cycle < first + count; ++cycle) {
+        ASSERT_TRUE(recorder.append(makeRecord(cycle))) << cycle;
+        if(cycle % 16 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+} // namespace
+
+TEST_F(FlightRecorderTest, SealedChunksRoundTrip) {
+    FlightRecorder recorder(options(64));
+    ASSERT_TRUE(recorder.open());
+    appendPaced(recorder, 1, 200);
+    recorder.close();
+    
+    std::vector<FlightChunkInfo> chunks = listFlightChunks(directory);
+    ASSERT_EQ(chunks.size(), 4u);
+    for(const FlightChunkInfo& chunk : chunks) {
+        EXPECT_TRUE(chunk.sealed);
+        EXPECT_EQ(chunk.session_id, recorder.getSessionId());
+    }
+    EXPECT_EQ(chunks.back().record_count, 8u);
+    
+    std::vector<RobotStateSnapshot> records = readAll();
+    ASSERT_EQ(records.size(), 200u);
+    for(uint64_t i = 0; i < records.size(); ++i) expectSameRecord(records[i], makeRecord(i + 1));
+    
+    FlightRecorderStats stats = recorder.getStats();
+    EXPECT_EQ(stats.recorded, 200u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.chunks_sealed, 4u);
+    EXPECT_EQ(stats.raw_bytes_sealed, 200 * sizeof(RobotStateSnapshot));
+    EXPECT_LT(stats.sealed_bytes * 2, stats.raw_bytes_sealed);
+}
+
+TEST_F(FlightRecorderTest, RejectsRecordCountTheFileCannotHold) {
+    FlightRecorder recorder(options(64));
+    ASSERT_TRUE(recorder.open());
+    appendPaced(recorder, 1, 64);
+    recorder.close();
+    
+    std::vector<FlightChunkInfo> chunks = listFlightChunks(directory);
+    ASSERT_EQ(chunks.size(), 1u);
+    {
+        // record_count sits after magic, version, sizes, index, session and time
+        std::fstream file(chunks[0].path, std::ios::in | std::ios::out | std::ios::binary);
+        uint64_t damaged = uint64_t(1) << 60;
+        file.seekp(40);
+        file.write(reinterpret_cast<const char*>(&damaged), sizeof(damaged));
+    }
+    std::vector<RobotStateSnapshot> records(3);
+    EXPECT_FALSE(readFlightChunk(chunks[0].path, records));
+    EXPECT_EQ(records.size(), 3u);
+}
+
+TEST_F(FlightRecorderTest, ActiveChunkIsReadableWhileRecording) {
+    FlightRecorder recorder(options(1024));
+    ASSERT_TRUE(recorder.open());
+    appendPaced(recorder, 1, 10);
+    
+    std::vector<FlightChunkInfo> chunks = listFlightChunks(directory);
+    ASSERT_FALSE(chunks.empty());
+    EXPECT_FALSE(chunks.front().sealed);
+    EXPECT_EQ(chunks.front().record_count, 10u);
+    std::vector<RobotStateSnapshot> records;
+    ASSERT_TRUE(readFlightChunk(chunks.front().path, records));
+    ASSERT_EQ(records.size(), 10u);
+    expectSameRecord(records.back(), makeRecord(10));
+}
+
+TEST_F(FlightRecorderTest, RecoversChunksOfCrashedProcess) {
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if(child == 0) {
+        // Dies without close(): the records only exist in the mapped chunk
+        FlightRecorder recorder(options(1024));
+        if(!recorder.open()) _exit(1);
+        for(uint64_t cycle = 1; cycle <= 100; ++cycle) recorder.append(makeRecord(cycle));
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    
+    FlightRecorder recorder(options(1024));
+    ASSERT_TRUE(recorder.open());
+    EXPECT_EQ(recorder.getStats().chunks_recovered, 1u);
+    recorder.close();
+    
+    std::vector<FlightChunkInfo> chunks = listFlightChunks(directory);
+    ASSERT_EQ(chunks.size(), 1u);
+    EXPECT_TRUE(chunks[0].sealed);
+    EXPECT_NE(chunks[0].session_id, recorder.getSessionId());
+    std::vector<RobotStateSnapshot> records = readAll();
+    ASSERT_EQ(records.size(), 100u);
+    expectSameRecord(records.back(), makeRecord(100));
+}
+
+TEST_F(FlightRecorderTest, DeletesChunksPastRetention) {
+    FlightRecorderOptions short_retention = options(64);
+    short_retention.retention = std::chrono::seconds(1);
+    {
+        FlightRecorder recorder(short_retention);
+        ASSERT_TRUE(recorder.open());
+        appendPaced(recorder, 1, 10);
+    }
+    ASSERT_EQ(listFlightChunks(directory).size(), 1u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    
+    FlightRecorder recorder(short_retention);
+    ASSERT_TRUE(recorder.open());
+    EXPECT_EQ(recorder.getStats().chunks_expired, 1u);
+    recorder.close();
+    EXPECT_TRUE(listFlightChunks(directory).empty());
+}
+
+TEST_F(FlightRecorderTest, DropsInsteadOfWaitingForTheNextChunk) {
+    FlightRecorderOptions slow = options(4);
+    slow.flush_interval = std::chrono::seconds(5);
+    FlightRecorder recorder(slow);
+    ASSERT_TRUE(recorder.open());
+    // Give the background thread time to reach its wait
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    
+    uint64_t accepted = 0;
+    for(uint64_t cycle = 1; cycle <= 20; ++cycle) accepted += recorder.append(makeRecord(cycle)) ? 1 : 0;
+    EXPECT_EQ(accepted, 8u);        // the chunk mapped by open() and the spare
+    EXPECT_EQ(recorder.getStats().dropped, 12u);
+    
+    recorder.close();
+    EXPECT_EQ(readAll().size(), 8u);
+}
+
+TEST_F(FlightRecorderTest, RecordsEveryControlCycle) {
+    FlightRecorder recorder(options(256));
+    ASSERT_TRUE(recorder.open());
+    RealTimeController controller;
+    controller.setControlFrequency(1000);
+    controller.attachFlightRecorder(&recorder);
+    controller.startControlLoop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    controller.stopControlLoop();
+    recorder.close();
+    
+    std::vector<RobotStateSnapshot> records = readAll();
+    ASSERT_FALSE(records.empty());
+    EXPECT_EQ(records.size() + recorder.getStats().dropped, controller.getCycleCount());
+    for(size_t i = 1; i < records.size(); ++i) {
+        EXPECT_GT(records[i].cycle, records[i - 1].cycle);
+        EXPECT_GE(records[i].timestamp_ns, records[i - 1].timestamp_ns);
+    }
+}
+
+TEST(FlightRecorderOptionsTest, FollowsLoggingParameters) {
+    RobotParameters parameters = defaultRobotParameters();
+    FlightRecorderOptions options;
+    EXPECT_TRUE(flightRecorderOptions(parameters, options));
+    EXPECT_EQ(options.directory, "recordings");
+    EXPECT_EQ(options.records_per_chunk, 65536u);
+    EXPECT_EQ(options.retention, std::chrono::hours(24 * 30));
+    EXPECT_EQ(options.flush_interval, std::chrono::milliseconds(100));
+    
+    parameters.retention_period_days = 7;
+    parameters.flight_records_per_chunk = 1024;
+    parameters.flight_flush_interval_ms = 250;
+    std::strcpy(parameters.flight_recorder_directory, "/var/lib/robot/recordings");
+    parameters.record_raw_sensor_data = false;
+    EXPECT_FALSE(flightRecorderOptions(parameters, options));
+    EXPECT_EQ(options.directory, "/var/lib/robot/recordings");
+    EXPECT_EQ(options.records_per_chunk, 1024u);
+    EXPECT_EQ(options.retention, std::chrono::hours(24 * 7));
+    EXPECT_EQ(options.flush_interval, std::chrono::milliseconds(250));
+}
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../dds_integration/data_publisher.h"
+#include "../dds_integration/history_cache.h"
+#include "../dds_integration/qos_profile.h"
+
+namespace {
+
+const char* PROFILE_XML = R"(
+<dds>
+  <qos_library name="Test">
+    <qos_profile name="Volatile">
+      <datawriter_qos>
+        <durability><kind>VOLATILE_DURABILITY_QOS</kind></durability>
+        <history><kind>KEEP_LAST_HISTORY_QOS</kind><depth>16</depth></history>
+        <deadline><period><sec>1</sec><nanosec>500000000</nanosec></period></deadline>
+      </datawriter_qos>
+    </qos_profile>
+    <qos_profile name="KeepAll">
+      <datawriter_qos>
+        <history><kind>KEEP_ALL_HISTORY_QOS</kind></history>
+        <deadline><period><sec>DURATION_INFINITE_SEC</sec></period></deadline>
+      </datawriter_qos>
+    </qos_profile>
+    <qos_profile name="Broken">
+      <datawriter_qos>
+        <history><depth>many</depth></history>
+      </datawriter_qos>
+    </qos_profile>
+  </qos_library>
+</dds>
+)";
+
+// Collects every delivered sample and the batch sizes
+struct Collector {
+    std::mutex mutex;
+    std::vector<int> samples;
+    std::vector<size_t> batches;
+    
+    DataTopic<int>::Listener listener() {
+        return [this](const int* values, size_t count) {
+            std::lock_guard<std::mutex> lock(mutex);
+            samples.insert(samples.end(), values, values + count);
+            batches.push_back(count);
+        };
+    }
+};
+
+QosProfile profile(size_t depth, bool transient_local, std::chrono::nanoseconds deadline = std::chrono::nanoseconds(0)) {
+    QosProfile qos;
+    qos.history_depth = depth;
+    qos.transient_local = transient_local;
+    qos.deadline = deadline;
+    return qos;
+}
+
+} // namespace
+
+TEST(HistoryCacheTest, KeepsTheNewestSamples) {
+    HistoryCache<int> cache(4);
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.lastSequence(), 0u);
+    for(int i = 1; i <= 10; ++i) EXPECT_EQ(cache.insert(i * 10), static_cast<uint64_t>(i));
+    
+    EXPECT_EQ(cache.size(), 4u);
+    EXPECT_EQ(cache.firstSequence(), 7u);
+    std::vector<int> out;
+    EXPECT_EQ(cache.copySince(0, out), 4u);
+    EXPECT_EQ(out, (std::vector<int>{70, 80, 90, 100}));
+    out.clear();
+    EXPECT_EQ(cache.copySince(8, out), 2u);
+    EXPECT_EQ(out, (std::vector<int>{90, 100}));
+}
+
+TEST(QosProfileTest, ReadsRepositoryProfile) {
+    QosProfile qos = profile(1, false);
+    ASSERT_TRUE(loadQosProfile(CONFIG_DIR "/dds_config.xml", "RealTimeDataQoS", qos));
+    EXPECT_EQ(qos.history_depth, 1000u);
+    EXPECT_TRUE(qos.transient_local);
+    EXPECT_EQ(qos.deadline, std::chrono::milliseconds(100));
+}
+
+TEST(QosProfileTest, ParsesProfileVariants) {
+    QosProfile qos;
+    ASSERT_TRUE(parseQosProfile(PROFILE_XML, "Volatile", qos));
+    EXPECT_EQ(qos.history_depth, 16u);
+    EXPECT_FALSE(qos.transient_local);
+    EXPECT_EQ(qos.deadline, std::chrono::milliseconds(1500));
+    
+    // KEEP_ALL keeps the previous depth; an infinite deadline disables it
+    ASSERT_TRUE(parseQosProfile(PROFILE_XML, "KeepAll", qos));
+    EXPECT_EQ(qos.history_depth, 16u);
+    EXPECT_EQ(qos.deadline.count(), 0);
+    
+    EXPECT_FALSE(parseQosProfile(PROFILE_XML, "Broken", qos));
+    EXPECT_FALSE(parseQosProfile(PROFILE_XML, "Missing", qos));
+    EXPECT_EQ(qos.history_depth, 16u);
+}
+
+TEST(DataTopicTest, LateJoinerGetsHistoryInOneBatch) {
+    DataTopic<int> topic(profile(5, true));
+    for(int i = 1; i <= 8; ++i) topic.publish(i);
+    
+    Collector collector;
+    topic.attachReader(collector.listener());
+    ASSERT_TRUE(topic.waitForDelivery(std::chrono::seconds(2)));
+    EXPECT_EQ(collector.samples, (std::vector<int>{4, 5, 6, 7, 8}));
+    EXPECT_EQ(collector.batches, (std::vector<size_t>{5}));
+    
+    topic.publish(9);
+    ASSERT_TRUE(topic.waitForDelivery(std::chrono::seconds(2)));
+    EXPECT_EQ(collector.samples.back(), 9);
+}
+
+TEST(DataTopicTest, VolatileReaderStartsWithNewSamples) {
+    DataTopic<int> topic(profile(5, false));
+    for(int i = 1; i <= 3; ++i) topic.publish(i);
+    
+    Collector collector;
+    topic.attachReader(collector.listener());
+    topic.publish(4);
+    ASSERT_TRUE(topic.waitForDelivery(std::chrono::seconds(2)));
+    EXPECT_EQ(collector.samples, (std::vector<int>{4}));
+}
+
+TEST(DataTopicTest, CoalescesSamplesForBusyReaders) {
+    constexpr int SAMPLES = 200;
+    DataTopic<int> topic(profile(1000, true));
+    std::atomic<bool> first_call{true};
+    Collector collector;
+    auto collect = collector.listener();
+    topic.attachReader([&](const int* values, size_t count) {
+        // A slow first batch lets the rest pile up
+        if(first_call.exchange(false)) std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        collect(values, count);
+    });
+    
+    for(int i = 0; i < SAMPLES; ++i) topic.publish(i);
+    ASSERT_TRUE(topic.waitForDelivery(std::chrono::seconds(2)));
+    
+    ASSERT_EQ(collector.samples.size(), static_cast<size_t>(SAMPLES));
+    for(int i = 0; i < SAMPLES; ++i) EXPECT_EQ(collector.samples[i], i);
+    TopicStats stats = topic.getStats();
+    EXPECT_EQ(stats.samples_delivered, static_cast<uint64_t>(SAMPLES));
+    EXPECT_LT(stats.batches_delivered, static_cast<uint64_t>(SAMPLES / 4));
+    EXPECT_EQ(stats.samples_lost, 0u);
+}
+
+TEST(DataTopicTest, SlowReaderLosesOverwrittenSamples) {
+    DataTopic<int> topic(profile(10, true));
+    std::atomic<bool> blocked{true};
+    Collector collector;
+    auto collect = collector.listener();
+    topic.attachReader([&](const int* values, size_t count) {
+        while(blocked) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        collect(values, count);
+    });
+    
+    topic.publish(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));    // reader now stuck on sample 0
+    for(int i = 1; i <= 50; ++i) topic.publish(i);
+    blocked = false;
+    ASSERT_TRUE(topic.waitForDelivery(std::chrono::seconds(2)));
+    
+    EXPECT_EQ(collector.samples.back(), 50);
+    EXPECT_EQ(topic.getStats().samples_lost, 40u);
+}
+
+TEST(DataTopicTest, CountsMissedDeadlines) {
+    DataTopic<int> topic(profile(10, true, std::chrono::milliseconds(10)));
+    topic.publish(1);
+    EXPECT_FALSE(topic.isDeadlineMissed());
+    std::this_thread::sleep_for(std::chrono::milliseconds(35));
+    EXPECT_TRUE(topic.isDeadlineMissed());
+    EXPECT_GE(topic.getStats().deadline_misses, 3u);
+    
+    topic.publish(2);
+    EXPECT_FALSE(topic.isDeadlineMissed());
+    EXPECT_GE(topic.getStats().deadline_misses, 3u);
+}
+
+TEST(DataTopicTest, PublisherUsesQosFromXml) {
+    RoboticsDataPublisher publisher;
+    ASSERT_TRUE(publisher.applyQosProfile(CONFIG_DIR "/dds_config.xml"));
+    EXPECT_EQ(publisher.getQosProfile().history_depth, 1000u);
+    
+    RoboticsData data;
+    data.joint_positions = {0.5};
+    data.safety_status = "NORMAL";
+    data.collision_risk = 0.0;
+    data.emergency_stop_engaged = false;
+    data.procedure_phase = "INCISION";
+    data.procedure_duration = 0.0;
+    for(int i = 0; i < 3; ++i) {
+        data.timestamp = i;
+        publisher.publishRoboticsData(data);
+    }
+    
+    std::vector<int64_t> timestamps;
+    std::mutex mutex;
+    publisher.roboticsDataTopic().attachReader([&](const RoboticsDataSample* samples, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(size_t i = 0; i < count; ++i) timestamps.push_back(samples[i].timestamp);
+    });
+    ASSERT_TRUE(publisher.roboticsDataTopic().waitForDelivery(std::chrono::seconds(2)));
+    EXPECT_EQ(timestamps, (std::vector<int64_t>{0, 1, 2}));
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
+#include <cstdio>
 #include "../core_engine/kinematics_solver.h"
+#include "../core_engine/batch_kinematics.h"
 
 class KinematicsTest : public ::testing::Test {
 protected:
@@ -34,3 +36,211 @@ TEST_F(KinematicsTest, ReachabilityCheck) {
     EXPECT_TRUE(solver->isReachable(reachable));
     EXPECT_FALSE(solver->isReachable(unreachable));
 }
+
+namespace {
+
+// Reference chain of full 4x4 DH transforms, as the solver originally computed it
+Eigen::Vector3d referenceForwardKinematics(const std::array<double, 6>& joint_angles) {
+    Eigen::Matrix4d T = Eigen::Matrix4d::Identity();
+    for(size_t i = 0; i < joint_angles.size(); ++i) {
+        const auto& link = ETHICON_ARM_DH_PARAMETERS[i];
+        double theta = joint_angles[i] + link.theta_offset;
+        Eigen::Matrix4d Ti;
+        Ti << cos(theta), -sin(theta)*cos(link.alpha),  sin(theta)*sin(link.alpha), link.a*cos(theta),
+              sin(theta),  cos(theta)*cos(link.alpha), -cos(theta)*sin(link.alpha), link.a*sin(theta),
+              0,           sin(link.alpha),             cos(link.alpha),            link.d,
+              0,           0,                           0,                          1;
+        T = T * Ti;
+    }
+    return T.block<3,1>(0,3);
+}
+
+} // namespace
+
+TEST(FixedKinematicsTest, ForwardKinematicsMatchesDHChain) {
+    Kinematics<6> kinematics(ETHICON_ARM_DH_PARAMETERS);
+    Kinematics<6>::JointVector joint_angles = {0.3, -0.7, 1.1, 0.2, -1.4, 0.9};
+    
+    Eigen::Vector3d position = Eigen::Vector3d::Zero();
+    ASSERT_EQ(kinematics.forwardKinematics(joint_angles, position), KinematicsStatus::Ok);
+    EXPECT_TRUE(position.isApprox(referenceForwardKinematics(joint_angles), 1e-12));
+    
+    Eigen::Matrix4d pose = Eigen::Matrix4d::Zero();
+    ASSERT_EQ(kinematics.forwardPose(joint_angles, pose), KinematicsStatus::Ok);
+    Eigen::Vector3d pose_position = pose.block<3,1>(0,3);
+    EXPECT_TRUE(pose_position.isApprox(position, 1e-12));
+}
+
+TEST(FixedKinematicsTest, RejectsNonFiniteInputWithoutThrowing) {
+    Kinematics<6, float> kinematics(DHTable<6, float>{{
+        {0.0f, 1.5708f, 0.0f, 0.15f}, {0.0f, -1.5708f, 0.25f, 0.0f}, {0.0f, 1.5708f, 0.0f, 0.18f},
+        {0.0f, -1.5708f, 0.0f, 0.0f}, {0.0f, 1.5708f, 0.0f, 0.1f}, {0.0f, 0.0f, 0.0f, 0.05f}
+    }});
+    Kinematics<6, float>::JointVector joint_angles = {0.0f, NAN, 0.0f, 0.0f, 0.0f, 0.0f};
+    
+    Eigen::Vector3f position;
+    EXPECT_EQ(kinematics.forwardKinematics(joint_angles, position), KinematicsStatus::InvalidInput);
+}
+
+TEST(FixedKinematicsTest, GeometricJacobianMatchesFiniteDifferences) {
+    Kinematics<6> kinematics(ETHICON_ARM_DH_PARAMETERS);
+    Kinematics<6>::JointVector joint_angles = {0.3, -0.7, 1.1, 0.2, -1.4, 0.9};
+    
+    Kinematics<6>::Jacobian jacobian;
+    ASSERT_EQ(kinematics.calculateJacobian(joint_angles, jacobian), KinematicsStatus::Ok);
+    
+    const double h = 1e-7;
+    for(int i = 0; i < 6; ++i) {
+        auto plus = joint_angles;
+        auto minus = joint_angles;
+        plus[i] += h;
+        minus[i] -= h;
+        Eigen::Vector3d p_plus = Eigen::Vector3d::Zero();
+        Eigen::Vector3d p_minus = Eigen::Vector3d::Zero();
+        kinematics.forwardKinematics(plus, p_plus);
+        kinematics.forwardKinematics(minus, p_minus);
+        
+        Eigen::Vector3d numeric = (p_plus - p_minus) / (2 * h);
+        Eigen::Vector3d analytic = jacobian.block<3,1>(0, i);
+        EXPECT_LT((numeric - analytic).norm(), 1e-6) << "joint " << i;
+    }
+}
+
+TEST_F(KinematicsTest, InverseKinematicsWarmStartConvergesQuickly) {
+    Eigen::Vector3d target(0.3, 0.2, 0.1);
+    auto joint_angles = solver->inverseKinematics(target);
+    EXPECT_TRUE(solver->forwardKinematics(joint_angles).isApprox(target, 1e-4));
+    int cold_iterations = solver->getLastIKResult().iterations;
+    
+    // Next control cycle: target moved by 0.1 mm
+    Eigen::Vector3d next_target(0.3001, 0.2, 0.1);
+    solver->inverseKinematics(next_target);
+    const auto& result = solver->getLastIKResult();
+    EXPECT_EQ(result.status, KinematicsStatus::Ok);
+    EXPECT_LE(result.residual, 1e-5);
+    EXPECT_LE(result.iterations, 3);
+    EXPECT_LT(result.iterations, cold_iterations);
+}
+
+TEST(FixedKinematicsTest, BatchForwardKinematicsMatchesPerConfiguration) {
+    Kinematics<6> kinematics(ETHICON_ARM_DH_PARAMETERS);
+    const size_t count = 10000; // not a multiple of the tile width
+    
+    std::vector<std::vector<double>> joints(6, std::vector<double>(count));
+    for(size_t k = 0; k < count; ++k) {
+        for(int j = 0; j < 6; ++j) joints[j][k] = std::sin(0.37 * k + j) * M_PI;
+    }
+    std::vector<double> x(count), y(count), z(count);
+    
+    Kinematics<6>::ConfigurationBlock configurations;
+    for(int j = 0; j < 6; ++j) configurations.joints[j] = joints[j].data();
+    configurations.count = count;
+    parallelForwardKinematics(kinematics, configurations, Kinematics<6>::PositionBlock{x.data(), y.data(), z.data()}, 2);
+    
+    for(size_t k : {size_t(0), size_t(63), size_t(64), size_t(4097), size_t(5000), count - 1}) {
+        Kinematics<6>::JointVector joint_angles;
+        for(int j = 0; j < 6; ++j) joint_angles[j] = joints[j][k];
+        Eigen::Vector3d expected = Eigen::Vector3d::Zero();
+        kinematics.forwardKinematics(joint_angles, expected);
+        EXPECT_NEAR(x[k], expected[0], 1e-12);
+        EXPECT_NEAR(y[k], expected[1], 1e-12);
+        EXPECT_NEAR(z[k], expected[2], 1e-12);
+    }
+}
+
+TEST_F(KinematicsTest, ReachabilityMapAnswersWithoutIK) {
+    ReachabilityMapOptions options;
+    options.voxel_size = 0.04;
+    options.samples = 200000;
+    solver->buildReachabilityMap(options);
+    
+    Eigen::Vector3d reachable(0.3, 0.2, 0.1);
+    Eigen::Vector3d unreachable(10.0, 10.0, 10.0);
+    EXPECT_TRUE(solver->isReachable(reachable));
+    EXPECT_FALSE(solver->isReachable(unreachable));
+    EXPECT_GT(solver->estimateManipulability(reachable), 0.0f);
+    EXPECT_EQ(solver->estimateManipulability(unreachable), 0.0f);
+    
+    solver->setExactReachabilityRefinement(true);
+    EXPECT_TRUE(solver->isReachable(reachable));
+    EXPECT_EQ(solver->getLastIKResult().status, KinematicsStatus::Ok);
+    
+    std::string path = ::testing::TempDir() + "reachability_map_test.bin";
+    ASSERT_TRUE(solver->saveReachabilityMap(path));
+    RoboticsKinematics reloaded;
+    ASSERT_TRUE(reloaded.loadReachabilityMap(path));
+    EXPECT_EQ(reloaded.estimateManipulability(reachable), solver->estimateManipulability(reachable));
+    std::remove(path.c_str());
+}
+
+TEST_F(KinematicsTest, ReachabilityMapIsConservativeAtTheBoundary) {
+    Kinematics<6> kinematics(ETHICON_ARM_DH_PARAMETERS);
+    ReachabilityMapOptions options;
+    options.voxel_size = 0.04;
+    options.samples = 200000;
+    ReachabilityMap map;
+    map.build(kinematics, options);
+    
+    // Walk out along +x from the base: interior, then the eroded boundary, then nothing
+    Eigen::Vector3d boundary_point = Eigen::Vector3d::Zero();
+    VoxelReach previous = VoxelReach::Interior;
+    bool found_boundary = false;
+    for(double x = 0.1; x < kinematics.maxReach() + 0.1; x += options.voxel_size / 4) {
+        Eigen::Vector3d point(x, 0.0, 0.1);
+        VoxelReach reach = map.classify(point);
+        if(reach == VoxelReach::Boundary && !found_boundary) {
+            boundary_point = point;
+            found_boundary = true;
+        }
+        if(previous == VoxelReach::Unreachable) {
+            EXPECT_NE(reach, VoxelReach::Interior) << x;
+        }
+        if(reach == VoxelReach::Interior) {
+            EXPECT_GT(map.manipulability(point), 0.0f) << x;
+        }
+        previous = reach;
+    }
+    ASSERT_TRUE(found_boundary);
+    EXPECT_FALSE(map.isReachable(boundary_point));
+    EXPECT_EQ(map.manipulability(boundary_point), 0.0f);
+    
+    // Boundary voxels always get the exact IK check
+    solver->buildReachabilityMap(options);
+    EXPECT_EQ(solver->getLastIKResult().elapsed.count(), 0);
+    solver->isReachable(boundary_point);
+    EXPECT_GT(solver->getLastIKResult().elapsed.count(), 0);
+}
+
+TEST_F(KinematicsTest, ReachabilityMapRejectsDamagedCache) {
+    ReachabilityMapOptions options;
+    options.voxel_size = 0.1;
+    options.samples = 5000;
+    solver->buildReachabilityMap(options);
+    std::string path = ::testing::TempDir() + "reachability_map_damaged.bin";
+    ASSERT_TRUE(solver->saveReachabilityMap(path));
+    
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    uint32_t huge = 0x7fffffff;
+    std::fseek(file, 8, SEEK_SET);              // signature size, after magic and version
+    std::fwrite(&huge, sizeof(huge), 1, file);
+    std::fclose(file);
+    
+    RoboticsKinematics reloaded;
+    EXPECT_FALSE(reloaded.loadReachabilityMap(path));
+    std::remove(path.c_str());
+}
+
+TEST(FixedKinematicsTest, JointPositionsEndAtForwardKinematics) {
+    Kinematics<6> kinematics(ETHICON_ARM_DH_PARAMETERS);
+    Kinematics<6>::JointVector joint_angles = {0.3, -0.7, 1.1, 0.2, -1.4, 0.9};
+    
+    std::array<Eigen::Vector3d, 7> positions;
+    ASSERT_EQ(kinematics.jointPositions(joint_angles, positions), KinematicsStatus::Ok);
+    Eigen::Vector3d end_effector = Eigen::Vector3d::Zero();
+    kinematics.forwardKinematics(joint_angles, end_effector);
+    
+    EXPECT_TRUE(positions[0].isZero());
+    EXPECT_TRUE(positions[6].isApprox(end_effector, 1e-12));
+    EXPECT_NEAR(positions[1].z(), 0.15, 1e-12); // d1 along the base z axis
+}
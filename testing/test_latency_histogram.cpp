@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../core_engine/latency_histogram.h"
+#include "../core_engine/real_time_controller.h"
+
+TEST(LatencyHistogramTest, BucketsCoverValuesContiguously) {
+    size_t previous = 0;
+    for(uint64_t value = 1; value < (1u << 20); value += 1 + value / 100) {
+        size_t index = LatencyHistogram::bucketIndex(value);
+        EXPECT_GE(index, previous);
+        EXPECT_GE(LatencyHistogram::bucketUpperBound(index), value);
+        if(index > 0) {
+            EXPECT_LT(LatencyHistogram::bucketUpperBound(index - 1), value);
+        }
+        previous = index;
+    }
+    EXPECT_EQ(LatencyHistogram::bucketIndex(LatencyHistogram::MAX_TRACKABLE_NS), LatencyHistogram::BUCKET_COUNT - 1);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinRelativePrecision) {
+    LatencyHistogram histogram(50000);
+    std::mt19937 rng(9);
+    std::lognormal_distribution<double> latency(9.0, 1.0);   // median ~8 us
+    std::vector<uint64_t> values(100000);
+    for(auto& value : values) {
+        value = static_cast<uint64_t>(latency(rng));
+        histogram.record(value);
+    }
+    std::sort(values.begin(), values.end());
+    
+    LatencySnapshot snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, values.size());
+    EXPECT_EQ(snapshot.max_ns, values.back());
+    for(double quantile : {0.5, 0.99, 0.999}) {
+        double exact = static_cast<double>(values[static_cast<size_t>(quantile * values.size()) - 1]);
+        EXPECT_NEAR(static_cast<double>(snapshot.percentile(quantile)), exact, exact * 0.035) << quantile;
+    }
+    uint64_t above = static_cast<uint64_t>(values.end() - std::upper_bound(values.begin(), values.end(), 50000u));
+    EXPECT_EQ(snapshot.overruns, above);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordersLoseNothing) {
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram, t]() {
+            for(uint64_t i = 0; i < 50000; ++i) histogram.record(1000 * (t + 1) + i % 7);
+        });
+    }
+    for(auto& thread : threads) thread.join();
+    
+    LatencySnapshot snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 200000u);
+    EXPECT_EQ(snapshot.max_ns, 4006u);
+    
+    histogram.reset();
+    EXPECT_EQ(histogram.snapshot().count, 0u);
+    EXPECT_EQ(histogram.snapshot().percentile(0.5), 0u);
+}
+
+TEST(LatencyHistogramTest, PrometheusExportGroupsFamilies) {
+    LatencyHistogram fast;
+    LatencyHistogram slow(1000000);
+    for(int i = 0; i < 10; ++i) {
+        fast.record(1500);
+        slow.record(3000000);
+    }
+    
+    std::string text;
+    appendPrometheusHistograms(text, "test_latency", "stage", {{"fast", fast.snapshot()}, {"slow", slow.snapshot()}});
+    EXPECT_NE(text.find("test_latency_seconds_bucket{stage=\"fast\",le=\"2e-06\"} 10"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{stage=\"slow\",le=\"+Inf\"} 10"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_count{stage=\"slow\"} 10"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_overruns_total{stage=\"slow\"} 10"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_quantile_seconds{stage=\"fast\",quantile=\"1\"} 1.5e-06"), std::string::npos);
+    // One TYPE line per family, after which only that family's samples follow
+    EXPECT_LT(text.rfind("test_latency_seconds"), text.find("# TYPE test_latency_quantile_seconds"));
+}
+
+TEST(LatencyHistogramTest, ControllerRecordsEveryPhase) {
+    RealTimeController controller;
+    RealTimeOptions options;
+    options.enabled = true;
+    controller.setRealTimeOptions(options);
+    controller.startControlLoop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    
+    // Snapshots are safe while the loop runs
+    EXPECT_GT(controller.getPhaseLatency(ControlPhase::FullCycle).count, 0u);
+    controller.stopControlLoop();
+    
+    uint64_t cycles = controller.getCycleCount();
+    for(int phase = 0; phase < static_cast<int>(ControlPhase::Count); ++phase) {
+        EXPECT_EQ(controller.getPhaseLatency(static_cast<ControlPhase>(phase)).count, cycles)
+            << controlPhaseName(static_cast<ControlPhase>(phase));
+    }
+    std::string metrics = controller.formatMetrics();
+    EXPECT_NE(metrics.find("control_phase_latency_seconds_count{phase=\"safety_checks\"}"), std::string::npos);
+    EXPECT_NE(metrics.find("control_cycles_total " + std::to_string(cycles)), std::string::npos);
+}
@@ -0,0 +1,388 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../core_engine/parameter_store.h"
+
+namespace {
+
+const std::string SAFETY_JSON = std::string(CONFIG_DIR) + "/safety_parameters.json";
+const std::string ROBOT_YAML = std::string(CONFIG_DIR) + "/robot_config.yaml";
+
+void writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::trunc);
+    file << contents;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+RobotParameters withMaxForce(RobotParameters parameters, double newtons) {
+    std::fill(parameters.max_force_newtons, parameters.max_force_newtons + RobotParameters::MAX_FORCE_CHANNELS, newtons);
+    parameters.force_warning_newtons = std::min(parameters.force_warning_newtons, newtons);
+    return parameters;
+}
+
+} // namespace
+
+TEST(RobotParametersTest, ShippedConfigMatchesDefaults) {
+    RobotParameters loaded{};
+    loaded.joint_count = 1;
+    ASSERT_TRUE(loadRobotParameters(SAFETY_JSON, ROBOT_YAML, loaded));
+    const RobotParameters& defaults = defaultRobotParameters();
+
+    EXPECT_EQ(loaded.joint_count, 6u);
+    EXPECT_EQ(loaded.force_channel_count, 3u);
+    for(size_t joint = 0; joint < loaded.joint_count; ++joint) {
+        EXPECT_DOUBLE_EQ(loaded.joint_min_degrees[joint], defaults.joint_min_degrees[joint]);
+        EXPECT_DOUBLE_EQ(loaded.joint_max_degrees[joint], defaults.joint_max_degrees[joint]);
+    }
+    EXPECT_DOUBLE_EQ(loaded.joint_max_degrees[1], 90.0);
+    EXPECT_DOUBLE_EQ(loaded.max_force_newtons[2], 15.0);
+    EXPECT_DOUBLE_EQ(loaded.max_velocity_mm_per_sec[0], 50.0);
+    EXPECT_DOUBLE_EQ(loaded.rapid_force_change_newtons, defaults.rapid_force_change_newtons);
+    EXPECT_DOUBLE_EQ(loaded.min_safe_distance_mm, 2.0);
+    EXPECT_DOUBLE_EQ(loaded.warning_distance_mm, 5.0);
+    EXPECT_DOUBLE_EQ(loaded.critical_distance_mm, 1.0);
+    EXPECT_EQ(loaded.stop_delay_ms, 50u);
+    EXPECT_EQ(loaded.retention_period_days, 30u);
+    EXPECT_TRUE(loaded.record_raw_sensor_data);
+    EXPECT_STREQ(loaded.flight_recorder_directory, "recordings");
+    EXPECT_EQ(loaded.flight_records_per_chunk, 65536u);
+    EXPECT_EQ(loaded.flight_flush_interval_ms, 100u);
+    for(size_t joint = 0; joint < RobotParameters::DOF; ++joint) {
+        // The YAML gives pi/2 to four decimals
+        EXPECT_NEAR(loaded.dh_parameters[joint].alpha, defaults.dh_parameters[joint].alpha, 1e-4);
+        EXPECT_DOUBLE_EQ(loaded.dh_parameters[joint].a, defaults.dh_parameters[joint].a);
+        EXPECT_DOUBLE_EQ(loaded.dh_parameters[joint].d, defaults.dh_parameters[joint].d);
+    }
+}
+
+TEST(RobotParametersTest, AbsentSettingsKeepCurrentValues) {
+    RobotParameters parameters = withMaxForce(defaultRobotParameters(), 12.0);
+    ASSERT_TRUE(parseRobotParameters("{}", "robot_configuration:\n  version: \"2.1.0\"\n", parameters));
+    EXPECT_DOUBLE_EQ(parameters.max_force_newtons[0], 12.0);
+    EXPECT_DOUBLE_EQ(parameters.joint_max_degrees[3], 150.0);
+
+    ASSERT_TRUE(parseRobotParameters(
+        "{\"safety_parameters\": {\"collision_detection\": {\"warning_distance_mm\": 8}}}",
+        "robot_configuration:\n  sensors:\n    force_sensors:\n      count: 2  # two jaws\n", parameters));
+    EXPECT_DOUBLE_EQ(parameters.warning_distance_mm, 8.0);
+    EXPECT_DOUBLE_EQ(parameters.min_safe_distance_mm, 2.0);
+    EXPECT_EQ(parameters.force_channel_count, 2u);
+}
+
+TEST(RobotParametersTest, EnvelopeBoundsUnlistedJoints) {
+    RobotParameters parameters = defaultRobotParameters();
+    ASSERT_TRUE(parseRobotParameters(
+        "{\"safety_parameters\": {\"position_limits\": {\"min_joint_angle_degrees\": -100,"
+        " \"max_joint_angle_degrees\": 100, \"joint_limits_degrees\": [[-50, 50]]}}}",
+        "", parameters));
+    EXPECT_DOUBLE_EQ(parameters.joint_min_degrees[0], -50.0);
+    EXPECT_DOUBLE_EQ(parameters.joint_max_degrees[0], 50.0);
+    for(size_t joint = 1; joint < parameters.joint_count; ++joint) {
+        EXPECT_DOUBLE_EQ(parameters.joint_min_degrees[joint], -100.0);
+        EXPECT_DOUBLE_EQ(parameters.joint_max_degrees[joint], 100.0);
+    }
+}
+
+TEST(RobotParametersTest, RejectsInvalidDocumentsWithoutChanges) {
+    const RobotParameters before = withMaxForce(defaultRobotParameters(), 14.0);
+    const std::string robot = readFile(ROBOT_YAML);
+    const char* invalid_json[] = {
+        "{\"safety_parameters\": {\"force_limits\": {\"max_force_newtons\": 15.0,}}}",
+        "{\"safety_parameters\": {\"force_limits\": {\"max_force_newtons\": \"strong\"}}}",
+        "{\"safety_parameters\": {\"force_limits\": {\"max_force_newtons\": -1}}}",
+        "{\"safety_parameters\": {\"force_limits\": {\"warning_threshold\": 20}}}",
+        "{\"safety_parameters\": {\"collision_detection\": {\"critical_distance_mm\": 3}}}",
+        "{\"safety_parameters\": {\"position_limits\": {\"joint_limits_degrees\": [[-190, 10]]}}}",
+        "{\"safety_parameters\": {\"position_limits\": {\"joint_limits_degrees\": [[10, -10]]}}}",
+    };
+    for(const char* json : invalid_json) {
+        RobotParameters parameters;
+        std::memcpy(&parameters, &before, sizeof(before));
+        EXPECT_FALSE(parseRobotParameters(json, robot, parameters)) << json;
+        EXPECT_EQ(std::memcmp(&parameters, &before, sizeof(before)), 0) << json;
+    }
+
+    const char* invalid_yaml[] = {
+        "robot_configuration:\n  kinematics:\n    dh_parameters:\n      joint_1: [0.0, 1.5708, 0.0]\n",
+        "robot_configuration:\n  kinematics:\n    dh_parameters:\n      joint_7: [0.0, 0.0, 0.0, 0.1]\n",
+        "robot_configuration:\n  sensors:\n    position_sensors:\n      count: 9\n",
+        "robot_configuration:\n  sensors:\n    - force\n",
+        "robot_configuration:\n  logging:\n    flight_recorder:\n      records_per_chunk: 0\n",
+        "robot_configuration:\n  logging:\n    raw_sensor_data: sometimes\n",
+    };
+    for(const char* yaml : invalid_yaml) {
+        RobotParameters parameters;
+        std::memcpy(&parameters, &before, sizeof(before));
+        EXPECT_FALSE(parseRobotParameters("{}", yaml, parameters)) << yaml;
+        EXPECT_EQ(std::memcmp(&parameters, &before, sizeof(before)), 0) << yaml;
+    }
+    // Longer than the block's fixed directory buffer
+    const std::string long_directory = "robot_configuration:\n  logging:\n    flight_recorder:\n      directory: " +
+                                       std::string(RobotParameters::MAX_PATH_LENGTH, 'd') + "\n";
+    RobotParameters parameters;
+    std::memcpy(&parameters, &before, sizeof(before));
+    EXPECT_FALSE(parseRobotParameters("{}", long_directory, parameters));
+    EXPECT_EQ(std::memcmp(&parameters, &before, sizeof(before)), 0);
+}
+
+TEST(ParameterStoreTest, ReclaimsReplacedBlockAfterQuiescentState) {
+    ParameterStore store;
+    ParameterReader reader(store);
+    ASSERT_TRUE(reader.isAttached());
+    const RobotParameters* first = &reader.get();
+    EXPECT_EQ(first->version, 1u);
+
+    EXPECT_EQ(store.publish(withMaxForce(store.snapshot(), 10.0)), 2u);
+    // Visible at once, but the reader may still be using the first block
+    EXPECT_EQ(reader.get().version, 2u);
+    EXPECT_DOUBLE_EQ(reader.get().max_force_newtons[0], 10.0);
+    EXPECT_DOUBLE_EQ(first->max_force_newtons[0], 15.0);
+    EXPECT_EQ(store.getRetiredCount(), 1u);
+
+    reader.quiescent();
+    store.reclaim();
+    EXPECT_EQ(store.getRetiredCount(), 0u);
+    EXPECT_EQ(store.getVersion(), 2u);
+}
+
+TEST(ParameterStoreTest, DetachedReadersDoNotHoldBlocks) {
+    ParameterStore store;
+    {
+        ParameterReader idle(store);
+        store.publish(withMaxForce(store.snapshot(), 10.0));
+        store.publish(withMaxForce(store.snapshot(), 11.0));
+        EXPECT_EQ(store.getRetiredCount(), 2u);
+    }
+    EXPECT_EQ(store.getRetiredCount(), 0u);
+
+    ParameterReader late(store);
+    EXPECT_DOUBLE_EQ(late.get().max_force_newtons[0], 11.0);
+    store.publish(withMaxForce(store.snapshot(), 12.0));
+    EXPECT_EQ(store.getRetiredCount(), 1u);
+}
+
+TEST(ParameterStoreTest, RunsOutOfReaderSlots) {
+    ParameterStore store;
+    std::vector<std::unique_ptr<ParameterReader>> readers;
+    for(size_t i = 0; i < ParameterStore::MAX_READERS; ++i) {
+        readers.push_back(std::make_unique<ParameterReader>(store));
+        EXPECT_TRUE(readers.back()->isAttached());
+    }
+    ParameterReader extra;
+    EXPECT_FALSE(extra.attach(store));
+    readers.pop_back();
+    EXPECT_TRUE(extra.attach(store));
+}
+
+TEST(ParameterStoreTest, PinHoldsBlockOnlyWhileAlive) {
+    ParameterStore store(withMaxForce(defaultRobotParameters(), 15.0));
+    const RobotParameters fallback = withMaxForce(defaultRobotParameters(), 3.0);
+    EXPECT_EQ(ParameterPin(nullptr, fallback).get().max_force_newtons[0], 3.0);
+    {
+        ParameterPin pin(&store, fallback);
+        EXPECT_EQ(pin.get().version, 1u);
+        store.publish(withMaxForce(store.snapshot(), 12.0));
+        store.reclaim();
+        EXPECT_EQ(store.getRetiredCount(), 1u);
+        EXPECT_EQ(pin.get().max_force_newtons[0], 15.0);
+    }
+    store.reclaim();
+    EXPECT_EQ(store.getRetiredCount(), 0u);
+    
+    // Pins give their slot back, so readers can still attach them all
+    std::vector<std::unique_ptr<ParameterReader>> readers;
+    for(size_t i = 0; i < ParameterStore::MAX_READERS; ++i) {
+        readers.push_back(std::make_unique<ParameterReader>(store));
+        EXPECT_TRUE(readers.back()->isAttached());
+    }
+}
+
+TEST(ParameterStoreTest, PinCopiesBlockWhenEverySlotIsTaken) {
+    ParameterStore store(withMaxForce(defaultRobotParameters(), 15.0));
+    store.publish(withMaxForce(store.snapshot(), 12.0));
+    std::vector<std::unique_ptr<ParameterReader>> readers;
+    for(size_t i = 0; i < ParameterStore::MAX_READERS; ++i) {
+        readers.push_back(std::make_unique<ParameterReader>(store));
+        ASSERT_TRUE(readers.back()->isAttached());
+    }
+    
+    const RobotParameters fallback = withMaxForce(defaultRobotParameters(), 3.0);
+    {
+        ParameterPin pin(&store, fallback);
+        EXPECT_EQ(pin.get().version, 2u);
+        EXPECT_EQ(pin.get().max_force_newtons[0], 12.0);
+        // The copy does not hold back reclamation
+        store.publish(withMaxForce(store.snapshot(), 9.0));
+        for(auto& reader : readers) reader->quiescent();
+        store.reclaim();
+        EXPECT_EQ(store.getRetiredCount(), 0u);
+        EXPECT_EQ(pin.get().max_force_newtons[0], 12.0);
+    }
+    
+    readers.pop_back();
+    ParameterPin pin(&store, fallback);
+    EXPECT_EQ(pin.get().max_force_newtons[0], 9.0);
+}
+
+TEST(ParameterStoreTest, PinnedReadsNeverSeeTornOrFreedBlock) {
+    ParameterStore store(withMaxForce(defaultRobotParameters(), 15.0));
+    const RobotParameters fallback = defaultRobotParameters();
+    std::atomic<bool> done{false};
+    std::atomic<size_t> torn{0};
+    std::atomic<size_t> reads{0};
+    
+    auto pinning_reader = [&]() {
+        while(!done.load(std::memory_order_acquire)) {
+            ParameterPin pin(&store, fallback);
+            const RobotParameters& block = pin.get();
+            double expected = block.version == 1 ? 15.0 : static_cast<double>(block.version);
+            for(size_t c = 0; c < RobotParameters::MAX_FORCE_CHANNELS; ++c) {
+                if(block.max_force_newtons[c] != expected) torn.fetch_add(1, std::memory_order_relaxed);
+            }
+            reads.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+    std::thread first(pinning_reader);
+    std::thread second(pinning_reader);
+    
+    for(uint64_t version = 2; version <= 2000; ++version) {
+        store.publish(withMaxForce(defaultRobotParameters(), static_cast<double>(version)));
+        if(version % 100 == 0) std::this_thread::yield();
+    }
+    while(reads.load() < 1000) std::this_thread::yield();
+    done.store(true, std::memory_order_release);
+    first.join();
+    second.join();
+    
+    EXPECT_EQ(torn.load(), 0u);
+    store.reclaim();
+    EXPECT_EQ(store.getRetiredCount(), 0u);
+}
+
+TEST(ParameterStoreTest, ReaderNeverSeesTornOrFreedBlock) {
+    ParameterStore store;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> torn{0};
+
+    std::thread reader_thread([&]() {
+        ParameterReader reader(store);
+        uint64_t last_version = 0;
+        while(!done.load(std::memory_order_acquire)) {
+            const RobotParameters& block = reader.get();
+            // Every publish below writes the version into all force limits
+            double expected = block.version == 1 ? 15.0 : static_cast<double>(block.version);
+            for(size_t c = 0; c < RobotParameters::MAX_FORCE_CHANNELS; ++c) {
+                if(block.max_force_newtons[c] != expected) torn.fetch_add(1, std::memory_order_relaxed);
+            }
+            if(block.version < last_version) torn.fetch_add(1, std::memory_order_relaxed);
+            last_version = block.version;
+            reads.fetch_add(1, std::memory_order_relaxed);
+            reader.quiescent();
+        }
+    });
+
+    for(uint64_t version = 2; version <= 2000; ++version) {
+        RobotParameters next = withMaxForce(defaultRobotParameters(), static_cast<double>(version));
+        EXPECT_EQ(store.publish(next), version);
+        if(version % 100 == 0) std::this_thread::yield();
+    }
+    while(reads.load() < 1000) std::this_thread::yield();
+    done.store(true, std::memory_order_release);
+    reader_thread.join();
+
+    EXPECT_EQ(torn.load(), 0u);
+    store.reclaim();
+    EXPECT_EQ(store.getRetiredCount(), 0u);
+}
+
+class ParameterReloadTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::string pattern = ::testing::TempDir() + "parameter_store_XXXXXX";
+        ASSERT_NE(mkdtemp(&pattern[0]), nullptr);
+        directory = pattern;
+        safety_json = directory + "/safety_parameters.json";
+        robot_yaml = directory + "/robot_config.yaml";
+        shipped_json = readFile(SAFETY_JSON);
+        writeFile(safety_json, shipped_json);
+        writeFile(robot_yaml, readFile(ROBOT_YAML));
+    }
+
+    void TearDown() override {
+        std::error_code error;
+        std::filesystem::remove_all(directory, error);
+    }
+
+    // Rewrites the force limit and moves the timestamp on, whatever the filesystem's mtime resolution
+    void editMaxForce(const std::string& value) {
+        std::string edited = shipped_json;
+        edited.replace(edited.find("15.0"), 4, value);
+        auto stamp = std::filesystem::last_write_time(safety_json);
+        writeFile(safety_json, edited);
+        std::filesystem::last_write_time(safety_json, stamp + std::chrono::seconds(++edits));
+    }
+
+    std::string directory;
+    std::string safety_json;
+    std::string robot_yaml;
+    std::string shipped_json;
+    int edits = 0;
+};
+
+TEST_F(ParameterReloadTest, ReloadsOnlyChangedValidFiles) {
+    ParameterStore store;
+    ASSERT_TRUE(store.reload(safety_json, robot_yaml));
+    EXPECT_EQ(store.getVersion(), 2u);
+    EXPECT_FALSE(store.reloadIfChanged());
+
+    editMaxForce("13.0");
+    EXPECT_TRUE(store.reloadIfChanged());
+    EXPECT_EQ(store.getVersion(), 3u);
+    EXPECT_DOUBLE_EQ(store.snapshot().max_force_newtons[0], 13.0);
+
+    editMaxForce("-13.0");
+    EXPECT_FALSE(store.reloadIfChanged());
+    EXPECT_EQ(store.getVersion(), 3u);
+    EXPECT_DOUBLE_EQ(store.snapshot().max_force_newtons[0], 13.0);
+    // A rejected file is not parsed again until it changes
+    EXPECT_FALSE(store.reloadIfChanged());
+}
+
+TEST_F(ParameterReloadTest, WatcherPublishesEditsToReaders) {
+    ParameterStore store;
+    EXPECT_FALSE(store.startWatching(std::chrono::milliseconds(5)));
+    ASSERT_TRUE(store.reload(safety_json, robot_yaml));
+    ASSERT_TRUE(store.startWatching(std::chrono::milliseconds(5)));
+
+    ParameterReader reader(store);
+    editMaxForce("11.0");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(reader.get().max_force_newtons[0] != 11.0 && std::chrono::steady_clock::now() < deadline) {
+        reader.quiescent();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_DOUBLE_EQ(reader.get().max_force_newtons[0], 11.0);
+    reader.quiescent();
+
+    // The watcher also frees what the reader has moved past
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(store.getRetiredCount() != 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(store.getRetiredCount(), 0u);
+    store.stopWatching();
+}
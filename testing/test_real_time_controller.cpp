@@ -0,0 +1,264 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "../core_engine/parameter_store.h"
+#include "../core_engine/real_time_controller.h"
+#include "../core_engine/safety_monitor.h"
+
+// Timing bounds are loose on purpose: these run on shared CI machines
+// without real-time privileges.
+
+TEST(RealTimeControllerTest, AbsoluteDeadlinesHoldTheRate) {
+    RealTimeController controller;
+    controller.setControlFrequency(1000);
+    RealTimeOptions options;
+    options.enabled = true;
+    options.fifo_priority = 80;     // granted or not, the loop must run
+    options.cpu = 0;
+    controller.setRealTimeOptions(options);
+    
+    controller.startControlLoop();
+    EXPECT_TRUE(controller.getRealTimeStatus().absolute_deadlines);
+    EXPECT_TRUE(controller.getRealTimeStatus().stack_prefaulted);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    controller.stopControlLoop();
+    
+    ControlTimingStats stats = controller.getTimingStats();
+    // Releases are on a fixed grid, so cycles plus skipped periods track wall time
+    EXPECT_GE(stats.cycles + stats.missed_periods, 250u);
+    EXPECT_LE(stats.cycles + stats.missed_periods, 310u);
+    EXPECT_GE(stats.max_jitter_ns, 0);
+    EXPECT_LE(stats.overruns, stats.cycles);
+}
+
+TEST(RealTimeControllerTest, LegacyModeReportsStats) {
+    RealTimeController controller;
+    controller.setControlFrequency(500);
+    controller.startControlLoop();
+    EXPECT_FALSE(controller.getRealTimeStatus().absolute_deadlines);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    controller.stopControlLoop();
+    
+    ControlTimingStats stats = controller.getTimingStats();
+    EXPECT_GT(stats.cycles, 10u);
+    EXPECT_EQ(stats.missed_periods, 0u);
+    
+    controller.resetTimingStats();
+    EXPECT_EQ(controller.getTimingStats().cycles, 0u);
+}
+
+namespace {
+
+void busyWait(std::chrono::microseconds duration) {
+    auto end = std::chrono::steady_clock::now() + duration;
+    while(std::chrono::steady_clock::now() < end) {}
+}
+
+} // namespace
+
+TEST(RealTimeControllerTest, InlineRateGroupsRunOnTheirTicks) {
+    RealTimeController controller;
+    controller.setControlFrequency(1000);
+    std::atomic<int> fast_runs{0};
+    std::atomic<int> slow_runs{0};
+    int fast = controller.addRateGroup(RateGroupConfig{"force_checks", 1, 0, 0, 10, false}, [&]() { fast_runs++; });
+    int slow = controller.addRateGroup(RateGroupConfig{"kinematics", 10, 3, 0, 5, false}, [&]() { slow_runs++; });
+    ASSERT_EQ(fast, 0);
+    ASSERT_EQ(slow, 1);
+    EXPECT_EQ(controller.addRateGroup(RateGroupConfig{"bad", 4, 4, 0, 0, false}, []() {}), -1);
+    EXPECT_EQ(controller.addRateGroup(RateGroupConfig{"too_long", 1, 0, 2000000, 0, false}, []() {}), -1);
+    
+    RealTimeOptions options;
+    options.enabled = true;
+    controller.setRealTimeOptions(options);
+    controller.startControlLoop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    controller.stopControlLoop();
+    
+    RateGroupStats fast_stats = controller.getRateGroupStats(fast);
+    RateGroupStats slow_stats = controller.getRateGroupStats(slow);
+    EXPECT_EQ(fast_stats.runs, static_cast<uint64_t>(fast_runs.load()));
+    EXPECT_EQ(fast_stats.runs, controller.getCycleCount());
+    EXPECT_EQ(slow_stats.period_ns, 10000000);
+    // Every tenth executed tick, give or take ticks missed on a busy machine
+    EXPECT_NEAR(static_cast<double>(slow_runs.load()), fast_runs.load() / 10.0, 3.0);
+    EXPECT_EQ(controller.addRateGroup(RateGroupConfig{"late", 1, 0, 0, 0, false}, []() {}), 2);
+}
+
+TEST(RealTimeControllerTest, InlineBudgetKeepsSlowWorkOutOfTheTick) {
+    RealTimeController controller;
+    controller.setControlFrequency(1000);
+    // 600 us of high priority work leaves no room for a 500 us budget
+    int heavy = controller.addRateGroup(RateGroupConfig{"heavy", 1, 0, 0, 10, false},
+                                        []() { busyWait(std::chrono::microseconds(600)); });
+    int analytics = controller.addRateGroup(RateGroupConfig{"analytics", 1, 0, 500000, 1, false},
+                                            []() { busyWait(std::chrono::microseconds(500)); });
+    
+    RealTimeOptions options;
+    options.enabled = true;
+    controller.setRealTimeOptions(options);
+    controller.startControlLoop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    controller.stopControlLoop();
+    
+    EXPECT_GT(controller.getRateGroupStats(heavy).runs, 0u);
+    RateGroupStats stats = controller.getRateGroupStats(analytics);
+    EXPECT_EQ(stats.runs, 0u);
+    EXPECT_EQ(stats.skipped, controller.getCycleCount());
+}
+
+TEST(RealTimeControllerTest, SecondaryGroupOverrunsDoNotStallBaseTick) {
+    RealTimeController controller;
+    controller.setControlFrequency(1000);
+    std::atomic<int> base_runs{0};
+    controller.addRateGroup(RateGroupConfig{"safety", 1, 0, 0, 0, false}, [&]() { base_runs++; });
+    // 10 Hz group that takes 150 ms: overruns and misses releases on its own thread
+    int scoring = controller.addRateGroup(RateGroupConfig{"scoring", 100, 0, 0, 0, true},
+                                          []() { std::this_thread::sleep_for(std::chrono::milliseconds(150)); });
+    
+    RealTimeOptions options;
+    options.enabled = true;
+    controller.setRealTimeOptions(options);
+    controller.startControlLoop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    controller.stopControlLoop();
+    
+    RateGroupStats stats = controller.getRateGroupStats(scoring);
+    EXPECT_GE(stats.runs, 2u);
+    EXPECT_EQ(stats.overruns, stats.runs);
+    EXPECT_GE(stats.skipped, 1u);
+    EXPECT_GE(base_runs.load(), 300);
+    EXPECT_NE(controller.formatMetrics().find("rate_group_skipped_total{group=\"scoring\"}"), std::string::npos);
+}
+
+TEST(RealTimeControllerTest, PipelinedModeCarriesEveryStage) {
+    RealTimeController controller;
+    controller.setControlFrequency(1000);
+    std::atomic<int> reads{0};
+    std::atomic<int> checks{0};
+    std::atomic<int> commands{0};
+    controller.setPhaseHandler(ControlPhase::ReadSensors, [&]() { reads++; });
+    controller.setPhaseHandler(ControlPhase::SafetyChecks, [&]() { checks++; });
+    controller.setPhaseHandler(ControlPhase::SendCommands, [&]() { commands++; });
+    
+    PipelineOptions pipeline;
+    pipeline.mode = PipelineMode::Pipelined;
+    controller.setPipelineOptions(pipeline);
+    RealTimeOptions options;
+    options.enabled = true;
+    controller.setRealTimeOptions(options);
+    controller.startControlLoop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    controller.stopControlLoop();
+    
+    // Stages only ever skip frames that were superseded before they got to them
+    ControlTimingStats stats = controller.getTimingStats();
+    EXPECT_EQ(static_cast<uint64_t>(reads.load()), stats.cycles);
+    EXPECT_GE(checks.load() + 1 + static_cast<int>(stats.pipeline_drops), reads.load());
+    EXPECT_GT(commands.load(), reads.load() / 2);
+    
+    LatencySnapshot end_to_end = controller.getPhaseLatency(ControlPhase::SensorToCommand);
+    EXPECT_EQ(end_to_end.count, static_cast<uint64_t>(commands.load()));
+    EXPECT_EQ(controller.getPhaseLatency(ControlPhase::SafetyChecks).count, static_cast<uint64_t>(checks.load()));
+}
+
+TEST(RealTimeControllerTest, PublishesStateSnapshotEveryCycle) {
+    RealTimeController controller;
+    SurgicalSafetyMonitor monitor;
+    controller.setControlFrequency(1000);
+    controller.attachSafetyMonitor(&monitor);
+    controller.setStateSource([](RobotStateSnapshot& state) {
+        state.joint_count = 6;
+        state.joint_positions[0] = static_cast<double>(state.cycle);
+        state.procedure_phase = ProcedurePhase::Dissection;
+    });
+    EXPECT_EQ(controller.getStateSnapshot().cycle, 0u);
+    
+    controller.startControlLoop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    RobotStateSnapshot running = controller.getStateSnapshot();
+    EXPECT_GT(running.cycle, 0u);
+    EXPECT_DOUBLE_EQ(running.joint_positions[0], static_cast<double>(running.cycle));
+    EXPECT_FALSE(running.emergency_stop);
+    EXPECT_DOUBLE_EQ(running.safety_score, 100.0);
+    
+    monitor.triggerEmergencyStop("snapshot test");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    controller.stopControlLoop();
+    
+    RobotStateSnapshot stopped = controller.getStateSnapshot();
+    EXPECT_GT(stopped.cycle, running.cycle);
+    EXPECT_TRUE(stopped.emergency_stop);
+    EXPECT_EQ(stopped.robot_state, RobotState::EmergencyStop);
+    EXPECT_LT(stopped.safety_score, 100.0);
+    EXPECT_EQ(stopped.procedure_phase, ProcedurePhase::Dissection);
+}
+
+TEST(RealTimeControllerTest, AppliesPublishedParametersNextCycle) {
+    ParameterStore store;
+    RealTimeController controller;
+    ASSERT_TRUE(controller.attachParameterStore(&store));
+    controller.setControlFrequency(1000);
+    controller.setStateSource([&controller](RobotStateSnapshot& state) {
+        const RobotParameters* parameters = controller.getCycleParameters();
+        state.force_count = 1;
+        state.force_readings[0] = parameters->max_force_newtons[0];
+    });
+    
+    controller.startControlLoop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_DOUBLE_EQ(controller.getStateSnapshot().force_readings[0], 15.0);
+    
+    RobotParameters lowered = store.snapshot();
+    std::fill(lowered.max_force_newtons, lowered.max_force_newtons + RobotParameters::MAX_FORCE_CHANNELS, 12.0);
+    store.publish(lowered);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(controller.isRunning());
+    EXPECT_DOUBLE_EQ(controller.getStateSnapshot().force_readings[0], 12.0);
+    // The control thread has passed a quiescent point since
+    store.reclaim();
+    EXPECT_EQ(store.getRetiredCount(), 0u);
+    
+    controller.stopControlLoop();
+}
+
+TEST(TripleBufferTest, ConsumerSeesLatestCompleteValue) {
+    TripleBuffer<uint64_t> buffer;
+    EXPECT_FALSE(buffer.update());
+    
+    buffer.writeBuffer() = 1;
+    EXPECT_TRUE(buffer.publish());
+    buffer.writeBuffer() = 2;
+    EXPECT_FALSE(buffer.publish());     // 1 was never read
+    ASSERT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.readBuffer(), 2u);
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(buffer.readBuffer(), 2u);
+    
+    // Concurrent: values arrive in increasing order and each is whole
+    struct Pair { uint64_t a; uint64_t b; };
+    TripleBuffer<Pair> pairs;
+    std::atomic<bool> done{false};
+    std::thread producer([&]() {
+        for(uint64_t i = 1; i <= 200000; ++i) {
+            pairs.writeBuffer() = Pair{i, ~i};
+            pairs.publish();
+        }
+        done = true;
+    });
+    uint64_t last = 0;
+    for(;;) {
+        bool finished = done.load();
+        if(pairs.update()) {
+            const Pair& value = pairs.readBuffer();
+            ASSERT_EQ(value.b, ~value.a);
+            ASSERT_GT(value.a, last);
+            last = value.a;
+        } else if(finished) {
+            break;
+        }
+    }
+    EXPECT_EQ(last, 200000u);
+    producer.join();
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "../core_engine/safety_event_log.h"
+
+class SafetyEventLogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log = std::make_unique<SafetyEventLog>(1000);
+    }
+
+    std::unique_ptr<SafetyEventLog> log;
+};
+
+TEST_F(SafetyEventLogTest, CapacityRoundsUpToPowerOfTwo) {
+    EXPECT_EQ(log->capacity(), 1024u);
+}
+
+TEST_F(SafetyEventLogTest, SnapshotReturnsMostRecentOldestFirst) {
+    for(int i = 0; i < 10; ++i) {
+        log->append(static_cast<SafetyEventTypeId>(SafetyEventType::ExcessiveForce),
+                    static_cast<double>(i), RobotState::Operational, 3);
+    }
+
+    SafetyEventRecord records[4];
+    ASSERT_EQ(log->snapshot(records, 4), 4u);
+    for(int i = 0; i < 4; ++i) {
+        EXPECT_EQ(records[i].sequence, static_cast<uint64_t>(6 + i));
+        EXPECT_DOUBLE_EQ(records[i].value, 6.0 + i);
+    }
+    EXPECT_LE(records[0].timestamp_ns, records[3].timestamp_ns);
+}
+
+TEST_F(SafetyEventLogTest, OldestRecordsAreOverwritten) {
+    for(int i = 0; i < 3000; ++i) {
+        log->append(0, static_cast<double>(i), RobotState::Operational, 3);
+    }
+
+    std::vector<SafetyEventRecord> records(2000);
+    size_t count = log->snapshot(records.data(), records.size());
+    ASSERT_EQ(count, log->capacity());
+    EXPECT_DOUBLE_EQ(records.front().value, 3000.0 - log->capacity());
+    EXPECT_DOUBLE_EQ(records[count - 1].value, 2999.0);
+}
+
+TEST_F(SafetyEventLogTest, ConcurrentProducersLoseNoEvents) {
+    const int producers = 4;
+    const int events_per_producer = 200;
+    std::vector<std::thread> threads;
+    for(int p = 0; p < producers; ++p) {
+        threads.emplace_back([this, p]() {
+            for(int i = 0; i < events_per_producer; ++i) {
+                log->append(static_cast<SafetyEventTypeId>(p), 1.0, RobotState::Operational, 3);
+            }
+        });
+    }
+    for(auto& thread : threads) thread.join();
+
+    std::vector<SafetyEventRecord> records(log->capacity());
+    EXPECT_EQ(log->snapshot(records.data(), records.size()),
+              static_cast<size_t>(producers * events_per_producer));
+}
+
+TEST(SafetyEventTypeRegistryTest, InternsNamesOnce) {
+    auto& registry = SafetyEventTypeRegistry::instance();
+    EXPECT_EQ(registry.intern("EXCESSIVE_FORCE"),
+              static_cast<SafetyEventTypeId>(SafetyEventType::ExcessiveForce));
+
+    SafetyEventTypeId custom = registry.intern("CUSTOM_EMERGENCY_EVENT");
+    EXPECT_EQ(registry.intern("CUSTOM_EMERGENCY_EVENT"), custom);
+    EXPECT_STREQ(registry.name(custom), "CUSTOM_EMERGENCY_EVENT");
+    EXPECT_EQ(registry.severity(custom), 5);
+}
+
+TEST_F(SafetyEventLogTest, SeverityOfLastEventsMatchesScan) {
+    for(int i = 0; i < 2500; ++i) {
+        log->append(0, 0.0, RobotState::Operational, static_cast<uint8_t>(1 + i % 5));
+    }
+
+    for(size_t window : {0u, 1u, 7u, 100u, 1023u, 5000u}) {
+        std::vector<SafetyEventRecord> records(std::min(window, log->capacity() - 1));
+        size_t count = log->snapshot(records.data(), records.size());
+        uint64_t expected = 0;
+        for(size_t i = 0; i < count; ++i) expected += records[i].severity_level;
+
+        SeverityWindow result = log->severityOfLastEvents(window);
+        EXPECT_EQ(result.severity_sum, expected) << "window " << window;
+        EXPECT_EQ(result.event_count, std::min(window, log->capacity() - 1));
+    }
+}
+
+TEST_F(SafetyEventLogTest, SeveritySinceCountsOnlyNewerEvents) {
+    log->append(0, 0.0, RobotState::Operational, 5);
+    log->append(0, 0.0, RobotState::Operational, 5);
+    uint64_t cutoff = SafetyEventLog::nowNanoseconds();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    log->append(0, 0.0, RobotState::Operational, 3);
+
+    SeverityWindow result = log->severitySince(cutoff);
+    EXPECT_EQ(result.event_count, 1u);
+    EXPECT_EQ(result.severity_sum, 3u);
+    EXPECT_EQ(log->severitySince(0).severity_sum, 13u);
+}
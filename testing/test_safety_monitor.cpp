@@ -47,6 +47,142 @@ TEST_F(SafetyMonitorTest, SafetyScoreCalculation) {
     EXPECT_LT(new_score, initial_score);
 }
 
+TEST_F(SafetyMonitorTest, SafetyScoreWindows) {
+    monitor->logSafetyEvent("EXCESSIVE_FORCE", 20.0);
+    monitor->logSafetyEvent("EXCESSIVE_FORCE", 20.0);
+    
+    EXPECT_DOUBLE_EQ(monitor->calculateSafetyScoreForLastEvents(1), 98.5);
+    EXPECT_DOUBLE_EQ(monitor->calculateSafetyScoreForLastEvents(100), 97.0);
+    EXPECT_DOUBLE_EQ(monitor->calculateSafetyScoreForLastSeconds(60.0), 97.0);
+    EXPECT_DOUBLE_EQ(monitor->calculateOverallSafetyScore(), 97.0);
+}
+
+TEST_F(SafetyMonitorTest, ForceBatchReportsFirstViolation) {
+    // 3 channels x 5 samples, structure-of-arrays
+    std::vector<double> forces = {
+        5.0, 5.0,  5.0, 5.0, 5.0,
+        5.0, 5.0, 16.0, 5.0, 5.0,
+        5.0, 5.0,  5.0, 5.0, 20.0
+    };
+    SampleBlock block{forces.data(), 3, 5, 5};
+    std::vector<uint32_t> masks(block.sample_count);
+    
+    BatchValidationResult result = monitor->validateForceReadingsBatch(block, masks.data());
+    
+    EXPECT_FALSE(result.isValid());
+    EXPECT_EQ(result.violation_count, 2u);
+    EXPECT_EQ(result.first_violation_index, 2u);
+    EXPECT_EQ(masks[2], 0x2u);
+    EXPECT_EQ(masks[4], 0x4u);
+    EXPECT_EQ(masks[0], 0u);
+}
+
+TEST_F(SafetyMonitorTest, JointBatchEngagesEmergencyStop) {
+    std::vector<double> clean(6 * 3, 0.0);
+    std::vector<uint32_t> masks(3);
+    EXPECT_TRUE(monitor->validateJointPositionBatch(SampleBlock{clean.data(), 6, 3, 3}, masks.data()).isValid());
+    EXPECT_FALSE(monitor->isEmergencyStopEngaged());
+    
+    std::vector<double> positions = clean;
+    positions[1 * 3 + 1] = 95.0; // joint 2 exceeds its 90 degree limit in sample 1
+    BatchValidationResult result = monitor->validateJointPositionBatch(SampleBlock{positions.data(), 6, 3, 3},
+                                                                       masks.data());
+    EXPECT_EQ(result.first_violation_index, 1u);
+    EXPECT_EQ(masks[1], 0x2u);
+    EXPECT_TRUE(monitor->isEmergencyStopEngaged());
+}
+
+TEST_F(SafetyMonitorTest, EmptyOrMismatchedBatchIsInvalidInput) {
+    std::vector<double> values(4 * 2, 0.0);
+    std::vector<uint32_t> masks(2, 0u);
+    
+    EXPECT_FALSE(monitor->validateJointPositionBatch(SampleBlock{values.data(), 6, 0, 0}, masks.data()).isValid());
+    EXPECT_FALSE(monitor->validateForceReadingsBatch(SampleBlock{values.data(), 3, 0, 0}, masks.data()).isValid());
+    EXPECT_FALSE(monitor->validateVelocityBatch(SampleBlock{values.data(), 3, 0, 0}, masks.data()).isValid());
+    EXPECT_EQ(masks[0], 0u);
+    
+    // More channels than the limits cover
+    BatchValidationResult forces = monitor->validateForceReadingsBatch(SampleBlock{values.data(), 4, 2, 2}, masks.data());
+    EXPECT_FALSE(forces.isValid());
+    EXPECT_EQ(forces.violation_count, 2u);
+    EXPECT_EQ(masks[1], ~0u);
+    EXPECT_FALSE(monitor->validateVelocityBatch(SampleBlock{values.data(), 4, 2, 2}, masks.data()).isValid());
+    
+    std::vector<SafetyEvent> events = monitor->getRecentSafetyEvents(10);
+    ASSERT_EQ(events.size(), 5u);
+    for(const SafetyEvent& event : events) EXPECT_EQ(event.event_type, "INVALID_JOINT_DATA");
+    EXPECT_FALSE(monitor->isEmergencyStopEngaged());
+}
+
+TEST_F(SafetyMonitorTest, FollowsPublishedParameters) {
+    ParameterStore store;
+    ASSERT_TRUE(monitor->attachParameterStore(store));
+    std::vector<double> forces = {12.0, 5.0, 5.0};
+    EXPECT_TRUE(monitor->validateForceReadings(forces));
+    
+    RobotParameters tighter = store.snapshot();
+    std::fill(tighter.max_force_newtons, tighter.max_force_newtons + RobotParameters::MAX_FORCE_CHANNELS, 11.0);
+    tighter.force_warning_newtons = 8.0;
+    uint64_t version = store.publish(tighter);
+    
+    EXPECT_FALSE(monitor->validateForceReadings(forces));
+    EXPECT_EQ(monitor->getParametersVersion(), version);
+    EXPECT_EQ(monitor->getCurrentLimits(), std::vector<double>(3, 11.0));
+    // The monitor's next check was its quiescent point for the first block
+    store.reclaim();
+    EXPECT_EQ(store.getRetiredCount(), 0u);
+    monitor->detachParameterStore();
+}
+
+TEST_F(SafetyMonitorTest, LockFreeChecksFollowParameterStore) {
+    ParameterStore store;
+    ASSERT_TRUE(monitor->attachParameterStore(store));
+    std::vector<double> velocities = {40.0, 0.0, 0.0};
+    EXPECT_TRUE(monitor->validateVelocity(velocities));
+    
+    RobotParameters slower = store.snapshot();
+    slower.max_velocity_mm_per_sec[0] = 30.0;
+    slower.min_safe_distance_mm = 5.0;
+    store.publish(slower);
+    EXPECT_FALSE(monitor->validateVelocity(velocities));
+    
+    ObstacleCloudSoA obstacles(std::vector<Eigen::Vector3d>{Eigen::Vector3d(4, 0, 0)});
+    EXPECT_TRUE(monitor->checkCollisionRisk(Eigen::Vector3d::Zero(), obstacles));
+    // Neither check keeps a reader slot or a block
+    store.reclaim();
+    monitor->detachParameterStore();
+    EXPECT_EQ(store.getRetiredCount(), 0u);
+}
+
+TEST_F(SafetyMonitorTest, CollisionRiskOverObstacleCloud) {
+    ObstacleCloudSoA obstacles(std::vector<Eigen::Vector3d>{Eigen::Vector3d(10, 0, 0), Eigen::Vector3d(0, 3, 0)});
+    EXPECT_FALSE(monitor->checkCollisionRisk(Eigen::Vector3d::Zero(), obstacles));
+    EXPECT_TRUE(monitor->checkCollisionRisk(Eigen::Vector3d(0, 1.5, 0), obstacles));
+    
+    std::vector<SafetyEvent> events = monitor->getRecentSafetyEvents(1);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].event_type, "COLLISION_IMMINENT");
+    EXPECT_NEAR(events[0].value, 1.5, 1e-6);
+}
+
+TEST_F(SafetyMonitorTest, CollisionRiskMatchesPrebuiltCloud) {
+    std::vector<std::vector<double>> obstacles = {{10, 0, 0}, {0, 3, 0}, {0, 1}};
+    EXPECT_FALSE(monitor->checkCollisionRisk(std::vector<double>{0, 0, 0}, obstacles));
+    EXPECT_TRUE(monitor->checkCollisionRisk(std::vector<double>{0, 1.5, 0}, obstacles));
+    
+    std::vector<SafetyEvent> events = monitor->getRecentSafetyEvents(1);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_NEAR(events[0].value, 1.5, 1e-6);
+    
+    ObstacleCloudSoA cloud;
+    cloud.assign(obstacles);
+    EXPECT_FALSE(monitor->checkCollisionRisk(Eigen::Vector3d(0, 0, 0), cloud));
+    EXPECT_TRUE(monitor->checkCollisionRisk(Eigen::Vector3d(0, 1.5, 0), cloud));
+    
+    // Obstacles are matched to positions of their own size
+    EXPECT_TRUE(monitor->checkCollisionRisk(std::vector<double>{0, 1.5}, obstacles));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
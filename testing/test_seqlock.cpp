@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "../core_engine/seqlock.h"
+#include "../core_engine/robot_state_snapshot.h"
+
+namespace {
+
+// Every field carries the same generation so any mix of two writes shows
+struct Stamped {
+    uint64_t generation;
+    uint64_t fields[23];
+    uint32_t tail;
+};
+
+Stamped makeStamped(uint64_t generation) {
+    Stamped value;
+    value.generation = generation;
+    for(auto& field : value.fields) field = generation * 0x9E3779B97F4A7C15ull;
+    value.tail = static_cast<uint32_t>(generation);
+    return value;
+}
+
+bool isConsistent(const Stamped& value) {
+    for(auto field : value.fields) {
+        if(field != value.generation * 0x9E3779B97F4A7C15ull) return false;
+    }
+    return value.tail == static_cast<uint32_t>(value.generation);
+}
+
+} // namespace
+
+TEST(SeqLockTest, LoadReturnsLastStore) {
+    SeqLock<Stamped> lock;
+    EXPECT_EQ(lock.version(), 0u);
+    EXPECT_EQ(lock.load().generation, 0u);
+    
+    lock.store(makeStamped(7));
+    lock.store(makeStamped(8));
+    Stamped value;
+    ASSERT_TRUE(lock.tryLoad(value));
+    EXPECT_EQ(value.generation, 8u);
+    EXPECT_TRUE(isConsistent(value));
+    EXPECT_EQ(lock.version(), 2u);
+}
+
+TEST(SeqLockTest, ConcurrentReadersNeverSeeTornValues) {
+    constexpr uint64_t WRITES = 300000;
+    constexpr int READERS = 3;
+    SeqLock<Stamped> lock;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> regressions{0};
+    std::atomic<uint64_t> reads{0};
+    
+    std::vector<std::thread> readers;
+    for(int r = 0; r < READERS; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t last = 0;
+            uint64_t local_reads = 0;
+            while(!done.load(std::memory_order_relaxed)) {
+                Stamped value = lock.load();
+                if(!isConsistent(value)) torn.fetch_add(1);
+                if(value.generation < last) regressions.fetch_add(1);
+                last = value.generation;
+                ++local_reads;
+            }
+            reads.fetch_add(local_reads);
+        });
+    }
+    
+    // The writer never waits on readers
+    for(uint64_t generation = 1; generation <= WRITES; ++generation) {
+        lock.store(makeStamped(generation));
+    }
+    done = true;
+    for(auto& reader : readers) reader.join();
+    
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(regressions.load(), 0u);
+    EXPECT_GT(reads.load(), 0u);
+    EXPECT_EQ(lock.load().generation, WRITES);
+    EXPECT_EQ(lock.version(), WRITES);
+}
+
+TEST(SeqLockTest, CarriesRobotStateSnapshot) {
+    SeqLock<RobotStateSnapshot> lock;
+    RobotStateSnapshot state{};
+    state.cycle = 42;
+    state.joint_count = 6;
+    state.joint_positions[5] = 1.25;
+    state.procedure_phase = ProcedurePhase::Suturing;
+    state.emergency_stop = true;
+    lock.store(state);
+    
+    RobotStateSnapshot copy = lock.load();
+    EXPECT_EQ(copy.cycle, 42u);
+    EXPECT_EQ(copy.joint_count, 6);
+    EXPECT_DOUBLE_EQ(copy.joint_positions[5], 1.25);
+    EXPECT_EQ(copy.procedure_phase, ProcedurePhase::Suturing);
+    EXPECT_TRUE(copy.emergency_stop);
+    EXPECT_STREQ(procedurePhaseName(copy.procedure_phase), "SUTURING");
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../core_engine/flight_recorder.h"
+#include "../core_engine/kinematics.h"
+#include "../core_engine/session_replay.h"
+
+namespace {
+
+// A slow sweep with force spikes every 100 cycles and one corrupt sample
+std::vector<RobotStateSnapshot> makeSession(uint64_t samples, uint64_t corrupt_cycle = 0) {
+    std::vector<RobotStateSnapshot> records(samples);
+    for(uint64_t i = 0; i < samples; ++i) {
+        RobotStateSnapshot& record = records[i];
+        record = RobotStateSnapshot{};
+        record.cycle = i + 1;
+        record.timestamp_ns = (i + 1) * 1000000ull;
+        record.joint_count = 6;
+        record.force_count = 3;
+        record.procedure_phase = ProcedurePhase::Dissection;
+        for(int joint = 0; joint < 6; ++joint) {
+            record.joint_positions[joint] = 0.3 * std::sin(0.001 * static_cast<double>(i) + joint);
+            record.joint_velocities[joint] = 0.01;
+        }
+        for(int channel = 0; channel < 3; ++channel) record.force_readings[channel] = 4.0;
+        if(record.cycle % 100 == 0) record.force_readings[1] = 20.0;
+        if(record.cycle == corrupt_cycle) record.joint_positions[2] = std::numeric_limits<double>::quiet_NaN();
+    }
+    return records;
+}
+
+void expectSameResult(const SessionReplayResult& a, const SessionReplayResult& b) {
+    EXPECT_EQ(a.session_id, b.session_id);
+    EXPECT_EQ(a.samples, b.samples);
+    EXPECT_EQ(a.joint_limit_violations, b.joint_limit_violations);
+    EXPECT_EQ(a.invalid_joint_data, b.invalid_joint_data);
+    EXPECT_EQ(a.force_violations, b.force_violations);
+    EXPECT_EQ(a.velocity_violations, b.velocity_violations);
+    EXPECT_EQ(a.kinematics_failures, b.kinematics_failures);
+    EXPECT_EQ(a.collision_warnings, b.collision_warnings);
+    EXPECT_EQ(a.collisions, b.collisions);
+    EXPECT_EQ(a.self_collisions, b.self_collisions);
+    EXPECT_EQ(a.emergency_stops, b.emergency_stops);
+    EXPECT_EQ(a.first_violation_cycle, b.first_violation_cycle);
+    EXPECT_EQ(a.min_obstacle_distance, b.min_obstacle_distance);
+    EXPECT_EQ(a.final_safety_score, b.final_safety_score);
+}
+
+ReplayOptions geometryOff() {
+    ReplayOptions options;
+    options.check_self_collision = false;
+    return options;
+}
+
+} // namespace
+
+TEST(SessionReplayTest, CountsViolationsPerSample) {
+    std::vector<RobotStateSnapshot> records = makeSession(1000, 250);
+    SessionReplayer replayer(geometryOff(), 7);
+    replayer.process(records.data(), records.size());
+    SessionReplayResult result = replayer.finish();
+    
+    EXPECT_EQ(result.session_id, 7u);
+    EXPECT_TRUE(result.complete);
+    EXPECT_EQ(result.samples, 1000u);
+    EXPECT_EQ(result.force_violations, 10u);
+    EXPECT_EQ(result.velocity_violations, 0u);
+    EXPECT_EQ(result.kinematics_failures, 1u);
+    EXPECT_EQ(result.joint_limit_violations, 1u);
+    EXPECT_EQ(result.invalid_joint_data, 0u);
+    EXPECT_EQ(result.first_violation_cycle, 100u);
+    EXPECT_EQ(result.collisions, 0u);
+    EXPECT_LT(result.final_safety_score, 100.0);
+}
+
+TEST(SessionReplayTest, ResultDoesNotDependOnHowSamplesArrive) {
+    std::vector<RobotStateSnapshot> records = makeSession(2000, 1234);
+    ReplayOptions options;
+    options.block_samples = 64;
+    
+    SessionReplayer whole(options);
+    whole.process(records.data(), records.size());
+    SessionReplayResult expected = whole.finish();
+    // Same geometry as the live check: the arm's coincident frame origins
+    // are not a self-collision
+    EXPECT_EQ(expected.self_collisions, 0u);
+    
+    SessionReplayer pieces(options);
+    for(size_t begin = 0; begin < records.size(); begin += 7) {
+        pieces.process(records.data() + begin, std::min<size_t>(7, records.size() - begin));
+    }
+    expectSameResult(pieces.finish(), expected);
+}
+
+TEST(SessionReplayTest, FlagsInstrumentNearObstacle) {
+    Kinematics<6, double> kinematics(ETHICON_ARM_DH_PARAMETERS);
+    std::vector<RobotStateSnapshot> records = makeSession(10);
+    Kinematics<6, double>::JointVector angles;
+    std::copy(records[4].joint_positions, records[4].joint_positions + 6, angles.begin());
+    Eigen::Vector3d tip = Eigen::Vector3d::Zero();
+    ASSERT_EQ(kinematics.forwardKinematics(angles, tip), KinematicsStatus::Ok);
+    
+    ReplayOptions options = geometryOff();
+    options.obstacles = {tip * 1000.0 + Eigen::Vector3d(0.0, 0.0, 0.5)};    // detector works in mm
+    SessionReplayer replayer(options);
+    replayer.process(records.data(), records.size());
+    SessionReplayResult result = replayer.finish();
+    
+    // Neighbouring samples pass the obstacle about as closely
+    EXPECT_GE(result.collisions, 1u);
+    EXPECT_LE(result.min_obstacle_distance, 0.5 + 1e-3);
+    EXPECT_GT(result.collision_warnings + result.collisions, 1u);
+}
+
+TEST(SessionReplayTest, ParallelReplayMatchesSerial) {
+    std::string pattern = ::testing::TempDir() + "session_replay_XXXXXX";
+    ASSERT_NE(mkdtemp(&pattern[0]), nullptr);
+    const std::string directory = pattern;
+    
+    FlightRecorderOptions recorder_options;
+    recorder_options.directory = directory;
+    recorder_options.records_per_chunk = 512;
+    recorder_options.flush_interval = std::chrono::milliseconds(1);
+    const uint64_t lengths[] = {1500, 700, 2100};
+    for(uint64_t length : lengths) {
+        FlightRecorder recorder(recorder_options);
+        ASSERT_TRUE(recorder.open());
+        std::vector<RobotStateSnapshot> records = makeSession(length, length / 2);
+        for(size_t i = 0; i < records.size(); ++i) {
+            ASSERT_TRUE(recorder.append(records[i]));
+            if(i % 128 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        recorder.close();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));    // distinct session ids
+    }
+    
+    std::vector<ReplaySession> sessions = findReplaySessions(directory);
+    ASSERT_EQ(sessions.size(), 3u);
+    for(size_t i = 0; i < sessions.size(); ++i) EXPECT_EQ(sessions[i].record_count, lengths[i]);
+    
+    ReplayOptions serial;
+    serial.thread_count = 1;
+    ReplayReport expected = replaySessions(sessions, serial);
+    ReplayOptions parallel;
+    parallel.thread_count = 3;
+    ReplayReport report = replaySessions(sessions, parallel);
+    
+    EXPECT_EQ(report.threads, 3u);
+    EXPECT_EQ(report.total_samples, 1500u + 700u + 2100u);
+    ASSERT_EQ(report.sessions.size(), 3u);
+    for(size_t i = 0; i < sessions.size(); ++i) {
+        EXPECT_EQ(report.sessions[i].session_id, sessions[i].session_id);
+        EXPECT_EQ(report.sessions[i].force_violations, lengths[i] / 100);
+        expectSameResult(report.sessions[i], expected.sessions[i]);
+    }
+    EXPECT_GT(report.samplesPerSecond(), 0.0);
+    
+    std::string text = formatReplayReport(report);
+    EXPECT_NE(text.find(std::to_string(sessions[2].session_id)), std::string::npos);
+    EXPECT_NE(text.find("samples/s"), std::string::npos);
+    
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include "../dds_integration/data_publisher.h"
+#include "../dds_integration/data_subscriber.h"
+
+namespace {
+
+std::string topicName(const char* test) {
+    return "/srs_test_" + std::string(test) + "_" + std::to_string(getpid());
+}
+
+void publishSequence(RoboticsDataPublisher& publisher, int first, int count) {
+    for(int i = first; i < first + count; ++i) {
+        RoboticsDataSample& sample = publisher.loanSample();
+        sample.timestamp = i;
+        sample.joint_count = 6;
+        sample.joint_positions[0] = i * 0.5;
+        publisher.publishLoanedSample();
+    }
+}
+
+} // namespace
+
+TEST(ShmTransportTest, LoanedSamplesReachEveryReader) {
+    std::string name = topicName("readers");
+    RoboticsDataPublisher publisher;
+    ASSERT_TRUE(publisher.enableSharedMemoryTransport({name, 64}));
+    
+    RoboticsDataSubscriber first, second;
+    ASSERT_TRUE(first.connect(name, 0));
+    ASSERT_TRUE(second.connect(name, 0));
+    publishSequence(publisher, 0, 10);
+    
+    for(RoboticsDataSubscriber* subscriber : {&first, &second}) {
+        RoboticsDataSample sample;
+        for(int i = 0; i < 10; ++i) {
+            ASSERT_TRUE(subscriber->takeSample(sample));
+            EXPECT_EQ(sample.timestamp, i);
+            EXPECT_DOUBLE_EQ(sample.joint_positions[0], i * 0.5);
+            EXPECT_GT(sample.source_timestamp_ns, 0u);
+        }
+        EXPECT_FALSE(subscriber->takeSample(sample));
+        EXPECT_EQ(subscriber->getLostSampleCount(), 0u);
+    }
+}
+
+TEST(ShmTransportTest, LateJoinerReplaysKeptHistory) {
+    std::string name = topicName("late");
+    RoboticsDataPublisher publisher;
+    ASSERT_TRUE(publisher.enableSharedMemoryTransport({name, 16}));
+    publishSequence(publisher, 0, 40);
+    
+    RoboticsDataSubscriber recent, everything;
+    ASSERT_TRUE(recent.connect(name, 10));
+    ASSERT_TRUE(everything.connect(name, 1000));
+    
+    RoboticsDataSample sample;
+    ASSERT_TRUE(recent.takeSample(sample));
+    EXPECT_EQ(sample.timestamp, 30);
+    // Only the ring depth is kept
+    ASSERT_TRUE(everything.takeSample(sample));
+    EXPECT_EQ(sample.timestamp, 24);
+}
+
+TEST(ShmTransportTest, SlowReaderSkipsOverwrittenSamples) {
+    std::string name = topicName("slow");
+    RoboticsDataPublisher publisher;
+    ASSERT_TRUE(publisher.enableSharedMemoryTransport({name, 16}));
+    RoboticsDataSubscriber subscriber;
+    ASSERT_TRUE(subscriber.connect(name, 0));
+    publishSequence(publisher, 0, 50);
+    
+    RoboticsDataSample sample;
+    ASSERT_TRUE(subscriber.takeSample(sample));
+    EXPECT_EQ(sample.timestamp, 34);
+    EXPECT_EQ(subscriber.getLostSampleCount(), 34u);
+}
+
+TEST(ShmTransportTest, ConvertsRoboticsData) {
+    std::string name = topicName("convert");
+    RoboticsDataPublisher publisher;
+    ASSERT_TRUE(publisher.enableSharedMemoryTransport({name, 8}));
+    RoboticsDataSubscriber subscriber;
+    ASSERT_TRUE(subscriber.connect(name, 0));
+    
+    RoboticsData data;
+    data.timestamp = 1234;
+    data.joint_positions = {0.1, 0.2, 0.3};
+    data.joint_velocities = {1.0, 2.0, 3.0};
+    data.force_readings = {4.5};
+    data.safety_status = "CRITICAL";
+    data.collision_risk = 0.75;
+    data.emergency_stop_engaged = true;
+    data.procedure_phase = "SUTURING";
+    data.procedure_duration = 12.5;
+    publisher.publishRoboticsData(data);
+    
+    RoboticsData received;
+    ASSERT_TRUE(subscriber.takeData(received));
+    EXPECT_EQ(received.timestamp, 1234);
+    EXPECT_EQ(received.joint_positions, data.joint_positions);
+    EXPECT_EQ(received.joint_velocities, data.joint_velocities);
+    EXPECT_EQ(received.force_readings, data.force_readings);
+    EXPECT_EQ(received.safety_status, "CRITICAL");
+    EXPECT_DOUBLE_EQ(received.collision_risk, 0.75);
+    EXPECT_TRUE(received.emergency_stop_engaged);
+    EXPECT_EQ(received.procedure_phase, "SUTURING");
+    EXPECT_DOUBLE_EQ(received.procedure_duration, 12.5);
+}
+
+TEST(ShmTransportTest, DeliversAcrossProcesses) {
+    constexpr int SAMPLES = 200;
+    std::string name = topicName("fork");
+    RoboticsDataPublisher publisher;
+    ASSERT_TRUE(publisher.enableSharedMemoryTransport({name, 1000}));
+    
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if(child == 0) {
+        // Raw reader only: the child must not touch the forked logger
+        ShmReader<RoboticsDataSample> reader;
+        if(!reader.open(name, 1000)) _exit(2);
+        RoboticsDataSample sample;
+        for(int expected = 0; expected < SAMPLES; ++expected) {
+            while(!reader.take(sample)) {
+                if(!reader.waitForSample(std::chrono::seconds(5))) _exit(3);
+            }
+            if(sample.timestamp != expected) _exit(4);
+        }
+        _exit(reader.getLostCount() == 0 ? 0 : 5);
+    }
+    
+    for(int i = 0; i < SAMPLES; ++i) {
+        publishSequence(publisher, i, 1);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST(ShmTransportTest, ConnectFailsWithoutPublisher) {
+    RoboticsDataSubscriber subscriber;
+    EXPECT_FALSE(subscriber.connect(topicName("missing")));
+    EXPECT_FALSE(subscriber.isConnected());
+}
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "../dds_integration/wire_format.h"
+
+namespace {
+
+RoboticsDataSample makeSample() {
+    RoboticsDataSample sample{};
+    sample.timestamp = 0x0102030405060708LL;
+    sample.source_timestamp_ns = 987654321;
+    sample.joint_count = 6;
+    sample.force_count = 3;
+    sample.safety_status = SafetyStatus::Critical;
+    sample.procedure_phase = ProcedurePhase::Suturing;
+    sample.emergency_stop_engaged = true;
+    for(int i = 0; i < 6; ++i) {
+        sample.joint_positions[i] = 0.1 * i - 0.25;
+        sample.joint_velocities[i] = -1.5 * i;
+    }
+    sample.force_readings[0] = 4.25;
+    sample.force_readings[2] = -0.0;
+    sample.collision_risk = 0.3;
+    sample.procedure_duration = 1234.5;
+    return sample;
+}
+
+} // namespace
+
+TEST(WireFormatTest, RoboticsDataRoundTrip) {
+    RoboticsDataSample sample = makeSample();
+    uint8_t buffer[512];
+    size_t written = 0;
+    ASSERT_EQ(encodeRoboticsData(sample, buffer, sizeof(buffer), written), WireStatus::Ok);
+    EXPECT_EQ(written, encodedSize(WireMessageType::RoboticsData));
+    
+    RoboticsDataSample decoded{};
+    ASSERT_EQ(decodeRoboticsData(buffer, written, decoded), WireStatus::Ok);
+    EXPECT_EQ(decoded.timestamp, sample.timestamp);
+    EXPECT_EQ(decoded.source_timestamp_ns, sample.source_timestamp_ns);
+    EXPECT_EQ(decoded.joint_count, 6);
+    EXPECT_EQ(decoded.force_count, 3);
+    EXPECT_EQ(decoded.safety_status, SafetyStatus::Critical);
+    EXPECT_EQ(decoded.procedure_phase, ProcedurePhase::Suturing);
+    EXPECT_TRUE(decoded.emergency_stop_engaged);
+    for(int i = 0; i < 6; ++i) {
+        EXPECT_EQ(decoded.joint_positions[i], sample.joint_positions[i]);
+        EXPECT_EQ(decoded.joint_velocities[i], sample.joint_velocities[i]);
+    }
+    EXPECT_EQ(decoded.force_readings[0], 4.25);
+    EXPECT_TRUE(std::signbit(decoded.force_readings[2]));
+    EXPECT_EQ(decoded.collision_risk, 0.3);
+    EXPECT_EQ(decoded.procedure_duration, 1234.5);
+}
+
+TEST(WireFormatTest, LayoutIsLittleEndian) {
+    RoboticsDataSample sample = makeSample();
+    uint8_t buffer[512];
+    size_t written = 0;
+    ASSERT_EQ(encodeRoboticsData(sample, buffer, sizeof(buffer), written), WireStatus::Ok);
+    
+    const uint8_t header[] = {0x53, 0x52, WIRE_SCHEMA_VERSION, 1};
+    EXPECT_EQ(std::memcmp(buffer, header, sizeof(header)), 0);
+    EXPECT_EQ(buffer[4] | (buffer[5] << 8), static_cast<int>(written - WIRE_HEADER_SIZE));
+    const uint8_t timestamp[] = {0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01};
+    EXPECT_EQ(std::memcmp(buffer + WIRE_HEADER_SIZE, timestamp, sizeof(timestamp)), 0);
+    // Enum codes follow the two timestamps and the channel counts
+    EXPECT_EQ(buffer[WIRE_HEADER_SIZE + 18], static_cast<uint8_t>(SafetyStatus::Critical));
+    EXPECT_EQ(buffer[WIRE_HEADER_SIZE + 19], static_cast<uint8_t>(ProcedurePhase::Suturing));
+}
+
+TEST(WireFormatTest, SafetyMetricsRoundTripThroughStrings) {
+    SafetyMetrics metrics;
+    metrics.joint_positions = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6};
+    metrics.joint_velocities = {1, 2, 3, 4, 5, 6};
+    metrics.force_readings = {1.5, 2.5};
+    metrics.safety_status = "WARNING";
+    metrics.collision_risk = 0.42;
+    metrics.emergency_stop = false;
+    metrics.procedure_phase = "DISSECTION";
+    metrics.procedure_duration = 60.0;
+    metrics.safety_score = 97.5;
+    
+    SafetyMetricsFrame frame;
+    toFrame(metrics, frame);
+    uint8_t buffer[512];
+    size_t written = 0;
+    ASSERT_EQ(encodeSafetyMetrics(frame, buffer, sizeof(buffer), written), WireStatus::Ok);
+    SafetyMetricsFrame decoded;
+    ASSERT_EQ(decodeSafetyMetrics(buffer, written, decoded), WireStatus::Ok);
+    SafetyMetrics restored = fromFrame(decoded);
+    
+    EXPECT_EQ(restored.joint_positions, metrics.joint_positions);
+    EXPECT_EQ(restored.joint_velocities, metrics.joint_velocities);
+    EXPECT_EQ(restored.force_readings, metrics.force_readings);
+    EXPECT_EQ(restored.safety_status, "WARNING");
+    EXPECT_EQ(restored.procedure_phase, "DISSECTION");
+    EXPECT_DOUBLE_EQ(restored.collision_risk, 0.42);
+    EXPECT_DOUBLE_EQ(restored.safety_score, 97.5);
+}
+
+TEST(WireFormatTest, SampleAndFrameShareMetricsConversion) {
+    SafetyMetrics metrics;
+    metrics.joint_positions = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9};  // one more than fits
+    metrics.joint_velocities = {1, 2};
+    metrics.force_readings = {1.5};
+    metrics.safety_status = "UNHEARD_OF";
+    metrics.collision_risk = 0.1;
+    metrics.emergency_stop = true;
+    metrics.procedure_phase = "";
+    metrics.procedure_duration = 5.0;
+    metrics.safety_score = 80.0;
+    
+    SafetyMetricsFrame frame;
+    toFrame(metrics, frame);
+    RoboticsDataSample sample{};
+    toSample(metrics, sample);
+    
+    EXPECT_EQ(frame.joint_count, SafetyMetricsFrame::MAX_JOINTS);
+    EXPECT_EQ(sample.joint_count, frame.joint_count);
+    EXPECT_EQ(sample.force_count, 1u);
+    EXPECT_EQ(frame.force_count, 1u);
+    EXPECT_DOUBLE_EQ(sample.joint_velocities[1], 2.0);
+    EXPECT_DOUBLE_EQ(sample.joint_velocities[2], 0.0);
+    EXPECT_EQ(sample.safety_status, SafetyStatus::Warning);
+    EXPECT_EQ(frame.safety_status, SafetyStatus::Warning);
+    EXPECT_EQ(sample.procedure_phase, ProcedurePhase::Initialization);
+    EXPECT_EQ(frame.procedure_phase, ProcedurePhase::Initialization);
+    EXPECT_TRUE(sample.emergency_stop_engaged);
+}
+
+TEST(WireFormatTest, AlertAndCommandRoundTrip) {
+    SafetyAlert alert{"ALERT-7", 1700000000000L, "CRITICAL", "Force limit exceeded on joint 3",
+                      "SafetyMonitor", "Reduce grip force"};
+    SafetyAlertFrame alert_frame;
+    toFrame(alert, alert_frame);
+    uint8_t buffer[512];
+    size_t written = 0;
+    ASSERT_EQ(encodeSafetyAlert(alert_frame, buffer, sizeof(buffer), written), WireStatus::Ok);
+    SafetyAlertFrame decoded_alert;
+    ASSERT_EQ(decodeSafetyAlert(buffer, written, decoded_alert), WireStatus::Ok);
+    SafetyAlert restored_alert = fromFrame(decoded_alert);
+    EXPECT_EQ(restored_alert.alert_id, alert.alert_id);
+    EXPECT_EQ(restored_alert.timestamp, alert.timestamp);
+    EXPECT_EQ(restored_alert.severity, "CRITICAL");
+    EXPECT_EQ(restored_alert.message, alert.message);
+    EXPECT_EQ(restored_alert.component, alert.component);
+    EXPECT_EQ(restored_alert.recommended_action, alert.recommended_action);
+    
+    EmergencyCommand command{1700000000123L, "EMERGENCY_STOP", std::string(300, 'x'), "EMERGENCY", true};
+    EmergencyCommandFrame command_frame;
+    toFrame(command, command_frame);
+    ASSERT_EQ(encodeEmergencyCommand(command_frame, buffer, sizeof(buffer), written), WireStatus::Ok);
+    EmergencyCommandFrame decoded_command;
+    ASSERT_EQ(decodeEmergencyCommand(buffer, written, decoded_command), WireStatus::Ok);
+    EmergencyCommand restored_command = fromFrame(decoded_command);
+    EXPECT_EQ(restored_command.command_type, "EMERGENCY_STOP");
+    EXPECT_EQ(restored_command.severity, "EMERGENCY");
+    EXPECT_TRUE(restored_command.requires_acknowledgment);
+    // Text longer than the field is truncated
+    EXPECT_EQ(restored_command.reason, std::string(sizeof(EmergencyCommandFrame::reason) - 1, 'x'));
+}
+
+TEST(WireFormatTest, RejectsMalformedInput) {
+    RoboticsDataSample sample = makeSample();
+    uint8_t buffer[512];
+    size_t written = 0;
+    EXPECT_EQ(encodeRoboticsData(sample, buffer, 16, written), WireStatus::BufferTooSmall);
+    EXPECT_EQ(written, 0u);
+    ASSERT_EQ(encodeRoboticsData(sample, buffer, sizeof(buffer), written), WireStatus::Ok);
+    
+    RoboticsDataSample decoded{};
+    EXPECT_EQ(decodeRoboticsData(buffer, written - 1, decoded), WireStatus::Truncated);
+    SafetyMetricsFrame metrics;
+    EXPECT_EQ(decodeSafetyMetrics(buffer, written, metrics), WireStatus::WrongType);
+    
+    std::vector<uint8_t> corrupt(buffer, buffer + written);
+    corrupt[0] ^= 0xff;
+    EXPECT_EQ(decodeRoboticsData(corrupt.data(), corrupt.size(), decoded), WireStatus::BadMagic);
+    corrupt.assign(buffer, buffer + written);
+    corrupt[2] = WIRE_SCHEMA_VERSION + 1;
+    EXPECT_EQ(decodeRoboticsData(corrupt.data(), corrupt.size(), decoded), WireStatus::UnsupportedVersion);
+    corrupt.assign(buffer, buffer + written);
+    corrupt[WIRE_HEADER_SIZE + 18] = 200;       // safety status code
+    EXPECT_EQ(decodeRoboticsData(corrupt.data(), corrupt.size(), decoded), WireStatus::InvalidValue);
+    EXPECT_EQ(decoded.timestamp, 0);            // untouched on failure
+    
+    sample.joint_count = RoboticsDataSample::MAX_JOINTS + 1;
+    EXPECT_EQ(encodeRoboticsData(sample, buffer, sizeof(buffer), written), WireStatus::InvalidValue);
+}
+
+TEST(WireFormatTest, SkipsFieldsAppendedByLaterSchemas) {
+    RoboticsDataSample sample = makeSample();
+    std::vector<uint8_t> buffer(encodedSize(WireMessageType::RoboticsData) + 16, 0xAB);
+    size_t written = 0;
+    ASSERT_EQ(encodeRoboticsData(sample, buffer.data(), buffer.size(), written), WireStatus::Ok);
+    uint16_t extended = static_cast<uint16_t>(written - WIRE_HEADER_SIZE + 16);
+    buffer[4] = static_cast<uint8_t>(extended);
+    buffer[5] = static_cast<uint8_t>(extended >> 8);
+    
+    WireHeader header;
+    ASSERT_EQ(decodeWireHeader(buffer.data(), buffer.size(), header), WireStatus::Ok);
+    EXPECT_EQ(header.body_size, extended);
+    RoboticsDataSample decoded{};
+    ASSERT_EQ(decodeRoboticsData(buffer.data(), buffer.size(), decoded), WireStatus::Ok);
+    EXPECT_EQ(decoded.procedure_duration, sample.procedure_duration);
+}